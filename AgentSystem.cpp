@@ -0,0 +1,294 @@
+#include "AgentSystem.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+	// 1 tick あたりの値（固定 60Hz）
+	constexpr float kGravity = 0.04f;
+	constexpr float kMaxFallSpeed = 0.6f; // タイルを飛び越えないようにタイルの大きさより小さく
+	constexpr float kPatrolSpeed = 0.08f;
+	constexpr float kChaserSpeed = 0.1f;
+	constexpr float kChaserRange = 20.0f;
+	constexpr float kFallingTriggerWidth = 1.5f;
+	// マップの下に落ちたら消す（プレイヤーと同じ）
+	constexpr float kFallOutY = -20.0f;
+	// ブロードフェーズのセルの大きさ（タイル 2 つ分）
+	constexpr float kCellSize = 4.0f;
+
+	// 1 体あたりのタイル判定：進む先の壁、進む先の床、足元
+	constexpr uint32_t kProbeCount = 3;
+	constexpr uint32_t kProbeWall = 0;
+	constexpr uint32_t kProbeGroundAhead = 1;
+	constexpr uint32_t kProbeGround = 2;
+
+	enum FallingState : uint8_t {
+		kFallingIdle,
+		kFallingDropping,
+		kFallingLanded,
+	};
+
+	// ワールド座標 -> タイル番号（マップの外は UINT32_MAX、IsBlockAtIndices ではブロック無し扱い）
+	uint32_t ToTileX(float x) {
+		float index = std::floor(x / MapChipField::kBlockWidth);
+		return index >= 0.0f ? static_cast<uint32_t>(index) : UINT32_MAX;
+	}
+	uint32_t ToTileY(float y, uint32_t numBlockVertical) {
+		float row = std::floor(y / MapChipField::kBlockHeight);
+		if (row < 0.0f || row >= static_cast<float>(numBlockVertical)) {
+			return UINT32_MAX;
+		}
+		return numBlockVertical - 1 - static_cast<uint32_t>(row);
+	}
+}
+
+void AgentSystem::Clear() {
+	positionX_.clear();
+	positionY_.clear();
+	velocityX_.clear();
+	velocityY_.clear();
+	spawnX_.clear();
+	spawnY_.clear();
+	direction_.clear();
+	kind_.clear();
+	state_.clear();
+	isGrounded_.clear();
+	isActive_.clear();
+	cellCountX_ = 0;
+	cellCountY_ = 0;
+	cellStart_.clear();
+	cellAgents_.clear();
+	agentCells_.clear();
+}
+
+void AgentSystem::Reserve(size_t count) {
+	positionX_.reserve(count);
+	positionY_.reserve(count);
+	velocityX_.reserve(count);
+	velocityY_.reserve(count);
+	spawnX_.reserve(count);
+	spawnY_.reserve(count);
+	direction_.reserve(count);
+	kind_.reserve(count);
+	state_.reserve(count);
+	isGrounded_.reserve(count);
+	isActive_.reserve(count);
+}
+
+void AgentSystem::Spawn(AgentKind kind, const Vector3& position) {
+	positionX_.push_back(position.x);
+	positionY_.push_back(position.y);
+	velocityX_.push_back(0.0f);
+	velocityY_.push_back(0.0f);
+	spawnX_.push_back(position.x);
+	spawnY_.push_back(position.y);
+	direction_.push_back(1);
+	kind_.push_back(static_cast<uint8_t>(kind));
+	state_.push_back(kFallingIdle);
+	isGrounded_.push_back(0);
+	isActive_.push_back(1);
+}
+
+void AgentSystem::Reset() {
+	for (size_t i = 0; i < positionX_.size(); ++i) {
+		positionX_[i] = spawnX_[i];
+		positionY_[i] = spawnY_[i];
+		velocityX_[i] = 0.0f;
+		velocityY_[i] = 0.0f;
+		direction_[i] = 1;
+		state_[i] = kFallingIdle;
+		isGrounded_[i] = 0;
+		isActive_[i] = 1;
+	}
+}
+
+void AgentSystem::Update(const MapChipField& map, const Vector3& playerPosition) {
+	PROFILE_FUNCTION();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	const size_t count = positionX_.size();
+	const uint32_t numBlockVertical = map.GetNumBlockVertical();
+	if (probeX_.size() != count * kProbeCount) {
+		probeX_.resize(count * kProbeCount);
+		probeY_.resize(count * kProbeCount);
+		probeHits_.resize(count * kProbeCount);
+	}
+
+	// 1. 種類ごとに速度を決め、調べるタイルを集める
+	for (size_t i = 0; i < count; ++i) {
+		float velocityX = 0.0f;
+		bool hasGravity = true;
+		switch (static_cast<AgentKind>(kind_[i])) {
+		case AgentKind::kPatrol:
+			velocityX = kPatrolSpeed * direction_[i];
+			break;
+		case AgentKind::kFalling:
+			if (state_[i] == kFallingIdle) {
+				// プレイヤーが真下に来たら落ち始める
+				bool isBelow = playerPosition.y < positionY_[i] && std::fabs(playerPosition.x - positionX_[i]) < kFallingTriggerWidth;
+				state_[i] = isBelow ? kFallingDropping : kFallingIdle;
+			}
+			hasGravity = state_[i] == kFallingDropping;
+			break;
+		case AgentKind::kChaser: {
+			float deltaX = playerPosition.x - positionX_[i];
+			bool isInRange = std::fabs(deltaX) < kChaserRange && std::fabs(playerPosition.y - positionY_[i]) < kChaserRange;
+			velocityX = isInRange && std::fabs(deltaX) > kChaserSpeed ? std::copysign(kChaserSpeed, deltaX) : 0.0f;
+			break;
+		}
+		}
+		velocityX_[i] = velocityX;
+		velocityY_[i] = hasGravity ? std::max(velocityY_[i] - kGravity, -kMaxFallSpeed) : 0.0f;
+
+		float side = velocityX >= 0.0f ? kHalfSize : -kHalfSize;
+		float nextX = positionX_[i] + velocityX;
+		uint32_t* probeX = &probeX_[i * kProbeCount];
+		uint32_t* probeY = &probeY_[i * kProbeCount];
+		probeX[kProbeWall] = ToTileX(nextX + side);
+		probeY[kProbeWall] = ToTileY(positionY_[i], numBlockVertical);
+		probeX[kProbeGroundAhead] = ToTileX(nextX + side);
+		probeY[kProbeGroundAhead] = ToTileY(positionY_[i] - kHalfSize - 0.1f, numBlockVertical);
+		probeX[kProbeGround] = ToTileX(positionX_[i]);
+		probeY[kProbeGround] = ToTileY(positionY_[i] + velocityY_[i] - kHalfSize, numBlockVertical);
+	}
+
+	// 2. 全員分をまとめて引く
+	map.IsBlockAtIndices(probeX_.data(), probeY_.data(), probeHits_.data(), probeHits_.size());
+
+	// 3. 結果を反映する
+	for (size_t i = 0; i < count; ++i) {
+		if (!isActive_[i]) {
+			continue;
+		}
+		const uint8_t* hits = &probeHits_[i * kProbeCount];
+		AgentKind kind = static_cast<AgentKind>(kind_[i]);
+
+		bool isBlocked = hits[kProbeWall] != 0;
+		// 往復する敵は床の端でも折り返す
+		bool isAtEdge = kind == AgentKind::kPatrol && isGrounded_[i] && hits[kProbeGroundAhead] == 0;
+		if (isBlocked || isAtEdge) {
+			direction_[i] = static_cast<int8_t>(-direction_[i]);
+		} else {
+			positionX_[i] += velocityX_[i];
+		}
+
+		if (velocityY_[i] < 0.0f && hits[kProbeGround]) {
+			// 足元のタイルの上面に乗せる
+			uint32_t row = numBlockVertical - probeY_[i * kProbeCount + kProbeGround];
+			positionY_[i] = static_cast<float>(row) * MapChipField::kBlockHeight + kHalfSize;
+			velocityY_[i] = 0.0f;
+			isGrounded_[i] = 1;
+			if (kind == AgentKind::kFalling) {
+				state_[i] = kFallingLanded;
+			}
+		} else {
+			positionY_[i] += velocityY_[i];
+			isGrounded_[i] = velocityY_[i] == 0.0f && hits[kProbeGround] ? 1 : 0;
+		}
+
+		if (positionY_[i] < kFallOutY) {
+			isActive_[i] = 0;
+		}
+	}
+
+	BuildBroadphase(map);
+
+	std::chrono::duration<float, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+	lastUpdateMicroseconds_ = elapsed.count();
+}
+
+void AgentSystem::BuildBroadphase(const MapChipField& map) {
+	PROFILE_FUNCTION();
+	// マップより外の敵は端のセルに入れる
+	uint32_t cellCountX = static_cast<uint32_t>(std::ceil(static_cast<float>(map.GetNumBlockHorizontal()) * MapChipField::kBlockWidth / kCellSize)) + 1;
+	uint32_t cellCountY = static_cast<uint32_t>(std::ceil(static_cast<float>(map.GetNumBlockVertical()) * MapChipField::kBlockHeight / kCellSize)) + 1;
+	if (cellCountX != cellCountX_ || cellCountY != cellCountY_) {
+		cellCountX_ = cellCountX;
+		cellCountY_ = cellCountY;
+		cellStart_.resize(static_cast<size_t>(cellCountX_) * cellCountY_ + 1);
+	}
+	const size_t count = positionX_.size();
+	agentCells_.resize(count);
+	cellAgents_.resize(count);
+
+	// 数えてから並べる（計数ソート）
+	std::fill(cellStart_.begin(), cellStart_.end(), 0u);
+	const uint32_t noCell = static_cast<uint32_t>(cellStart_.size() - 1);
+	for (size_t i = 0; i < count; ++i) {
+		if (!isActive_[i]) {
+			agentCells_[i] = noCell;
+			continue;
+		}
+		CellRange range = GetCellRange(positionX_[i], positionY_[i], positionX_[i], positionY_[i]);
+		agentCells_[i] = range.yBegin * cellCountX_ + range.xBegin;
+		cellStart_[agentCells_[i] + 1]++;
+	}
+	for (size_t c = 1; c < cellStart_.size(); ++c) {
+		cellStart_[c] += cellStart_[c - 1];
+	}
+	// cellStart_[c] を書き込み位置として使い、最後に 1 つずらして戻す
+	for (size_t i = 0; i < count; ++i) {
+		if (agentCells_[i] != noCell) {
+			cellAgents_[cellStart_[agentCells_[i]]++] = static_cast<uint32_t>(i);
+		}
+	}
+	for (size_t c = cellStart_.size() - 1; c > 0; --c) {
+		cellStart_[c] = cellStart_[c - 1];
+	}
+	cellStart_[0] = 0;
+}
+
+AgentSystem::CellRange AgentSystem::GetCellRange(float left, float bottom, float right, float top) const {
+	CellRange range;
+	if (cellCountX_ == 0 || cellCountY_ == 0) {
+		return range;
+	}
+	auto toCell = [](float value, uint32_t cellCount) {
+		float cell = std::floor(value / kCellSize);
+		return static_cast<uint32_t>(std::clamp(cell, 0.0f, static_cast<float>(cellCount - 1)));
+	};
+	range.xBegin = toCell(left, cellCountX_);
+	range.xEnd = toCell(right, cellCountX_) + 1;
+	range.yBegin = toCell(bottom, cellCountY_);
+	range.yEnd = toCell(top, cellCountY_) + 1;
+	return range;
+}
+
+uint32_t AgentSystem::FindOverlap(const Vector3& center, const Vector3& size) const {
+	PROFILE_FUNCTION();
+	float halfWidth = size.x * 0.5f;
+	float halfHeight = size.y * 0.5f;
+	uint32_t found = UINT32_MAX;
+	ForEachInRect(center.x - halfWidth, center.y - halfHeight, center.x + halfWidth, center.y + halfHeight, [&](uint32_t index) {
+		bool isOverlapping = std::fabs(positionX_[index] - center.x) < kHalfSize + halfWidth && std::fabs(positionY_[index] - center.y) < kHalfSize + halfHeight;
+		if (isOverlapping && index < found) {
+			found = index;
+		}
+	});
+	return found;
+}
+
+Matrix4x4 AgentSystem::GetWorldMatrix(size_t index) const {
+	// ブロックのモデル（1 辺 2）を当たり判定の大きさに縮める
+	const float scale = kHalfSize;
+	Matrix4x4 matrix = {};
+	matrix.m[0][0] = scale;
+	matrix.m[1][1] = scale;
+	matrix.m[2][2] = scale;
+	matrix.m[3][0] = positionX_[index];
+	matrix.m[3][1] = positionY_[index];
+	matrix.m[3][3] = 1.0f;
+	return matrix;
+}
+
+Vector4 AgentSystem::GetColor(AgentKind kind) {
+	switch (kind) {
+	case AgentKind::kPatrol:
+		return {1.0f, 0.3f, 0.3f, 1.0f};
+	case AgentKind::kFalling:
+		return {1.0f, 0.6f, 0.2f, 1.0f};
+	case AgentKind::kChaser:
+		return {0.7f, 0.3f, 1.0f, 1.0f};
+	}
+	return {1.0f, 1.0f, 1.0f, 1.0f};
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include "KamataEngine.h"
+#include "MapChipField.h"
+#include <cstdint>
+#include <vector>
+using namespace KamataEngine;
+
+// 敵・障害物の種類（マップチップ 3 / 4 / 5 で配置する）
+enum class AgentKind : uint8_t {
+	kPatrol,  // 床の上を往復する。壁と床の端で折り返す
+	kFalling, // プレイヤーが真下に来たら落ちてくるブロック
+	kChaser,  // 近くにいるプレイヤーを左右に追いかける
+};
+
+// 関卡ごとの敵・障害物をまとめて動かす。
+// 状態は種類ごとのクラスではなく配列（SoA）で持ち、1 tick 分を一括で進める。
+// マップの判定も 1 体ずつではなく、全員分の調べるタイルを集めてから MapChipField::IsBlockAtIndices で一度に引く。
+// プレイヤーとの当たりは一様グリッドのブロードフェーズで調べる（描画の視錐台カリングにも使う）。
+class AgentSystem {
+public:
+	static constexpr float kHalfSize = 0.8f; // 当たり判定の半分の大きさ（タイルより少し小さい）
+
+	void Clear();
+	void Reserve(size_t count);
+	void Spawn(AgentKind kind, const Vector3& position);
+	// 全員をスポーン位置と初期状態に戻す（原地重開用）
+	void Reset();
+
+	// 1 tick 進めて、ブロードフェーズを作り直す。playerPosition は追いかけ・落下の判定に使う
+	void Update(const MapChipField& map, const Vector3& playerPosition);
+
+	// 中心 center、大きさ size の矩形と重なる敵の番号（無ければ UINT32_MAX）
+	uint32_t FindOverlap(const Vector3& center, const Vector3& size) const;
+
+	// ワールド座標の矩形に入っている敵ごとに function(index) を呼ぶ（ブロードフェーズのセル単位）
+	template <typename Function>
+	void ForEachInRect(float left, float bottom, float right, float top, Function&& function) const {
+		CellRange range = GetCellRange(left - kHalfSize, bottom - kHalfSize, right + kHalfSize, top + kHalfSize);
+		for (uint32_t cy = range.yBegin; cy < range.yEnd; ++cy) {
+			for (uint32_t cx = range.xBegin; cx < range.xEnd; ++cx) {
+				uint32_t cell = cy * cellCountX_ + cx;
+				for (uint32_t n = cellStart_[cell]; n < cellStart_[cell + 1]; ++n) {
+					function(cellAgents_[n]);
+				}
+			}
+		}
+	}
+
+	size_t GetCount() const { return positionX_.size(); }
+	AgentKind GetKind(size_t index) const { return static_cast<AgentKind>(kind_[index]); }
+	Vector3 GetPosition(size_t index) const { return {positionX_[index], positionY_[index], 0.0f}; }
+	bool IsActive(size_t index) const { return isActive_[index] != 0; }
+	// 描画用（スケールと平行移動だけの行列）
+	Matrix4x4 GetWorldMatrix(size_t index) const;
+	static Vector4 GetColor(AgentKind kind);
+
+	float GetLastUpdateMicroseconds() const { return lastUpdateMicroseconds_; }
+
+private:
+	struct CellRange {
+		uint32_t xBegin = 0;
+		uint32_t xEnd = 0;
+		uint32_t yBegin = 0;
+		uint32_t yEnd = 0;
+	};
+
+	void BuildBroadphase(const MapChipField& map);
+	CellRange GetCellRange(float left, float bottom, float right, float top) const;
+
+	// --- 敵ごとの状態（添字が同じものが 1 体分） ---
+	std::vector<float> positionX_;
+	std::vector<float> positionY_;
+	std::vector<float> velocityX_;
+	std::vector<float> velocityY_;
+	std::vector<float> spawnX_;
+	std::vector<float> spawnY_;
+	std::vector<int8_t> direction_; // 往復の向き（+1 / -1）
+	std::vector<uint8_t> kind_;
+	std::vector<uint8_t> state_;    // 落下ブロック: 待機 / 落下中 / 着地
+	std::vector<uint8_t> isGrounded_;
+	std::vector<uint8_t> isActive_; // マップの下に落ちたら 0
+
+	// --- 一括のタイル判定（1 体あたり kProbeCount 個） ---
+	std::vector<uint32_t> probeX_;
+	std::vector<uint32_t> probeY_;
+	std::vector<uint8_t> probeHits_;
+
+	// --- ブロードフェーズ（セルごとに敵の番号を並べる。cellStart_[c] ~ cellStart_[c + 1] がセル c） ---
+	uint32_t cellCountX_ = 0;
+	uint32_t cellCountY_ = 0;
+	std::vector<uint32_t> cellStart_;
+	std::vector<uint32_t> cellAgents_;
+	std::vector<uint32_t> agentCells_;
+
+	float lastUpdateMicroseconds_ = 0.0f;
+};
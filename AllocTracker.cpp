@@ -0,0 +1,450 @@
+#include "AllocTracker.h"
+
+#ifdef USE_ALLOC_TRACKER
+
+#include "Logger.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+#ifdef USE_IMGUI
+#include "KamataEngine.h"
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#pragma intrinsic(_ReturnAddress)
+#define ALLOC_TRACKER_CALLER() _ReturnAddress()
+#else
+#define ALLOC_TRACKER_CALLER() __builtin_return_address(0)
+#endif
+
+// ここで確保すると再帰するので、集計用の表は全て固定長の静的配列にする。
+// 表のリセットと読み出しはメインスレッドの BeginFrame / EndFrame で行う（他スレッドの確保は近似値になる）。
+namespace {
+	constexpr size_t kCallsiteSlots = 512;
+	constexpr size_t kZoneSlots = 128;
+	constexpr size_t kMaxProbe = 16;
+	constexpr size_t kFailureRecords = 32;
+
+	struct CallsiteSlot {
+		std::atomic<uint64_t> key{0};
+		const void* callstack[AllocTracker::kCallstackDepth] = {};
+		std::atomic<uint64_t> count{0};
+		std::atomic<uint64_t> bytes{0};
+	};
+
+	struct ZoneSlot {
+		std::atomic<const char*> name{nullptr};
+		std::atomic<uint64_t> count{0};
+		std::atomic<uint64_t> bytes{0};
+	};
+
+	// 定常状態チェックで見つかった確保
+	struct FailureRecord {
+		const char* scope = nullptr;
+		const char* zone = nullptr;
+		const void* callstack[AllocTracker::kCallstackDepth] = {};
+		size_t size = 0;
+	};
+
+	CallsiteSlot callsites[kCallsiteSlots];
+	ZoneSlot zones[kZoneSlots];
+	std::atomic<uint64_t> frameCount{0};
+	std::atomic<uint64_t> frameBytes{0};
+	std::atomic<uint64_t> totalCount{0};
+	std::atomic<uint64_t> totalBytes{0};
+	std::atomic<uint64_t> droppedCallsites{0};
+
+	// EndFrame でのスナップショット
+	AllocTracker::Counters lastFrame;
+	AllocTracker::CallsiteEntry lastCallsites[kCallsiteSlots];
+	size_t lastCallsiteCount = 0;
+	AllocTracker::ZoneEntry lastZones[kZoneSlots];
+	size_t lastZoneCount = 0;
+	uint64_t lastDroppedCallsites = 0;
+
+	bool isSteadyStateCheckEnabled = false;
+	bool hasSteadyStateFailure = false;
+	// ジョブを実行するワーカーからも書き込むので、番号は atomic で取る
+	FailureRecord failures[kFailureRecords];
+	std::atomic<size_t> failureCount{0};
+
+	thread_local uint64_t threadAllocationCount = 0;
+	// 定常状態チェック中の TickScope（このスレッドの確保を記録する）
+	thread_local AllocTracker::TickScope* threadArmedScope = nullptr;
+
+	const char* CurrentZone() {
+#ifdef USE_PROFILER
+		ProfileThreadBuffer* buffer = ProfilerDetail::threadBuffer;
+		return buffer ? buffer->currentZone : nullptr;
+#else
+		return nullptr;
+#endif
+	}
+
+	uint64_t HashCallstack(const void* const* callstack) {
+		uint64_t hash = 14695981039346656037ull;
+		for (size_t i = 0; i < AllocTracker::kCallstackDepth; ++i) {
+			hash ^= reinterpret_cast<uintptr_t>(callstack[i]);
+			hash *= 1099511628211ull;
+		}
+		// 0 は空きスロットの印
+		return hash ? hash : 1;
+	}
+
+	void RecordCallsite(const void* const* callstack, size_t size) {
+		uint64_t key = HashCallstack(callstack);
+		for (size_t probe = 0; probe < kMaxProbe; ++probe) {
+			CallsiteSlot& slot = callsites[(key + probe) % kCallsiteSlots];
+			uint64_t expected = slot.key.load(std::memory_order_acquire);
+			if (expected == 0 && slot.key.compare_exchange_strong(expected, key, std::memory_order_acq_rel)) {
+				std::copy(callstack, callstack + AllocTracker::kCallstackDepth, slot.callstack);
+				expected = key;
+			}
+			if (expected == key) {
+				slot.count.fetch_add(1, std::memory_order_relaxed);
+				slot.bytes.fetch_add(size, std::memory_order_relaxed);
+				return;
+			}
+		}
+		droppedCallsites.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void RecordZone(const char* zone, size_t size) {
+		size_t start = (reinterpret_cast<uintptr_t>(zone) >> 3) % kZoneSlots;
+		for (size_t probe = 0; probe < kMaxProbe; ++probe) {
+			ZoneSlot& slot = zones[(start + probe) % kZoneSlots];
+			const char* expected = slot.name.load(std::memory_order_acquire);
+			if (expected == nullptr && slot.name.compare_exchange_strong(expected, zone, std::memory_order_acq_rel)) {
+				expected = zone;
+			}
+			if (expected == zone) {
+				slot.count.fetch_add(1, std::memory_order_relaxed);
+				slot.bytes.fetch_add(size, std::memory_order_relaxed);
+				return;
+			}
+		}
+	}
+
+	// 呼び出し元を取る。operator new と RecordAllocation の 2 段を飛ばす
+#ifdef _MSC_VER
+	__declspec(noinline)
+#else
+	__attribute__((noinline))
+#endif
+	void RecordAllocation(size_t size, const void* caller) {
+		frameCount.fetch_add(1, std::memory_order_relaxed);
+		frameBytes.fetch_add(size, std::memory_order_relaxed);
+		totalCount.fetch_add(1, std::memory_order_relaxed);
+		totalBytes.fetch_add(size, std::memory_order_relaxed);
+		++threadAllocationCount;
+
+		const void* callstack[AllocTracker::kCallstackDepth] = {};
+#ifdef _WIN32
+		if (RtlCaptureStackBackTrace(2, static_cast<DWORD>(AllocTracker::kCallstackDepth), const_cast<void**>(callstack), nullptr) == 0) {
+			callstack[0] = caller;
+		}
+#else
+		callstack[0] = caller;
+#endif
+		RecordCallsite(callstack, size);
+
+		const char* zone = CurrentZone();
+		if (zone) {
+			RecordZone(zone, size);
+		}
+
+		if (AllocTracker::TickScope* scope = threadArmedScope) {
+			scope->CountAllocation();
+			size_t index = failureCount.fetch_add(1, std::memory_order_relaxed);
+			if (index < kFailureRecords) {
+				FailureRecord& record = failures[index];
+				record.scope = scope->GetName();
+				record.zone = zone;
+				std::copy(callstack, callstack + AllocTracker::kCallstackDepth, record.callstack);
+				record.size = size;
+			}
+		}
+	}
+
+	void* AllocateOrThrow(size_t size) {
+		if (size == 0) {
+			size = 1;
+		}
+		for (;;) {
+			void* memory = std::malloc(size);
+			if (memory) {
+				return memory;
+			}
+			std::new_handler handler = std::get_new_handler();
+			if (!handler) {
+				throw std::bad_alloc();
+			}
+			handler();
+		}
+	}
+
+	void* AllocateAlignedOrThrow(size_t size, std::align_val_t alignment) {
+		size_t align = static_cast<size_t>(alignment);
+		if (size == 0) {
+			size = 1;
+		}
+		for (;;) {
+#ifdef _MSC_VER
+			void* memory = _aligned_malloc(size, align);
+#else
+			void* memory = std::aligned_alloc(align, (size + align - 1) / align * align);
+#endif
+			if (memory) {
+				return memory;
+			}
+			std::new_handler handler = std::get_new_handler();
+			if (!handler) {
+				throw std::bad_alloc();
+			}
+			handler();
+		}
+	}
+
+	void FreeAligned(void* memory) {
+#ifdef _MSC_VER
+		_aligned_free(memory);
+#else
+		std::free(memory);
+#endif
+	}
+
+}
+
+// ---- グローバルな operator new / delete の置き換え ----
+
+void* operator new(size_t size) {
+	RecordAllocation(size, ALLOC_TRACKER_CALLER());
+	return AllocateOrThrow(size);
+}
+
+void* operator new[](size_t size) {
+	RecordAllocation(size, ALLOC_TRACKER_CALLER());
+	return AllocateOrThrow(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+	RecordAllocation(size, ALLOC_TRACKER_CALLER());
+	try {
+		return AllocateOrThrow(size);
+	} catch (...) {
+		return nullptr;
+	}
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+	RecordAllocation(size, ALLOC_TRACKER_CALLER());
+	try {
+		return AllocateOrThrow(size);
+	} catch (...) {
+		return nullptr;
+	}
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+	RecordAllocation(size, ALLOC_TRACKER_CALLER());
+	return AllocateAlignedOrThrow(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+	RecordAllocation(size, ALLOC_TRACKER_CALLER());
+	return AllocateAlignedOrThrow(size, alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+	RecordAllocation(size, ALLOC_TRACKER_CALLER());
+	try {
+		return AllocateAlignedOrThrow(size, alignment);
+	} catch (...) {
+		return nullptr;
+	}
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+	RecordAllocation(size, ALLOC_TRACKER_CALLER());
+	try {
+		return AllocateAlignedOrThrow(size, alignment);
+	} catch (...) {
+		return nullptr;
+	}
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { FreeAligned(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { FreeAligned(memory); }
+void operator delete(void* memory, size_t, std::align_val_t) noexcept { FreeAligned(memory); }
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept { FreeAligned(memory); }
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept { FreeAligned(memory); }
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept { FreeAligned(memory); }
+
+// ---- 集計 ----
+
+void AllocTracker::BeginFrame() {
+	for (CallsiteSlot& slot : callsites) {
+		slot.key.store(0, std::memory_order_relaxed);
+		slot.count.store(0, std::memory_order_relaxed);
+		slot.bytes.store(0, std::memory_order_relaxed);
+	}
+	for (ZoneSlot& slot : zones) {
+		slot.name.store(nullptr, std::memory_order_relaxed);
+		slot.count.store(0, std::memory_order_relaxed);
+		slot.bytes.store(0, std::memory_order_relaxed);
+	}
+	frameCount.store(0, std::memory_order_relaxed);
+	frameBytes.store(0, std::memory_order_relaxed);
+	droppedCallsites.store(0, std::memory_order_relaxed);
+}
+
+void AllocTracker::EndFrame() {
+	lastFrame.count = frameCount.load(std::memory_order_relaxed);
+	lastFrame.bytes = frameBytes.load(std::memory_order_relaxed);
+	lastDroppedCallsites = droppedCallsites.load(std::memory_order_relaxed);
+
+	lastCallsiteCount = 0;
+	for (const CallsiteSlot& slot : callsites) {
+		if (slot.key.load(std::memory_order_acquire) == 0) {
+			continue;
+		}
+		CallsiteEntry& entry = lastCallsites[lastCallsiteCount++];
+		std::copy(slot.callstack, slot.callstack + kCallstackDepth, entry.callstack);
+		entry.count = slot.count.load(std::memory_order_relaxed);
+		entry.bytes = slot.bytes.load(std::memory_order_relaxed);
+	}
+	std::sort(lastCallsites, lastCallsites + lastCallsiteCount, [](const CallsiteEntry& a, const CallsiteEntry& b) { return a.count > b.count; });
+
+	lastZoneCount = 0;
+	for (const ZoneSlot& slot : zones) {
+		const char* name = slot.name.load(std::memory_order_acquire);
+		if (!name) {
+			continue;
+		}
+		ZoneEntry& entry = lastZones[lastZoneCount++];
+		entry.name = name;
+		entry.count = slot.count.load(std::memory_order_relaxed);
+		entry.bytes = slot.bytes.load(std::memory_order_relaxed);
+	}
+	std::sort(lastZones, lastZones + lastZoneCount, [](const ZoneEntry& a, const ZoneEntry& b) { return a.count > b.count; });
+}
+
+AllocTracker::Counters AllocTracker::GetLastFrame() { return lastFrame; }
+
+AllocTracker::Counters AllocTracker::GetTotal() {
+	Counters counters;
+	counters.count = totalCount.load(std::memory_order_relaxed);
+	counters.bytes = totalBytes.load(std::memory_order_relaxed);
+	return counters;
+}
+
+size_t AllocTracker::GetLastFrameCallsites(CallsiteEntry* out, size_t capacity) {
+	size_t count = std::min(capacity, lastCallsiteCount);
+	std::copy(lastCallsites, lastCallsites + count, out);
+	return count;
+}
+
+size_t AllocTracker::GetLastFrameZones(ZoneEntry* out, size_t capacity) {
+	size_t count = std::min(capacity, lastZoneCount);
+	std::copy(lastZones, lastZones + count, out);
+	return count;
+}
+
+uint64_t AllocTracker::GetThreadAllocationCount() { return threadAllocationCount; }
+
+void AllocTracker::SetSteadyStateCheck(bool enabled) {
+	isSteadyStateCheckEnabled = enabled;
+	if (enabled) {
+		hasSteadyStateFailure = false;
+	}
+}
+
+bool AllocTracker::IsSteadyStateCheckEnabled() { return isSteadyStateCheckEnabled; }
+
+bool AllocTracker::HasSteadyStateFailure() { return hasSteadyStateFailure; }
+
+AllocTracker::TickScope::TickScope(const char* name, bool armed) : name_(name) {
+	// チェックが無効なら記録しない。入れ子の場合は外側に任せる
+	isArmed_ = armed && isSteadyStateCheckEnabled && !threadArmedScope;
+	if (isArmed_) {
+		failureCount.store(0, std::memory_order_relaxed);
+		threadArmedScope = this;
+	}
+}
+
+void AllocTracker::TickScope::End() {
+	if (!isArmed_) {
+		return;
+	}
+	isArmed_ = false;
+	threadArmedScope = nullptr;
+
+	// 範囲内で投入したジョブは Wait 済みなので、ワーカーでの確保も数え終わっている
+	uint64_t allocations = GetAllocationCount();
+	if (allocations == 0) {
+		return;
+	}
+	hasSteadyStateFailure = true;
+	LOG_ERROR(LogCategory::kGeneral, "AllocTracker: steady-state tick '%s' allocated %llu time(s)", name_, static_cast<unsigned long long>(allocations));
+	size_t recordCount = std::min(static_cast<size_t>(allocations), kFailureRecords);
+	for (size_t i = 0; i < recordCount; ++i) {
+		const FailureRecord& record = failures[i];
+		static_assert(kCallstackDepth == 4, "表示は 4 段分");
+		LOG_ERROR(LogCategory::kGeneral, "  %zu bytes in zone '%s' at %p %p %p %p", record.size, record.zone ? record.zone : "(none)", record.callstack[0],
+		          record.callstack[1], record.callstack[2], record.callstack[3]);
+	}
+	if (allocations > recordCount) {
+		LOG_ERROR(LogCategory::kGeneral, "  ... %llu more", static_cast<unsigned long long>(allocations - recordCount));
+	}
+}
+
+AllocTracker::TickScope* AllocTracker::GetArmedScope() { return threadArmedScope; }
+
+AllocTracker::ArmedScopeBinding::ArmedScopeBinding(TickScope* scope) : previous_(threadArmedScope) { threadArmedScope = scope; }
+
+AllocTracker::ArmedScopeBinding::~ArmedScopeBinding() { threadArmedScope = previous_; }
+
+void AllocTracker::DrawImGui() {
+#ifdef USE_IMGUI
+	ImGui::Begin("Alloc Tracker");
+	Counters total = GetTotal();
+	ImGui::Text("Last frame: %llu allocs, %llu bytes", static_cast<unsigned long long>(lastFrame.count), static_cast<unsigned long long>(lastFrame.bytes));
+	ImGui::Text("Total: %llu allocs, %llu bytes", static_cast<unsigned long long>(total.count), static_cast<unsigned long long>(total.bytes));
+	ImGui::Text("Steady-state check: %s%s", isSteadyStateCheckEnabled ? "on" : "off", hasSteadyStateFailure ? " (FAILED)" : "");
+	if (lastDroppedCallsites > 0) {
+		ImGui::Text("Callsite table full: %llu dropped", static_cast<unsigned long long>(lastDroppedCallsites));
+	}
+
+	ImGui::Separator();
+	ImGui::Text("Zones:");
+	for (size_t i = 0; i < lastZoneCount; ++i) {
+		ImGui::Text("  %s  x%llu  %llu bytes", lastZones[i].name, static_cast<unsigned long long>(lastZones[i].count), static_cast<unsigned long long>(lastZones[i].bytes));
+	}
+
+	ImGui::Separator();
+	ImGui::Text("Callsites:");
+	for (size_t i = 0; i < lastCallsiteCount && i < 16; ++i) {
+		const CallsiteEntry& entry = lastCallsites[i];
+		static_assert(kCallstackDepth == 4, "表示は 4 段分");
+		ImGui::Text("  %p %p %p %p  x%llu  %llu bytes", entry.callstack[0], entry.callstack[1], entry.callstack[2], entry.callstack[3], static_cast<unsigned long long>(entry.count),
+		            static_cast<unsigned long long>(entry.bytes));
+	}
+	ImGui::End();
+#endif
+}
+
+#endif // USE_ALLOC_TRACKER
@@ -0,0 +1,91 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// ヒープ確保の計測（USE_ALLOC_TRACKER を定義した構成のみ。グローバルな operator new/delete を置き換える）。
+// フレームごとの回数・バイト数、呼び出し元アドレス、プロファイラの区間（USE_PROFILER 時）ごとに集計する。
+// 起動引数 -alloc-check で、定常状態のゲームプレイ tick が 1 回でも確保したら失敗として終了コード 1 で終わる。
+#ifdef USE_ALLOC_TRACKER
+
+#include <atomic>
+
+namespace AllocTracker {
+	static constexpr size_t kCallstackDepth = 4;
+
+	struct Counters {
+		uint64_t count = 0;
+		uint64_t bytes = 0;
+	};
+
+	struct CallsiteEntry {
+		const void* callstack[kCallstackDepth] = {};
+		uint64_t count = 0;
+		uint64_t bytes = 0;
+	};
+
+	struct ZoneEntry {
+		const char* name = nullptr;
+		uint64_t count = 0;
+		uint64_t bytes = 0;
+	};
+
+	// メインループの先頭と末尾で呼ぶ
+	void BeginFrame();
+	void EndFrame();
+
+	Counters GetLastFrame();
+	Counters GetTotal();
+	// 前のフレームの内訳（回数の多い順）。書き込んだ数を返す
+	size_t GetLastFrameCallsites(CallsiteEntry* out, size_t capacity);
+	size_t GetLastFrameZones(ZoneEntry* out, size_t capacity);
+
+	// 呼び出し元スレッドで今までに確保した回数
+	uint64_t GetThreadAllocationCount();
+
+	// 定常状態チェック（有効にすると、それまでの失敗は消える）
+	void SetSteadyStateCheck(bool enabled);
+	bool IsSteadyStateCheckEnabled();
+	bool HasSteadyStateFailure();
+
+	// 範囲内で確保があれば失敗として記録する（armed が false なら何もしない）。
+	// 範囲内で投入したジョブはワーカースレッドで実行されても数える（JobSystem が ArmedScopeBinding で引き継ぐ）
+	class TickScope {
+	public:
+		TickScope(const char* name, bool armed);
+		~TickScope() { End(); }
+		void End();
+
+		TickScope(const TickScope&) = delete;
+		TickScope& operator=(const TickScope&) = delete;
+
+		const char* GetName() const { return name_; }
+		// 範囲内の確保の回数（どのスレッドからでも operator new が数える）
+		uint64_t GetAllocationCount() const { return allocationCount_.load(std::memory_order_relaxed); }
+		void CountAllocation() { allocationCount_.fetch_add(1, std::memory_order_relaxed); }
+
+	private:
+		const char* name_;
+		std::atomic<uint64_t> allocationCount_{0};
+		bool isArmed_ = false;
+	};
+
+	// 呼び出し元スレッドで記録中の TickScope（なければ nullptr）
+	TickScope* GetArmedScope();
+
+	// 範囲内だけ、このスレッドの確保を scope に数える（nullptr なら数えない）
+	class ArmedScopeBinding {
+	public:
+		explicit ArmedScopeBinding(TickScope* scope);
+		~ArmedScopeBinding();
+
+		ArmedScopeBinding(const ArmedScopeBinding&) = delete;
+		ArmedScopeBinding& operator=(const ArmedScopeBinding&) = delete;
+
+	private:
+		TickScope* previous_;
+	};
+
+	void DrawImGui();
+}
+
+#endif // USE_ALLOC_TRACKER
@@ -0,0 +1,170 @@
+#pragma once
+#include "Delegate.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+// 按名字缓存资源并做引用计数。加载/释放函数可以替换，
+// 所以可以用假的加载器在没有渲染器的环境下使用。只在主线程访问。
+template <typename T>
+class AssetCache {
+public:
+	enum class Policy {
+		kReleaseOnZero, // 引用计数为 0 时立即释放
+		kKeepWarm,      // 引用计数为 0 时仍然保留 keep-warm 的帧数（0 表示直到 Trim()/Clear()）
+	};
+
+	// 和其他回调一样用 Delegate（不分配堆内存）。捕获超过容量时请改为捕获指针
+	using LoadFunction = Delegate<T(const std::string&)>;
+	using UnloadFunction = Delegate<void(T&)>;
+
+	AssetCache() = default;
+	~AssetCache() { Clear(); }
+	AssetCache(const AssetCache&) = delete;
+	AssetCache& operator=(const AssetCache&) = delete;
+
+	void SetLoader(LoadFunction load, UnloadFunction unload) {
+		load_ = std::move(load);
+		unload_ = std::move(unload);
+	}
+
+	void SetDefaultPolicy(Policy policy) { defaultPolicy_ = policy; }
+	// keep-warm 的资源在引用计数为 0 后保留的帧数（按 Update 的次数计，0 表示不自动释放）
+	void SetKeepWarmFrames(uint32_t frames) { keepWarmFrames_ = frames; }
+
+	// 单独指定某个资源的策略（可以在第一次 Acquire 之前设置）
+	void SetPolicy(const std::string& name, Policy policy) {
+		policies_[name] = policy;
+		auto it = entries_.find(name);
+		if (it != entries_.end()) {
+			it->second.policy = policy;
+			ReleaseIfUnused(it);
+		}
+	}
+
+	// 取得资源并增加引用计数，未缓存时调用加载函数
+	T Acquire(const std::string& name) {
+		auto it = entries_.find(name);
+		if (it == entries_.end()) {
+			Entry entry;
+			entry.value = load_ ? load_(name) : T{};
+			auto policyIt = policies_.find(name);
+			entry.policy = policyIt != policies_.end() ? policyIt->second : defaultPolicy_;
+			it = entries_.emplace(name, std::move(entry)).first;
+			loadCount_++;
+		} else {
+			hitCount_++;
+		}
+		if (it->second.refCount == 0 && it->second.isWarm) {
+			it->second.isWarm = false;
+			warmCount_--;
+		}
+		it->second.refCount++;
+		return it->second.value;
+	}
+
+	void Release(const std::string& name) {
+		auto it = entries_.find(name);
+		if (it == entries_.end() || it->second.refCount == 0) {
+			return;
+		}
+		it->second.refCount--;
+		ReleaseIfUnused(it);
+	}
+
+	// 每帧调用一次（与 Acquire/Release 同一线程）。没有引用的 keep-warm 资源超过 keep-warm 帧数后释放
+	void Update() {
+		frame_++;
+		if (keepWarmFrames_ == 0 || warmCount_ == 0) {
+			return;
+		}
+		for (auto it = entries_.begin(); it != entries_.end();) {
+			if (it->second.isWarm && frame_ - it->second.unusedSinceFrame >= keepWarmFrames_) {
+				Unload(it->second);
+				warmCount_--;
+				evictionCount_++;
+				it = entries_.erase(it);
+			} else {
+				++it;
+			}
+		}
+	}
+
+	// 释放所有没有被引用的资源（包括 keep-warm 的资源）
+	void Trim() {
+		for (auto it = entries_.begin(); it != entries_.end();) {
+			if (it->second.refCount == 0) {
+				Unload(it->second);
+				warmCount_ -= it->second.isWarm ? 1 : 0;
+				it = entries_.erase(it);
+			} else {
+				++it;
+			}
+		}
+	}
+
+	// 释放全部资源（结束处理用）
+	void Clear() {
+		for (auto& [name, entry] : entries_) {
+			Unload(entry);
+		}
+		entries_.clear();
+		warmCount_ = 0;
+	}
+
+	bool Contains(const std::string& name) const { return entries_.contains(name); }
+	uint32_t GetRefCount(const std::string& name) const {
+		auto it = entries_.find(name);
+		return it != entries_.end() ? it->second.refCount : 0;
+	}
+	size_t GetSize() const { return entries_.size(); }
+	uint32_t GetLoadCount() const { return loadCount_; }
+	uint32_t GetHitCount() const { return hitCount_; }
+	// keep-warm 帧数到期而释放的次数
+	uint32_t GetEvictionCount() const { return evictionCount_; }
+
+private:
+	struct Entry {
+		T value{};
+		uint32_t refCount = 0;
+		Policy policy = Policy::kKeepWarm;
+		bool isWarm = false;          // 没有引用但仍然保留
+		uint64_t unusedSinceFrame = 0; // 引用计数变为 0 的帧
+	};
+	using Iterator = typename std::unordered_map<std::string, Entry>::iterator;
+
+	void ReleaseIfUnused(Iterator it) {
+		Entry& entry = it->second;
+		if (entry.refCount != 0) {
+			return;
+		}
+		if (entry.policy == Policy::kReleaseOnZero) {
+			warmCount_ -= entry.isWarm ? 1 : 0;
+			Unload(entry);
+			entries_.erase(it);
+		} else if (!entry.isWarm) {
+			entry.isWarm = true;
+			entry.unusedSinceFrame = frame_;
+			warmCount_++;
+		}
+	}
+
+	void Unload(Entry& entry) {
+		if (unload_) {
+			unload_(entry.value);
+		}
+	}
+
+	LoadFunction load_;
+	UnloadFunction unload_;
+	Policy defaultPolicy_ = Policy::kKeepWarm;
+	std::unordered_map<std::string, Entry> entries_;
+	std::unordered_map<std::string, Policy> policies_;
+	uint32_t loadCount_ = 0;
+	uint32_t hitCount_ = 0;
+	uint32_t evictionCount_ = 0;
+	uint32_t keepWarmFrames_ = 0;
+	uint32_t warmCount_ = 0; // isWarm 的资源数（为 0 时 Update 什么都不做）
+	uint64_t frame_ = 0;
+};
@@ -0,0 +1,37 @@
+#include "AssetManager.h"
+using namespace KamataEngine;
+
+std::unique_ptr<AssetManager> AssetManager::instance_ = nullptr;
+
+AssetManager& AssetManager::GetInstance() {
+	if (!instance_) {
+		instance_ = std::unique_ptr<AssetManager>(new AssetManager());
+	}
+	return *instance_;
+}
+
+void AssetManager::Destroy() {
+	// 必须在 KamataEngine::Finalize() 之前调用
+	instance_.reset();
+}
+
+AssetManager::AssetManager() {
+	models_.SetLoader(
+	    [](const std::string& name) { return Model::CreateFromOBJ(name); },
+	    [](Model*& model) {
+		    delete model;
+		    model = nullptr;
+	    });
+	models_.SetDefaultPolicy(AssetCache<Model*>::Policy::kKeepWarm);
+	models_.SetKeepWarmFrames(kKeepWarmFrames);
+
+	// 纹理由 TextureManager 持有，这里只缓存句柄
+	textures_.SetLoader([](const std::string& name) { return TextureManager::Load(name); }, nullptr);
+	textures_.SetDefaultPolicy(AssetCache<uint32_t>::Policy::kKeepWarm);
+	textures_.SetKeepWarmFrames(kKeepWarmFrames);
+}
+
+void AssetManager::Update() {
+	models_.Update();
+	textures_.Update();
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "AssetCache.h"
+#include "KamataEngine.h"
+#include <memory>
+
+// 跨场景共享的资源缓存。场景只 Acquire/Release，
+// 模型默认 keep-warm，死亡重开或切换关卡时不再重新读取 OBJ。没有引用超过 kKeepWarmFrames 帧后才释放。
+class AssetManager {
+public:
+	AssetManager(const AssetManager&) = delete;
+	AssetManager& operator=(const AssetManager&) = delete;
+
+	~AssetManager() = default;
+
+	static AssetManager& GetInstance();
+	static void Destroy();
+
+	AssetCache<KamataEngine::Model*>& GetModels() { return models_; }
+	AssetCache<uint32_t>& GetTextures() { return textures_; }
+
+	// 每帧调用一次（与场景在同一线程）
+	void Update();
+
+	static constexpr uint32_t kKeepWarmFrames = 600; // 60Hz 下 10 秒
+
+private:
+	AssetManager();
+	static std::unique_ptr<AssetManager> instance_;
+
+	AssetCache<KamataEngine::Model*> models_;
+	AssetCache<uint32_t> textures_;
+};
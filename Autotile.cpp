@@ -0,0 +1,208 @@
+#include "Autotile.h"
+#include "Profiler.h"
+#include <array>
+#include <cstring>
+#include <algorithm>
+
+namespace {
+	constexpr uint64_t kAllSolid = ~uint64_t{0};
+
+	// 4 近傍：上・右・下・左をそのまま 4 ビットにする（tile.tsx の並びと同じ）
+	std::array<uint8_t, 256> BuildFourNeighborTable() {
+		std::array<uint8_t, 256> table = {};
+		for (uint32_t mask = 0; mask < 256; ++mask) {
+			uint32_t variant = 0;
+			variant |= (mask & AutotileMap::kNorth) ? 1u : 0u;
+			variant |= (mask & AutotileMap::kEast) ? 2u : 0u;
+			variant |= (mask & AutotileMap::kSouth) ? 4u : 0u;
+			variant |= (mask & AutotileMap::kWest) ? 8u : 0u;
+			table[mask] = static_cast<uint8_t>(variant);
+		}
+		return table;
+	}
+
+	// 両側の辺が繋がっていない角は見た目に影響しないので落とす
+	uint8_t ReduceCorners(uint32_t mask) {
+		auto has = [mask](uint8_t bit) { return (mask & bit) != 0; };
+		uint32_t reduced = mask & (AutotileMap::kNorth | AutotileMap::kEast | AutotileMap::kSouth | AutotileMap::kWest);
+		if (has(AutotileMap::kNorthEast) && has(AutotileMap::kNorth) && has(AutotileMap::kEast)) {
+			reduced |= AutotileMap::kNorthEast;
+		}
+		if (has(AutotileMap::kSouthEast) && has(AutotileMap::kSouth) && has(AutotileMap::kEast)) {
+			reduced |= AutotileMap::kSouthEast;
+		}
+		if (has(AutotileMap::kSouthWest) && has(AutotileMap::kSouth) && has(AutotileMap::kWest)) {
+			reduced |= AutotileMap::kSouthWest;
+		}
+		if (has(AutotileMap::kNorthWest) && has(AutotileMap::kNorth) && has(AutotileMap::kWest)) {
+			reduced |= AutotileMap::kNorthWest;
+		}
+		return static_cast<uint8_t>(reduced);
+	}
+
+	// 8 近傍：角を落としたマスクに小さい順で番号を振る（47 種類）
+	std::array<uint8_t, 256> BuildEightNeighborTable() {
+		std::array<uint8_t, 256> indexOfReduced = {};
+		uint8_t variantCount = 0;
+		for (uint32_t mask = 0; mask < 256; ++mask) {
+			if (ReduceCorners(mask) == mask) {
+				indexOfReduced[mask] = variantCount++;
+			}
+		}
+		std::array<uint8_t, 256> table = {};
+		for (uint32_t mask = 0; mask < 256; ++mask) {
+			table[mask] = indexOfReduced[ReduceCorners(mask)];
+		}
+		return table;
+	}
+
+	// 8 ビット -> 8 バイト（バイト i = ビット i）。8 タイル分の隣のビットを 1 タイル 1 バイトに並べるのに使う
+	std::array<uint64_t, 256> BuildSpreadTable() {
+		std::array<uint64_t, 256> table = {};
+		for (uint32_t bits = 0; bits < 256; ++bits) {
+			for (uint32_t i = 0; i < 8; ++i) {
+				table[bits] |= static_cast<uint64_t>((bits >> i) & 1) << (i * 8);
+			}
+		}
+		return table;
+	}
+
+	const std::array<uint8_t, 256> kFourNeighborTable = BuildFourNeighborTable();
+	const std::array<uint8_t, 256> kEightNeighborTable = BuildEightNeighborTable();
+	const std::array<uint64_t, 256> kSpreadTable = BuildSpreadTable();
+
+	// row のワード w（row が nullptr ならマップの外の行 = 全部ブロック）
+	uint64_t WordAt(const uint64_t* row, uint32_t w, uint32_t wordsPerRow) { return row && w < wordsPerRow ? row[w] : kAllSolid; }
+	// ビット x に、タイル x + 1 の固さを持ってくる
+	uint64_t EastOf(const uint64_t* row, uint32_t w, uint32_t wordsPerRow) { return (WordAt(row, w, wordsPerRow) >> 1) | (WordAt(row, w + 1, wordsPerRow) << 63); }
+	// ビット x に、タイル x - 1 の固さを持ってくる
+	uint64_t WestOf(const uint64_t* row, uint32_t w, uint32_t wordsPerRow) {
+		uint64_t previous = w > 0 ? WordAt(row, w - 1, wordsPerRow) : kAllSolid;
+		return (WordAt(row, w, wordsPerRow) << 1) | (previous >> 63);
+	}
+
+	// ComputeMask 用：ビット順（北から時計回り）の隣の位置
+	constexpr int kNeighborOffsets[8][2] = {{0, -1}, {1, -1}, {1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}};
+}
+
+void AutotileMap::Build(const MapChipField& map, AutotileMode mode) {
+	PROFILE_FUNCTION();
+	mode_ = mode;
+	width_ = map.GetNumBlockHorizontal();
+	height_ = map.GetNumBlockVertical();
+	wordsPerRow_ = (width_ + 63) / 64;
+	const size_t tileCount = static_cast<size_t>(width_) * height_;
+
+	// 幅を超えたビットはマップの外なので 1 にしておく（右端のタイルの東がそのまま求まる）
+	const uint32_t tailBits = width_ % 64;
+	const uint64_t tailMask = tailBits == 0 ? 0 : kAllSolid << tailBits;
+	solid_.assign(static_cast<size_t>(wordsPerRow_) * height_, 0);
+	for (uint32_t y = 0; y < height_; ++y) {
+		uint64_t* row = &solid_[static_cast<size_t>(y) * wordsPerRow_];
+		map.GetBlockRowBits(y, row);
+		if (wordsPerRow_ > 0) {
+			row[wordsPerRow_ - 1] |= tailMask;
+		}
+	}
+
+	masks_.assign(tileCount, 0);
+	variants_.assign(tileCount, kNoVariant);
+	// 結果の書き込み（uint8_t）がメンバーの読み直しを起こさないよう、ループ中はローカルに持つ
+	const uint8_t* table = mode_ == AutotileMode::kFourNeighbor ? kFourNeighborTable.data() : kEightNeighborTable.data();
+	const uint64_t* spread = kSpreadTable.data();
+	const uint32_t width = width_;
+	const uint32_t height = height_;
+	const uint32_t wordsPerRow = wordsPerRow_;
+	for (uint32_t y = 0; y < height; ++y) {
+		const uint64_t* row = &solid_[static_cast<size_t>(y) * wordsPerRow];
+		const uint64_t* up = y > 0 ? row - wordsPerRow : nullptr;
+		const uint64_t* down = y + 1 < height ? row + wordsPerRow : nullptr;
+		uint8_t* maskRow = &masks_[static_cast<size_t>(y) * width];
+		uint8_t* variantRow = &variants_[static_cast<size_t>(y) * width];
+		for (uint32_t w = 0; w < wordsPerRow; ++w) {
+			uint64_t tiles = row[w] & (w + 1 == wordsPerRow ? ~tailMask : kAllSolid);
+			if (tiles == 0) {
+				continue;
+			}
+			// 64 タイル分の隣をシフトでまとめて求める
+			const uint64_t neighbors[8] = {
+			    WordAt(up, w, wordsPerRow),   EastOf(up, w, wordsPerRow),   EastOf(row, w, wordsPerRow), EastOf(down, w, wordsPerRow),
+			    WordAt(down, w, wordsPerRow), WestOf(down, w, wordsPerRow), WestOf(row, w, wordsPerRow), WestOf(up, w, wordsPerRow),
+			};
+			// 8 タイルずつ、隣のビットを 1 タイル 1 バイトのマスクに並べ替える（バイト i のビット n = タイル i の隣 n）
+			for (uint32_t shift = 0; shift < 64 && w * 64 + shift < width; shift += 8) {
+				const uint64_t solidBytes = spread[(tiles >> shift) & 0xFF];
+				uint64_t maskBytes = 0;
+				for (uint32_t n = 0; n < 8; ++n) {
+					maskBytes |= spread[(neighbors[n] >> shift) & 0xFF] << n;
+				}
+				// ブロックでないタイルのマスクは 0
+				maskBytes &= solidBytes * 0xFF;
+				// ブロックでなければ kNoVariant（0xFF）にする（分岐なし）
+				const uint64_t notSolidBytes = (solidBytes ^ 0x0101010101010101ull) * 0xFF;
+				uint8_t masks[8];
+				uint8_t variants[8];
+				for (uint32_t i = 0; i < 8; ++i) {
+					masks[i] = static_cast<uint8_t>(maskBytes >> (i * 8));
+					variants[i] = static_cast<uint8_t>(table[masks[i]] | (notSolidBytes >> (i * 8)));
+				}
+				const uint32_t xBegin = w * 64 + shift;
+				const uint32_t groupCount = std::min(8u, width - xBegin);
+				std::memcpy(maskRow + xBegin, masks, groupCount);
+				std::memcpy(variantRow + xBegin, variants, groupCount);
+			}
+		}
+	}
+}
+
+void AutotileMap::SetSolid(uint32_t xIndex, uint32_t yIndex, bool isSolid) {
+	if (xIndex >= width_ || yIndex >= height_) {
+		return;
+	}
+	uint64_t& word = solid_[static_cast<size_t>(yIndex) * wordsPerRow_ + (xIndex >> 6)];
+	const uint64_t bit = uint64_t{1} << (xIndex & 63);
+	word = isSolid ? (word | bit) : (word & ~bit);
+
+	// 自分と周りの 8 タイルのマスクが変わる
+	for (uint32_t y = yIndex - 1; y != yIndex + 2; ++y) {
+		for (uint32_t x = xIndex - 1; x != xIndex + 2; ++x) {
+			if (x < width_ && y < height_) {
+				UpdateTile(x, y);
+			}
+		}
+	}
+}
+
+bool AutotileMap::IsSolid(uint32_t xIndex, uint32_t yIndex) const {
+	// マップの外はブロック扱い
+	if (xIndex >= width_ || yIndex >= height_) {
+		return true;
+	}
+	return ((solid_[static_cast<size_t>(yIndex) * wordsPerRow_ + (xIndex >> 6)] >> (xIndex & 63)) & 1) != 0;
+}
+
+uint8_t AutotileMap::MaskToVariant(uint8_t mask, AutotileMode mode) {
+	return mode == AutotileMode::kFourNeighbor ? kFourNeighborTable[mask] : kEightNeighborTable[mask];
+}
+
+uint8_t AutotileMap::ComputeMask(uint32_t xIndex, uint32_t yIndex) const {
+	uint32_t mask = 0;
+	for (uint32_t n = 0; n < 8; ++n) {
+		// 0 の左・上は符号なしで回り込んで範囲外になる
+		uint32_t x = xIndex + static_cast<uint32_t>(kNeighborOffsets[n][0]);
+		uint32_t y = yIndex + static_cast<uint32_t>(kNeighborOffsets[n][1]);
+		mask |= (IsSolid(x, y) ? 1u : 0u) << n;
+	}
+	return static_cast<uint8_t>(mask);
+}
+
+void AutotileMap::UpdateTile(uint32_t xIndex, uint32_t yIndex) {
+	const size_t index = static_cast<size_t>(yIndex) * width_ + xIndex;
+	if (IsSolid(xIndex, yIndex)) {
+		masks_[index] = ComputeMask(xIndex, yIndex);
+		variants_[index] = MaskToVariant(masks_[index], mode_);
+	} else {
+		masks_[index] = 0;
+		variants_[index] = kNoVariant;
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "MapChipField.h"
+#include <cstdint>
+#include <vector>
+
+// 近傍の数え方
+enum class AutotileMode : uint8_t {
+	kFourNeighbor,  // 上下左右の 4 ビット -> 16 種類（tile.tsx の 4x4 タイルに対応）
+	kEightNeighbor, // 斜めも含めた 8 ビット -> 47 種類（両側の辺が繋がっている角だけ数える）
+};
+
+// ブロックのタイルごとに、隣のブロックの有無をビットマスクにしてタイルの種類（variant）を決める。
+// 固さは 1 行を 64 タイルずつの uint64_t に詰め、上下左右と斜めの隣はワード単位のシフトでまとめて求める。
+// マップの外はブロック扱い（外周の壁に縁が出ないように）。
+class AutotileMap {
+public:
+	// 近傍ビット（8 近傍のマスク。時計回り）
+	static constexpr uint8_t kNorth = 1 << 0;
+	static constexpr uint8_t kNorthEast = 1 << 1;
+	static constexpr uint8_t kEast = 1 << 2;
+	static constexpr uint8_t kSouthEast = 1 << 3;
+	static constexpr uint8_t kSouth = 1 << 4;
+	static constexpr uint8_t kSouthWest = 1 << 5;
+	static constexpr uint8_t kWest = 1 << 6;
+	static constexpr uint8_t kNorthWest = 1 << 7;
+	// ブロックでないタイルの variant
+	static constexpr uint8_t kNoVariant = 0xFF;
+
+	// map のブロックから全タイルを作り直す
+	void Build(const MapChipField& map, AutotileMode mode = AutotileMode::kFourNeighbor);
+	// 1 タイルの固さを変え、周り 3x3 の variant だけ更新する
+	void SetSolid(uint32_t xIndex, uint32_t yIndex, bool isSolid);
+
+	bool IsSolid(uint32_t xIndex, uint32_t yIndex) const;
+	// 8 近傍のマスク（ブロックでなければ 0）
+	uint8_t GetMask(uint32_t xIndex, uint32_t yIndex) const { return masks_[static_cast<size_t>(yIndex) * width_ + xIndex]; }
+	// タイルの種類（ブロックでなければ kNoVariant）
+	uint8_t GetVariant(uint32_t xIndex, uint32_t yIndex) const { return variants_[static_cast<size_t>(yIndex) * width_ + xIndex]; }
+
+	// マスク -> variant（mode ごとの表）
+	static uint8_t MaskToVariant(uint8_t mask, AutotileMode mode);
+	static uint32_t GetVariantCount(AutotileMode mode) { return mode == AutotileMode::kFourNeighbor ? 16 : 47; }
+
+	AutotileMode GetMode() const { return mode_; }
+	uint32_t GetWidth() const { return width_; }
+	uint32_t GetHeight() const { return height_; }
+
+private:
+	// 1 タイル分のマスクを隣を 1 つずつ見て求める（SetSolid 用）
+	uint8_t ComputeMask(uint32_t xIndex, uint32_t yIndex) const;
+	void UpdateTile(uint32_t xIndex, uint32_t yIndex);
+
+	AutotileMode mode_ = AutotileMode::kFourNeighbor;
+	uint32_t width_ = 0;
+	uint32_t height_ = 0;
+	uint32_t wordsPerRow_ = 0;
+	// 固さのビット（bit x % 64 がタイル x）。幅を超えたビットは 1（マップの外）
+	std::vector<uint64_t> solid_;
+	std::vector<uint8_t> masks_;
+	std::vector<uint8_t> variants_;
+};
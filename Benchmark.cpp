@@ -0,0 +1,1499 @@
+#include "Benchmark.h"
+#include "AgentSystem.h"
+#include "AllocTracker.h"
+#include "AssetCache.h"
+#include "Autotile.h"
+#include "CameraController.h"
+#include "ChunkMesh.h"
+#include "Delegate.h"
+#include "GameClock.h"
+#include "InstanceBatch.h"
+#include "Goal.h"
+#include "KamataEngine.h"
+#include "LatencyTracker.h"
+#include "MapChipField.h"
+#include "Player.h"
+#include "PlayerInput.h"
+#include "JobSystem.h"
+#include "ParticleSystem.h"
+#include "TimerWheel.h"
+#include "timer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+using namespace KamataEngine;
+
+namespace {
+	struct Result {
+		std::string name;
+		uint64_t iterations = 0; // 1 サンプルあたりの回数
+		uint32_t samples = 0;
+		double minNanoseconds = 0.0;
+		double medianNanoseconds = 0.0;
+		double meanNanoseconds = 0.0;
+	};
+
+	// 計測対象が最適化で消されないように結果を書き込む
+	volatile uint64_t gSink = 0;
+
+	constexpr double kTargetSampleNanoseconds = 50000000.0; // 1 サンプル 50ms
+	constexpr uint32_t kDefaultSampleCount = 7;
+
+	// body(n) は計測対象を n 回実行する。1 回あたりの時間を返す
+	Result Measure(const std::string& name, const std::function<void(uint64_t)>& body, uint32_t sampleCount = kDefaultSampleCount, uint64_t maxIterations = UINT64_MAX) {
+		using Clock = std::chrono::steady_clock;
+
+		// 1 サンプルが目標時間に届くまで回数を増やす（この間がウォームアップを兼ねる）
+		uint64_t iterations = 1;
+		for (;;) {
+			Clock::time_point start = Clock::now();
+			body(iterations);
+			double elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+			if (elapsed >= kTargetSampleNanoseconds || iterations >= maxIterations) {
+				break;
+			}
+			double scale = elapsed > 0.0 ? kTargetSampleNanoseconds / elapsed : 100.0;
+			scale = std::clamp(scale, 2.0, 100.0);
+			iterations = std::min(maxIterations, static_cast<uint64_t>(static_cast<double>(iterations) * scale));
+		}
+
+		std::vector<double> perOperation;
+		perOperation.reserve(sampleCount);
+		for (uint32_t i = 0; i < sampleCount; ++i) {
+			Clock::time_point start = Clock::now();
+			body(iterations);
+			double elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+			perOperation.push_back(elapsed / static_cast<double>(iterations));
+		}
+		std::sort(perOperation.begin(), perOperation.end());
+
+		Result result;
+		result.name = name;
+		result.iterations = iterations;
+		result.samples = sampleCount;
+		result.minNanoseconds = perOperation.front();
+		result.medianNanoseconds = perOperation[perOperation.size() / 2];
+		double total = 0.0;
+		for (double value : perOperation) {
+			total += value;
+		}
+		result.meanNanoseconds = total / static_cast<double>(perOperation.size());
+
+		printf("%-48s %14.1f ns/op (min %.1f, %llu iterations x %u)\n", name.c_str(), result.medianNanoseconds, result.minNanoseconds,
+		       static_cast<unsigned long long>(iterations), sampleCount);
+		return result;
+	}
+
+	// 外周を壁で囲み、内部にランダムなブロックを置いた width x height のマップを書き出す
+	bool WriteSyntheticMap(const std::filesystem::path& path, uint32_t width, uint32_t height, uint32_t seed) {
+		std::ofstream file(path);
+		if (!file.is_open()) {
+			return false;
+		}
+		std::mt19937 random(seed);
+		std::uniform_int_distribution<int> percent(0, 99);
+		std::string line;
+		line.reserve(static_cast<size_t>(width) * 3);
+		for (uint32_t y = 0; y < height; ++y) {
+			line.clear();
+			for (uint32_t x = 0; x < width; ++x) {
+				bool isBorder = x == 0 || y == 0 || x == width - 1 || y == height - 1;
+				bool isBlock = isBorder || percent(random) < 20;
+				if (x > 0) {
+					line += ',';
+				}
+				line += isBlock ? "0" : "-1";
+			}
+			line += '\n';
+			file << line;
+		}
+		return file.good();
+	}
+
+	bool WriteTextFile(const std::filesystem::path& path, const std::string& text) {
+		std::ofstream file(path);
+		file << text;
+		return file.good();
+	}
+
+	// rows は上の行から（CSV と同じ並び）。'#' = ブロック、'.' = 空白
+	std::string MakeCsv(const std::vector<std::string>& rows) {
+		std::string csv;
+		for (const std::string& row : rows) {
+			for (size_t x = 0; x < row.size(); ++x) {
+				if (x > 0) {
+					csv += ',';
+				}
+				csv += row[x] == '#' ? "0" : "-1";
+			}
+			csv += '\n';
+		}
+		return csv;
+	}
+
+	// オートタイルの検証用：隣を 1 つずつ見る素直な実装（マップの外はブロック）
+	uint8_t ComputeReferenceMask(const MapChipField& map, uint32_t x, uint32_t y) {
+		const int offsets[8][2] = {{0, -1}, {1, -1}, {1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}};
+		uint32_t mask = 0;
+		for (uint32_t n = 0; n < 8; ++n) {
+			int neighborX = static_cast<int>(x) + offsets[n][0];
+			int neighborY = static_cast<int>(y) + offsets[n][1];
+			bool isOutside = neighborX < 0 || neighborY < 0 || neighborX >= static_cast<int>(map.GetNumBlockHorizontal()) || neighborY >= static_cast<int>(map.GetNumBlockVertical());
+			if (isOutside || map.IsBlockAtIndex(static_cast<uint32_t>(neighborX), static_cast<uint32_t>(neighborY))) {
+				mask |= 1u << n;
+			}
+		}
+		return static_cast<uint8_t>(mask);
+	}
+
+	// autotile の全タイルを素直な実装と比べる。最初の食い違いを表示して false を返す
+	bool VerifyAutotile(const MapChipField& map, const AutotileMap& autotile, const std::string& name) {
+		for (uint32_t y = 0; y < map.GetNumBlockVertical(); ++y) {
+			for (uint32_t x = 0; x < map.GetNumBlockHorizontal(); ++x) {
+				bool isBlock = map.IsBlockAtIndex(x, y);
+				uint8_t expectedMask = isBlock ? ComputeReferenceMask(map, x, y) : 0;
+				uint8_t expectedVariant = isBlock ? AutotileMap::MaskToVariant(expectedMask, autotile.GetMode()) : AutotileMap::kNoVariant;
+				if (autotile.GetMask(x, y) != expectedMask || autotile.GetVariant(x, y) != expectedVariant) {
+					printf("Autotile %s: tile (%u, %u) mask %u variant %u, expected mask %u variant %u\n", name.c_str(), x, y, autotile.GetMask(x, y), autotile.GetVariant(x, y),
+					       expectedMask, expectedVariant);
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	// チャンクメッシュの検証：チャンクごとの面の数を、ブロックの隣を 1 つずつ見て数えた数と比べる。
+	// まとめた四角は並びの方向の texcoord がタイル数になるので、四角ごとの texcoord の最大値を足すと面の数になる。
+	// 頂点はチャンクの範囲（ワールド座標）の中、インデックスは頂点数未満であること
+	bool VerifyChunkMesh(const MapChipField& map, const ChunkMeshBaker& baker, const std::string& name) {
+		const int sides[4][2] = {{1, 0}, {-1, 0}, {0, -1}, {0, 1}};
+		for (uint32_t chunkY = 0; chunkY < baker.GetChunkCountY(); ++chunkY) {
+			for (uint32_t chunkX = 0; chunkX < baker.GetChunkCountX(); ++chunkX) {
+				const ChunkMesh& chunk = baker.GetChunk(chunkX, chunkY);
+				uint32_t expectedBlocks = 0;
+				uint32_t expectedFaces = 0;
+				for (uint32_t y = chunk.tiles.yBegin; y < chunk.tiles.yEnd; ++y) {
+					for (uint32_t x = chunk.tiles.xBegin; x < chunk.tiles.xEnd; ++x) {
+						if (!map.IsBlockAtIndex(x, y)) {
+							continue;
+						}
+						expectedBlocks++;
+						expectedFaces += 2; // 手前・奥
+						for (const int* side : sides) {
+							int neighborX = static_cast<int>(x) + side[0];
+							int neighborY = static_cast<int>(y) + side[1];
+							bool isOutside = neighborX < 0 || neighborY < 0 || neighborX >= static_cast<int>(map.GetNumBlockHorizontal()) || neighborY >= static_cast<int>(map.GetNumBlockVertical());
+							if (isOutside || !map.IsBlockAtIndex(static_cast<uint32_t>(neighborX), static_cast<uint32_t>(neighborY))) {
+								expectedFaces++;
+							}
+						}
+					}
+				}
+				float coveredFaces = 0.0f;
+				for (size_t quad = 0; quad + 4 <= chunk.vertices.size(); quad += 4) {
+					float span = 0.0f;
+					for (size_t corner = quad; corner < quad + 4; ++corner) {
+						span = std::max({span, chunk.vertices[corner].texcoord.x, chunk.vertices[corner].texcoord.y});
+					}
+					coveredFaces += span;
+				}
+				if (chunk.blockCount != expectedBlocks || chunk.vertices.size() % 4 != 0 || chunk.indices.size() != chunk.vertices.size() / 4 * 6 ||
+				    coveredFaces != static_cast<float>(expectedFaces)) {
+					printf("ChunkMesh %s: chunk (%u, %u) %u blocks %zu vertices %zu indices %.0f faces, expected %u blocks %u faces\n", name.c_str(), chunkX, chunkY, chunk.blockCount,
+					       chunk.vertices.size(), chunk.indices.size(), coveredFaces, expectedBlocks, expectedFaces);
+					return false;
+				}
+				const float top = static_cast<float>(map.GetNumBlockVertical() - chunk.tiles.yBegin) * MapChipField::kBlockHeight;
+				const float bottom = static_cast<float>(map.GetNumBlockVertical() - chunk.tiles.yEnd) * MapChipField::kBlockHeight;
+				const float left = static_cast<float>(chunk.tiles.xBegin) * MapChipField::kBlockWidth;
+				const float right = static_cast<float>(chunk.tiles.xEnd) * MapChipField::kBlockWidth;
+				for (const ChunkMeshVertex& vertex : chunk.vertices) {
+					if (vertex.position.x < left || vertex.position.x > right || vertex.position.y < bottom || vertex.position.y > top) {
+						printf("ChunkMesh %s: chunk (%u, %u) vertex (%.1f, %.1f) is outside the chunk\n", name.c_str(), chunkX, chunkY, vertex.position.x, vertex.position.y);
+						return false;
+					}
+				}
+				for (uint32_t index : chunk.indices) {
+					if (index >= chunk.vertices.size()) {
+						printf("ChunkMesh %s: chunk (%u, %u) index %u out of range\n", name.c_str(), chunkX, chunkY, index);
+						return false;
+					}
+				}
+			}
+		}
+		return true;
+	}
+
+	// 焼き直しを重ねた結果が、全体を焼いた結果と同じか
+	bool IsSameChunkMesh(const ChunkMeshBaker& baked, const ChunkMeshBaker& rebuilt) {
+		if (baked.GetChunkCountX() != rebuilt.GetChunkCountX() || baked.GetChunkCountY() != rebuilt.GetChunkCountY() || baked.GetTriangleCount() != rebuilt.GetTriangleCount() ||
+		    baked.GetVertexCount() != rebuilt.GetVertexCount() || baked.GetBlockCount() != rebuilt.GetBlockCount()) {
+			return false;
+		}
+		for (uint32_t chunkY = 0; chunkY < baked.GetChunkCountY(); ++chunkY) {
+			for (uint32_t chunkX = 0; chunkX < baked.GetChunkCountX(); ++chunkX) {
+				const ChunkMesh& a = baked.GetChunk(chunkX, chunkY);
+				const ChunkMesh& b = rebuilt.GetChunk(chunkX, chunkY);
+				if (a.vertices.size() != b.vertices.size() || a.indices != b.indices ||
+				    (!a.vertices.empty() && std::memcmp(a.vertices.data(), b.vertices.data(), a.vertices.size() * sizeof(ChunkMeshVertex)) != 0)) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	// 決まった時刻で LatchedInputSource を読む（tick の時刻を外から進める）
+	class TimedInputSource : public IPlayerInputSource {
+	public:
+		explicit TimedInputSource(LatchedInputSource& source) : source_(source) {}
+		void SetNow(int64_t now) { now_ = now; }
+		// true ならジャンプの押下時刻を捨てる（フレーム単位の入力と同じ扱い）
+		void SetAgeDiscarded(bool isDiscarded) { isAgeDiscarded_ = isDiscarded; }
+
+		PlayerInputState Poll() override {
+			PlayerInputState state = source_.PollAt(now_);
+			if (isAgeDiscarded_) {
+				state.jumpAge = 0.0f;
+			}
+			return state;
+		}
+
+	private:
+		LatchedInputSource& source_;
+		int64_t now_ = 0;
+		bool isAgeDiscarded_ = false;
+	};
+
+	// 遅延の集計（ナノ秒）を Result にする（iterations = 押下・フレームの数）
+	Result MakeLatencyResult(const std::string& name, std::vector<double> latencies, const char* unit = "presses") {
+		std::sort(latencies.begin(), latencies.end());
+		Result result;
+		result.name = name;
+		result.iterations = latencies.size();
+		result.samples = 1;
+		if (!latencies.empty()) {
+			double total = 0.0;
+			for (double value : latencies) {
+				total += value;
+			}
+			result.minNanoseconds = latencies.front();
+			result.medianNanoseconds = latencies[latencies.size() / 2];
+			result.meanNanoseconds = total / static_cast<double>(latencies.size());
+		}
+		printf("%-48s %14.1f ns mean (median %.1f, max %.1f, %zu %s)\n", name.c_str(), result.meanNanoseconds, result.medianNanoseconds, latencies.empty() ? 0.0 : latencies.back(),
+		       latencies.size(), unit);
+		return result;
+	}
+
+	// プレイヤーの 1 tick を計測する。resetTicks ごとにスポーンへ戻して状況を保つ
+	Result MeasurePlayerStep(const std::string& name, MapChipField& field, const Vector3& spawnPosition, std::vector<PlayerInputState> script, uint32_t resetTicks) {
+		ScriptedInputSource input(std::move(script));
+		Player player;
+		player.SetPlayerSize({1.0f, 1.0f, 1.0f});
+		player.SetMapChipField(&field);
+		player.SetInputSource(&input);
+		player.SetSpawnPosition(spawnPosition);
+		player.ResetToSpawn();
+
+		uint32_t tick = 0;
+		return Measure(name, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; ++i) {
+				if (++tick >= resetTicks) {
+					tick = 0;
+					player.ResetToSpawn();
+					input.Rewind();
+				}
+				player.Move();
+			}
+			gSink = gSink + static_cast<uint64_t>(player.GetTranslation().x * 1000.0f);
+		});
+	}
+
+	void WriteJsonString(std::ofstream& file, const std::string& text) {
+		file << '"';
+		for (char c : text) {
+			if (c == '"' || c == '\\') {
+				file << '\\';
+			}
+			file << c;
+		}
+		file << '"';
+	}
+}
+
+bool Benchmark::RunAll(const std::string& outputPath) {
+	namespace fs = std::filesystem;
+	std::vector<Result> results;
+
+	std::error_code error;
+	fs::path workDirectory = fs::temp_directory_path(error) / "mapchip_bench";
+	fs::create_directories(workDirectory, error);
+
+	// --- LoadMapChipCsv ---
+	std::vector<fs::path> mapFiles;
+	for (const fs::directory_entry& entry : fs::directory_iterator("Resources/map", error)) {
+		// levels.csv はレベル一覧（マニフェスト）なので対象外
+		if (entry.path().extension() == ".csv" && entry.path().filename() != "levels.csv") {
+			mapFiles.push_back(entry.path());
+		}
+	}
+	std::sort(mapFiles.begin(), mapFiles.end());
+	for (const fs::path& path : mapFiles) {
+		std::string pathString = path.generic_string();
+		results.push_back(Measure("LoadMapChipCsv/" + path.filename().string(), [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; ++i) {
+				MapChipField field;
+				field.LoadMapChipCsv(pathString);
+				gSink = gSink + field.GetNumBlockHorizontal();
+			}
+		}));
+	}
+
+	fs::path map1k = workDirectory / "synthetic_1024.csv";
+	fs::path map4k = workDirectory / "synthetic_4096.csv";
+	WriteSyntheticMap(map1k, 1024, 1024, 1);
+	WriteSyntheticMap(map4k, 4096, 4096, 2);
+	results.push_back(Measure("LoadMapChipCsv/synthetic_1024x1024", [&](uint64_t iterations) {
+		for (uint64_t i = 0; i < iterations; ++i) {
+			MapChipField field;
+			field.LoadMapChipCsv(map1k.string());
+			gSink = gSink + field.GetNumBlockHorizontal();
+		}
+	}, 3));
+	results.push_back(Measure("LoadMapChipCsv/synthetic_4096x4096", [&](uint64_t iterations) {
+		for (uint64_t i = 0; i < iterations; ++i) {
+			MapChipField field;
+			field.LoadMapChipCsv(map4k.string());
+			gSink = gSink + field.GetNumBlockHorizontal();
+		}
+	}, 2, 1));
+
+	// --- オートタイル：出荷マップの結果の検証と、4096x4096 の全体構築・1 タイルの変更 ---
+	bool isAutotileCorrect = true;
+	{
+		const AutotileMode modes[] = {AutotileMode::kFourNeighbor, AutotileMode::kEightNeighbor};
+		for (const fs::path& path : mapFiles) {
+			MapChipField map;
+			map.LoadMapChipCsv(path.generic_string());
+			for (AutotileMode mode : modes) {
+				AutotileMap autotile;
+				autotile.Build(map, mode);
+				isAutotileCorrect = VerifyAutotile(map, autotile, path.filename().string()) && isAutotileCorrect;
+			}
+
+			// level1 の代表的なタイル（4 近傍。上 1・右 2・下 4・左 8）
+			if (path.filename() == "level1.csv") {
+				struct ExpectedTile {
+					uint32_t x;
+					uint32_t y;
+					uint8_t variant;
+				};
+				const ExpectedTile expectedTiles[] = {
+				    {0, 0, 15},  // 左上の角（マップの外はブロック）
+				    {3, 20, 14}, // 床の表面（上が空いている）
+				    {7, 7, 13},  // 右が空いた壁
+				    {8, 6, 11},  // 下が空いた天井
+				    {10, 17, 2}, // 2 マスの足場の左端
+				    {11, 17, 8}, // 2 マスの足場の右端
+				    {19, 15, 0}, // 浮いた 1 マス
+				};
+				AutotileMap autotile;
+				autotile.Build(map);
+				for (const ExpectedTile& expected : expectedTiles) {
+					if (autotile.GetVariant(expected.x, expected.y) != expected.variant) {
+						printf("Autotile level1.csv: tile (%u, %u) variant %u, expected %u\n", expected.x, expected.y, autotile.GetVariant(expected.x, expected.y), expected.variant);
+						isAutotileCorrect = false;
+					}
+				}
+			}
+		}
+
+		// 8 近傍は 47 種類
+		uint32_t maxVariant = 0;
+		for (uint32_t mask = 0; mask < 256; ++mask) {
+			maxVariant = std::max<uint32_t>(maxVariant, AutotileMap::MaskToVariant(static_cast<uint8_t>(mask), AutotileMode::kEightNeighbor));
+		}
+		if (maxVariant + 1 != AutotileMap::GetVariantCount(AutotileMode::kEightNeighbor)) {
+			printf("Autotile: %u 8-neighbor variants, expected %u\n", maxVariant + 1, AutotileMap::GetVariantCount(AutotileMode::kEightNeighbor));
+			isAutotileCorrect = false;
+		}
+
+		MapChipField map;
+		map.LoadMapChipCsv(map4k.string());
+		for (AutotileMode mode : modes) {
+			AutotileMap autotile;
+			results.push_back(Measure(mode == AutotileMode::kFourNeighbor ? "Autotile/4096x4096/4-neighbor" : "Autotile/4096x4096/8-neighbor", [&](uint64_t iterations) {
+				for (uint64_t i = 0; i < iterations; ++i) {
+					autotile.Build(map, mode);
+				}
+				gSink = gSink + autotile.GetVariant(1, 1);
+			}, 3));
+		}
+		// 比較用：タイルごとに隣を 1 つずつ見る
+		std::vector<uint8_t> referenceMasks(static_cast<size_t>(map.GetNumBlockHorizontal()) * map.GetNumBlockVertical());
+		results.push_back(Measure("AutotileReference/4096x4096", [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; ++i) {
+				for (uint32_t y = 0; y < map.GetNumBlockVertical(); ++y) {
+					for (uint32_t x = 0; x < map.GetNumBlockHorizontal(); ++x) {
+						referenceMasks[static_cast<size_t>(y) * map.GetNumBlockHorizontal() + x] = map.IsBlockAtIndex(x, y) ? ComputeReferenceMask(map, x, y) : 0;
+					}
+				}
+			}
+			gSink = gSink + referenceMasks[1];
+		}, 2, 1));
+
+		// 1 タイルずつの変更（ホットリロード・編集）。変更後も全体を作り直した結果と一致すること
+		AutotileMap autotile;
+		autotile.Build(map);
+		std::mt19937 random(5);
+		std::uniform_int_distribution<uint32_t> randomX(0, map.GetNumBlockHorizontal() - 1);
+		std::uniform_int_distribution<uint32_t> randomY(0, map.GetNumBlockVertical() - 1);
+		results.push_back(Measure("AutotileSetSolid/4096x4096", [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; ++i) {
+				uint32_t x = randomX(random);
+				uint32_t y = randomY(random);
+				bool isSolid = !autotile.IsSolid(x, y);
+				map.SetMapChipTypeByIndex(x, y, isSolid ? MapChipType::kBlock : MapChipType::kBlank);
+				autotile.SetSolid(x, y, isSolid);
+			}
+			gSink = gSink + autotile.GetVariant(1, 1);
+		}));
+		isAutotileCorrect = VerifyAutotile(map, autotile, "synthetic_4096x4096 after SetSolid") && isAutotileCorrect;
+	}
+
+	// --- チャンクメッシュ：出荷マップの面の数の検証、焼き時間、1 タイル変更の焼き直し ---
+	bool isChunkMeshCorrect = true;
+	{
+		for (const fs::path& path : mapFiles) {
+			MapChipField map;
+			map.LoadMapChipCsv(path.generic_string());
+			AutotileMap autotile;
+			autotile.Build(map);
+			ChunkMeshBaker baker;
+			baker.Build(map, &autotile);
+			isChunkMeshCorrect = VerifyChunkMesh(map, baker, path.filename().string()) && isChunkMeshCorrect;
+			// ブロックを 1 つずつ描く場合との比較（描画回数・三角形数）
+			printf("ChunkMesh %s: %u blocks -> %u draws, %llu tris (%llu as cubes), %llu vertices (%llu as cubes)\n", path.filename().string().c_str(), baker.GetBlockCount(),
+			       baker.GetNonEmptyChunkCount(), static_cast<unsigned long long>(baker.GetTriangleCount()),
+			       static_cast<unsigned long long>(baker.GetBlockCount()) * ChunkMeshBaker::kCubeTriangleCount, static_cast<unsigned long long>(baker.GetVertexCount()),
+			       static_cast<unsigned long long>(baker.GetBlockCount()) * ChunkMeshBaker::kCubeVertexCount);
+			if (path.filename() == "level1.csv") {
+				results.push_back(Measure("ChunkMeshBuild/level1.csv", [&](uint64_t iterations) {
+					for (uint64_t i = 0; i < iterations; ++i) {
+						baker.Build(map, &autotile);
+					}
+					gSink = gSink + baker.GetTriangleCount();
+				}));
+			}
+		}
+
+		// 256x256（20% のランダム配置は面の多い側の例）
+		fs::path map256 = workDirectory / "synthetic_256.csv";
+		WriteSyntheticMap(map256, 256, 256, 3);
+		MapChipField map;
+		map.LoadMapChipCsv(map256.string());
+		AutotileMap autotile;
+		autotile.Build(map);
+		ChunkMeshBaker baker;
+		results.push_back(Measure("ChunkMeshBuild/256x256", [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; ++i) {
+				baker.Build(map, &autotile);
+			}
+			gSink = gSink + baker.GetTriangleCount();
+		}, 3));
+		isChunkMeshCorrect = VerifyChunkMesh(map, baker, "synthetic_256x256") && isChunkMeshCorrect;
+
+		// 1 タイルずつの変更：周りのチャンクだけ焼き直す。最後に全体を焼いた結果と比べる
+		std::mt19937 random(7);
+		std::uniform_int_distribution<uint32_t> randomIndex(0, 255);
+		results.push_back(Measure("ChunkMeshRebake/256x256", [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; ++i) {
+				uint32_t x = randomIndex(random);
+				uint32_t y = randomIndex(random);
+				bool isSolid = !map.IsBlockAtIndex(x, y);
+				map.SetMapChipTypeByIndex(x, y, isSolid ? MapChipType::kBlock : MapChipType::kBlank);
+				autotile.SetSolid(x, y, isSolid);
+				baker.MarkTileChanged(x, y);
+				gSink = gSink + baker.BakeDirty(map, &autotile);
+			}
+		}));
+		ChunkMeshBaker rebuilt;
+		rebuilt.Build(map, &autotile);
+		if (!IsSameChunkMesh(baker, rebuilt)) {
+			printf("ChunkMesh synthetic_256x256: incremental rebakes differ from a full build\n");
+			isChunkMeshCorrect = false;
+		}
+		isChunkMeshCorrect = VerifyChunkMesh(map, baker, "synthetic_256x256 after rebakes") && isChunkMeshCorrect;
+	}
+
+	// --- 衝突判定（1024x1024 のマップ上のランダムな位置） ---
+	MapChipField field;
+	field.LoadMapChipCsv(map1k.string());
+	const Vector3 playerSize = {1.0f, 1.0f, 1.0f};
+	std::vector<Vector3> positions(4096);
+	{
+		std::mt19937 random(3);
+		float mapWidth = static_cast<float>(field.GetNumBlockHorizontal()) * MapChipField::kBlockWidth;
+		float mapHeight = static_cast<float>(field.GetNumBlockVertical()) * MapChipField::kBlockHeight;
+		std::uniform_real_distribution<float> randomX(0.0f, mapWidth);
+		std::uniform_real_distribution<float> randomY(0.0f, mapHeight);
+		for (Vector3& position : positions) {
+			position = {randomX(random), randomY(random), 0.0f};
+		}
+	}
+	size_t positionMask = positions.size() - 1;
+
+	results.push_back(Measure("CheckCollision/1024x1024", [&](uint64_t iterations) {
+		uint64_t hits = 0;
+		for (uint64_t i = 0; i < iterations; ++i) {
+			hits += field.CheckCollision(field.GetPlayerRect(positions[i & positionMask], playerSize)) ? 1 : 0;
+		}
+		gSink = gSink + hits;
+	}));
+	const float blockScales[] = {1.0f, 0.5f, 0.1f};
+	for (float blockScale : blockScales) {
+		char name[64];
+		snprintf(name, sizeof(name), "CheckScaledCollision/1024x1024/scale_%.2f", blockScale);
+		results.push_back(Measure(name, [&](uint64_t iterations) {
+			uint64_t hits = 0;
+			for (uint64_t i = 0; i < iterations; ++i) {
+				hits += field.CheckScaledCollision(field.GetPlayerRect(positions[i & positionMask], playerSize), blockScale) ? 1 : 0;
+			}
+			gSink = gSink + hits;
+		}));
+	}
+	results.push_back(Measure("GetCollidingBlocks/1024x1024", [&](uint64_t iterations) {
+		uint64_t count = 0;
+		for (uint64_t i = 0; i < iterations; ++i) {
+			count += field.GetCollidingBlocks(positions[i & positionMask], playerSize).size();
+		}
+		gSink = gSink + count;
+	}));
+
+	// --- Player の 1 tick ---
+	{
+		// 平らな床を右へ走る
+		std::vector<std::string> groundRows(8, std::string(40, '.'));
+		groundRows.back() = std::string(40, '#');
+		fs::path groundPath = workDirectory / "ground.csv";
+		WriteTextFile(groundPath, MakeCsv(groundRows));
+		MapChipField groundField;
+		groundField.LoadMapChipCsv(groundPath.string());
+		results.push_back(MeasurePlayerStep("PlayerStep/ground_run", groundField, groundField.GetMapChipPositionByIndex(1, 6), {{false, true, false}}, 120));
+
+		// 縦穴：右の壁に押し付けて滑り落ちる / 壁ジャンプを繰り返す
+		std::vector<std::string> shaftRows(30, "#......#");
+		shaftRows.back() = "########";
+		fs::path shaftPath = workDirectory / "shaft.csv";
+		WriteTextFile(shaftPath, MakeCsv(shaftRows));
+		MapChipField shaftField;
+		shaftField.LoadMapChipCsv(shaftPath.string());
+		Vector3 shaftSpawn = shaftField.GetMapChipPositionByIndex(6, 2);
+		results.push_back(MeasurePlayerStep("PlayerStep/wall_slide", shaftField, shaftSpawn, {{false, true, false}}, 120));
+
+		std::vector<PlayerInputState> wallJumpScript(10, PlayerInputState{false, true, false});
+		wallJumpScript.back().jumpTriggered = true;
+		results.push_back(MeasurePlayerStep("PlayerStep/wall_jump", shaftField, shaftSpawn, wallJumpScript, 240));
+	}
+
+	// --- カメラの追従がフレームレートに依存しないこと ---
+	// 同じプレイヤーの軌跡（走る・跳ぶ・止まる・戻る）を 30 ~ 360Hz で CameraController::Update(dt) に流し、1/6 秒ごとの位置を比べる。
+	// 差は主に目標を読む時刻の違い（30Hz では 1 フレームで 0.5 進む）なので、許容はブロックの 15%
+	bool isCameraRateIndependent = true;
+	{
+		constexpr float kDuration = 6.0f;
+		constexpr float kSampleInterval = 1.0f / 6.0f;
+		const float tolerance = MapChipField::kBlockWidth * 0.15f;
+		const float ticksPerSecond = static_cast<float>(GameClock::kTicksPerSecond);
+		// 時刻 t の位置と速度（秒単位）
+		auto trajectory = [](float t, Vector3& position, Vector2& velocity) {
+			auto jump = [](float t, float begin, float& y, float& vy) {
+				const float s = t - begin;
+				if (s >= 0.0f && s < 0.8f) {
+					y = 20.0f * s - 25.0f * s * s;
+					vy = 20.0f - 50.0f * s;
+				}
+			};
+			position = {0.0f, 0.0f, 0.0f};
+			velocity = {0.0f, 0.0f};
+			if (t < 2.0f) {
+				position.x = 15.0f * t;
+				velocity.x = 15.0f;
+			} else if (t < 3.0f) {
+				position.x = 30.0f;
+			} else if (t < 5.0f) {
+				position.x = 30.0f - 10.0f * (t - 3.0f);
+				velocity.x = -10.0f;
+			} else {
+				position.x = 10.0f;
+			}
+			jump(t, 0.5f, position.y, velocity.y);
+			jump(t, 3.5f, position.y, velocity.y);
+		};
+		// cameraDeltaTime が負ならフレームの時間を渡す
+		auto runCamera = [&](uint32_t rate, float cameraDeltaTime) {
+			Player player;
+			CameraController camera;
+			camera.Initialize();
+			camera.SetTarget(&player);
+			camera.SetInitialPosition({0.0f, 0.0f, -50.0f});
+			const float deltaTime = 1.0f / static_cast<float>(rate);
+			const uint32_t framesPerSample = static_cast<uint32_t>(std::lround(kSampleInterval * static_cast<float>(rate)));
+			const uint32_t frameCount = static_cast<uint32_t>(std::lround(kDuration * static_cast<float>(rate)));
+			std::vector<Vector3> path;
+			for (uint32_t frame = 1; frame <= frameCount; ++frame) {
+				Vector3 position;
+				Vector2 velocity;
+				trajectory(static_cast<float>(frame) * deltaTime, position, velocity);
+				player.SetState(position, {velocity.x / ticksPerSecond, velocity.y / ticksPerSecond});
+				camera.Update(cameraDeltaTime < 0.0f ? deltaTime : cameraDeltaTime);
+				if (frame % framesPerSample == 0) {
+					path.push_back(camera.GetCamera().translation_);
+				}
+			}
+			return path;
+		};
+
+		const uint32_t rates[] = {30, 60, 144, 240, 360};
+		const std::vector<Vector3> reference = runCamera(360, -1.0f);
+		auto maxDeviationFromReference = [&](const std::vector<Vector3>& path) {
+			float maxDeviation = path.size() == reference.size() ? 0.0f : 1.0e9f;
+			for (size_t i = 0; i < path.size() && i < reference.size(); ++i) {
+				maxDeviation = std::max({maxDeviation, std::fabs(path[i].x - reference[i].x), std::fabs(path[i].y - reference[i].y)});
+			}
+			return maxDeviation;
+		};
+		for (uint32_t rate : rates) {
+			const float maxDeviation = maxDeviationFromReference(runCamera(rate, -1.0f));
+			printf("CameraPath/%uHz: max deviation from 360Hz %.4f (tolerance %.2f)\n", rate, maxDeviation, tolerance);
+			if (!(maxDeviation <= tolerance)) {
+				isCameraRateIndependent = false;
+			}
+		}
+		// 経過時間を無視して毎フレーム 1 tick 分進めると、この比較で外れること（比較が甘すぎないか）
+		const float fixedStepDeviation = maxDeviationFromReference(runCamera(144, GameClock::kFixedDeltaTime));
+		printf("CameraPath/144Hz ignoring dt: max deviation %.4f\n", fixedStepDeviation);
+		if (fixedStepDeviation <= tolerance) {
+			isCameraRateIndependent = false;
+		}
+	}
+
+	// --- 時刻付きの入力イベント ---
+	bool isInputCorrect = true;
+	{
+		constexpr int64_t kTickNanoseconds = 16666667;
+		constexpr int64_t kBaseTimestamp = 1000000000; // 0 は「まだ Poll していない」なので避ける
+		constexpr uint32_t kPressCount = 2000;
+
+		// 押下 → シミュレーションが受け取るまで。描画フレームごとに Latch する場合と、1ms ごとに読むイベント源（PushEvent）の場合。
+		// 描画フレームと tick は同じ 60Hz で位相がずれている（スレッド分離モードと同じ）
+		{
+			std::mt19937 random(11);
+			std::uniform_int_distribution<int64_t> offset(0, kTickNanoseconds * 4);
+			std::vector<int64_t> presses;
+			int64_t pressTime = kBaseTimestamp;
+			for (uint32_t i = 0; i < kPressCount; ++i) {
+				pressTime += kTickNanoseconds * 3 + offset(random);
+				presses.push_back(pressTime);
+			}
+			const int64_t framePhase = kTickNanoseconds * 3 / 7;
+			const int64_t samplerPeriod = 1000000;
+
+			LatchedInputSource frameSource;
+			LatchedInputSource eventSource;
+			std::vector<double> frameLatencies;
+			std::vector<double> eventLatencies;
+			std::vector<double> frameTimeErrors;
+			std::vector<double> eventTimeErrors;
+			size_t nextFramePress = 0;
+			size_t nextEventPress = 0;
+			size_t frameConsumed = 0;
+			size_t eventConsumed = 0;
+			int64_t nextFrame = kBaseTimestamp + framePhase;
+			for (int64_t now = kBaseTimestamp + kTickNanoseconds; frameConsumed < presses.size() || eventConsumed < presses.size(); now += kTickNanoseconds) {
+				// この tick までに描画フレームが Latch した入力
+				for (; nextFrame <= now; nextFrame += kTickNanoseconds) {
+					PlayerInputState state;
+					for (; nextFramePress < presses.size() && presses[nextFramePress] <= nextFrame; ++nextFramePress) {
+						state.jumpTriggered = true;
+					}
+					frameSource.Latch(state, nextFrame);
+				}
+				// 1ms ごとのサンプラーが読んだ時刻で積んだイベント
+				for (; nextEventPress < presses.size(); ++nextEventPress) {
+					int64_t sampled = (presses[nextEventPress] + samplerPeriod - 1) / samplerPeriod * samplerPeriod;
+					if (sampled > now) {
+						break;
+					}
+					eventSource.PushEvent({sampled, InputAction::kJump, true});
+				}
+
+				PlayerInputState frameState = frameSource.PollAt(now);
+				if (frameState.jumpTriggered && frameConsumed < presses.size()) {
+					frameLatencies.push_back(static_cast<double>(now - presses[frameConsumed]));
+					frameTimeErrors.push_back(std::fabs(static_cast<double>(now - presses[frameConsumed]) - static_cast<double>(frameState.jumpAge) * 1.0e9));
+					frameConsumed++;
+				}
+				PlayerInputState eventState = eventSource.PollAt(now);
+				if (eventState.jumpTriggered && eventConsumed < presses.size()) {
+					eventLatencies.push_back(static_cast<double>(now - presses[eventConsumed]));
+					eventTimeErrors.push_back(std::fabs(static_cast<double>(now - presses[eventConsumed]) - static_cast<double>(eventState.jumpAge) * 1.0e9));
+					eventConsumed++;
+				}
+			}
+			Result frameLatency = MakeLatencyResult("InputLatency/frame_latched", frameLatencies);
+			Result eventLatency = MakeLatencyResult("InputLatency/sampled_events", eventLatencies);
+			Result frameTimeError = MakeLatencyResult("InputPressTimeError/frame_latched", frameTimeErrors);
+			Result eventTimeError = MakeLatencyResult("InputPressTimeError/sampled_events", eventTimeErrors);
+			// イベント源のほうが早く届き、押した時刻の誤差はサンプラーの周期（+ float の丸め）以内
+			if (eventLatency.meanNanoseconds >= frameLatency.meanNanoseconds || eventTimeErrors.empty() || eventTimeErrors.back() > static_cast<double>(samplerPeriod) + 1000.0) {
+				printf("InputLatency: events are not faster or more precise than frame latching\n");
+				isInputCorrect = false;
+			}
+			if (frameSource.GetDroppedEventCount() + eventSource.GetDroppedEventCount() > 0) {
+				printf("InputLatency: dropped events\n");
+				isInputCorrect = false;
+			}
+			results.push_back(frameLatency);
+			results.push_back(eventLatency);
+			results.push_back(frameTimeError);
+			results.push_back(eventTimeError);
+		}
+
+		// ジャンプの先行入力：着地の tick で「押してから jumpBufferTime 以内」かどうかを押した時刻で判断する
+		{
+			std::vector<std::string> rows(12, std::string(12, '.'));
+			rows.back() = std::string(12, '#');
+			fs::path dropPath = workDirectory / "drop.csv";
+			WriteTextFile(dropPath, MakeCsv(rows));
+			MapChipField dropField;
+			dropField.LoadMapChipCsv(dropPath.string());
+			const Vector3 dropSpawn = dropField.GetMapChipPositionByIndex(5, 1);
+
+			// pressTime に 1 回ジャンプを押して落下し、跳んだ tick を返す（跳ばなければ 0）
+			auto runDrop = [&](int64_t pressTime, bool isAgeDiscarded) -> uint32_t {
+				LatchedInputSource source;
+				TimedInputSource input(source);
+				input.SetAgeDiscarded(isAgeDiscarded);
+				source.PushEvent({pressTime, InputAction::kJump, true});
+				Player player;
+				player.SetPlayerSize({1.0f, 1.0f, 1.0f});
+				player.SetMapChipField(&dropField);
+				player.SetInputSource(&input);
+				player.SetSpawnPosition(dropSpawn);
+				player.ResetToSpawn();
+				for (uint32_t tick = 1; tick < 600; ++tick) {
+					input.SetNow(kBaseTimestamp + static_cast<int64_t>(tick) * kTickNanoseconds);
+					player.Move();
+					if (player.GetVelocity().y > 0.0f) {
+						return tick;
+					}
+				}
+				return 0;
+			};
+			auto tickTime = [&](uint32_t tick) { return kBaseTimestamp + static_cast<int64_t>(tick) * kTickNanoseconds; };
+			// 接地して最初に跳べる tick（その tick の時刻に押すとすぐ跳ぶ最初の tick）
+			uint32_t groundedTick = 0;
+			for (uint32_t tick = 1; tick < 600 && groundedTick == 0; ++tick) {
+				groundedTick = runDrop(tickTime(tick), false) == tick ? tick : 0;
+			}
+			const int64_t decisionTime = tickTime(groundedTick);
+			const int64_t bufferNanoseconds = 100000000; // Player の jumpBufferTime
+			uint32_t eventMismatches = 0;
+			uint32_t frameMismatches = 0;
+			const int64_t offsets[] = {-12000000, -7000000, -2000000, 2000000, 7000000, 12000000};
+			for (int64_t offset : offsets) {
+				int64_t pressTime = decisionTime - bufferNanoseconds + offset;
+				bool isExpected = decisionTime - pressTime < bufferNanoseconds;
+				eventMismatches += (runDrop(pressTime, false) == groundedTick) != isExpected ? 1 : 0;
+				frameMismatches += (runDrop(pressTime, true) == groundedTick) != isExpected ? 1 : 0;
+			}
+			printf("JumpBuffer: grounded at tick %u, %u/%zu presses decided wrongly with press times, %u/%zu with tick times\n", groundedTick, eventMismatches, std::size(offsets),
+			       frameMismatches, std::size(offsets));
+			if (groundedTick == 0 || eventMismatches > 0) {
+				isInputCorrect = false;
+			}
+		}
+	}
+
+	// --- 入力 → Present の遅れ（スレッド分離モードの流れを偽の時計と FakeFramePresenter で回す） ---
+	bool isLatencyCorrect = true;
+	{
+		constexpr int64_t kFrameNanoseconds = 16666667;
+		constexpr int64_t kBaseTimestamp = 1000000000;
+		constexpr uint32_t kFrameCount = 3600;
+		// 60Hz の描画フレームで入力を Latch し、位相のずれた 60Hz の tick で取り込んで公開、次の描画フレームで描いて Present する
+		// extraPresentNanoseconds は Present の前に余計に待つ時間（フレームを 1 枚余計に溜めるなどの悪化を模す）
+		auto runPipeline = [&](int64_t extraPresentNanoseconds, LatencyTracker& tracker, std::vector<double>& totals) {
+			std::mt19937 random(23);
+			std::uniform_int_distribution<int64_t> updateCost(1000000, 4000000);
+			LatchedInputSource source;
+			FakeFramePresenter presenter;
+			presenter.SetSubmitNanoseconds(1000000 + extraPresentNanoseconds);
+			const int64_t tickPhase = kFrameNanoseconds * 5 / 9;
+			const int64_t drawNanoseconds = 3000000;
+
+			LatencySample published; // トリプルバッファの最新（公開順に上書き）
+			uint64_t publishedTick = 0;
+			uint64_t acquiredTick = 0;
+			int64_t nextTick = kBaseTimestamp + tickPhase;
+			for (uint32_t frame = 1; frame <= kFrameCount; ++frame) {
+				const int64_t frameTime = kBaseTimestamp + static_cast<int64_t>(frame) * kFrameNanoseconds;
+				// このフレームまでに終わった tick
+				for (; nextTick + updateCost.max() <= frameTime; nextTick += kFrameNanoseconds) {
+					source.PollAt(nextTick);
+					published.inputTimestamp = source.GetPolledTimestamp() != 0 ? source.GetPolledTimestamp() : nextTick;
+					published.consumeTimestamp = source.GetLastPollTimestamp();
+					published.publishTimestamp = nextTick + updateCost(random);
+					publishedTick++;
+				}
+				PlayerInputState state;
+				state.right = frame % 90 < 45;
+				state.jumpTriggered = frame % 37 == 0;
+				source.Latch(state, frameTime);
+				if (publishedTick == acquiredTick) {
+					continue;
+				}
+				acquiredTick = publishedTick;
+				LatencySample sample = published;
+				presenter.SetNow(frameTime + drawNanoseconds);
+				sample.presentTimestamp = presenter.Present();
+				tracker.Record(sample);
+				totals.push_back(static_cast<double>(sample.presentTimestamp - sample.inputTimestamp));
+			}
+		};
+
+		LatencyTracker baseline;
+		LatencyTracker regressed;
+		std::vector<double> baselineTotals;
+		std::vector<double> regressedTotals;
+		runPipeline(0, baseline, baselineTotals);
+		runPipeline(kFrameNanoseconds, regressed, regressedTotals);
+		results.push_back(MakeLatencyResult("InputToPresent/fake_presenter", baselineTotals, "frames"));
+		results.push_back(MakeLatencyResult("InputToPresent/fake_presenter_extra_frame", regressedTotals, "frames"));
+		for (uint32_t stage = 0; stage < static_cast<uint32_t>(LatencyStage::kCount); ++stage) {
+			const LatencyHistogram& histogram = baseline.GetHistogram(static_cast<LatencyStage>(stage));
+			printf("Latency %-20s avg %6.2f ms, p50 %6.2f ms, p99 %6.2f ms, max %6.2f ms\n", LatencyTracker::GetStageName(static_cast<LatencyStage>(stage)),
+			       histogram.GetMeanMilliseconds(), histogram.GetPercentileMilliseconds(0.5), histogram.GetPercentileMilliseconds(0.99), histogram.GetMaxMilliseconds());
+		}
+
+		// 全フレームが数えられ、区間の和が全体と合う
+		const LatencyHistogram& total = baseline.GetHistogram(LatencyStage::kInputToPresent);
+		float stageMeanSum = 0.0f;
+		for (uint32_t stage = 0; stage < static_cast<uint32_t>(LatencyStage::kInputToPresent); ++stage) {
+			stageMeanSum += baseline.GetHistogram(static_cast<LatencyStage>(stage)).GetMeanMilliseconds();
+		}
+		if (baseline.GetInvalidCount() > 0 || baseline.GetRecordedCount() != baselineTotals.size() || baseline.GetRecordedCount() < kFrameCount * 9 / 10 ||
+		    std::fabs(stageMeanSum - total.GetMeanMilliseconds()) > 0.01f) {
+			printf("Latency: %llu frames recorded, %llu invalid, stage sum %.3f ms vs total %.3f ms\n", static_cast<unsigned long long>(baseline.GetRecordedCount()),
+			       static_cast<unsigned long long>(baseline.GetInvalidCount()), stageMeanSum, total.GetMeanMilliseconds());
+			isLatencyCorrect = false;
+		}
+		// 予算：入力から Present まで 3 フレーム以内。フレームを 1 枚余計に溜めたら p99 が 1 フレーム近く悪化したと分かること
+		const float budgetMilliseconds = 3.0f * static_cast<float>(kFrameNanoseconds) * 1.0e-6f;
+		const float baselineP99 = total.GetPercentileMilliseconds(0.99);
+		const float regressedP99 = regressed.GetHistogram(LatencyStage::kInputToPresent).GetPercentileMilliseconds(0.99);
+		printf("Latency: input -> present p99 %.2f ms (budget %.2f ms), with an extra queued frame %.2f ms\n", baselineP99, budgetMilliseconds, regressedP99);
+		if (baselineP99 > budgetMilliseconds || regressedP99 - baselineP99 < static_cast<float>(kFrameNanoseconds) * 1.0e-6f * 0.9f) {
+			printf("Latency: regression gate failed\n");
+			isLatencyCorrect = false;
+		}
+
+		// CSV：ヘッダー + バケツ 1 行ずつ、全体の列の合計がフレーム数
+		fs::path csvPath = workDirectory / "latency.csv";
+		uint64_t csvTotal = 0;
+		uint32_t csvRows = 0;
+		if (baseline.WriteCsv(csvPath.string())) {
+			std::ifstream csv(csvPath);
+			std::string line;
+			std::getline(csv, line);
+			while (std::getline(csv, line)) {
+				csvRows++;
+				csvTotal += std::strtoull(line.c_str() + line.rfind(',') + 1, nullptr, 10);
+			}
+		}
+		if (csvRows != LatencyHistogram::kBucketCount || csvTotal != baseline.GetRecordedCount()) {
+			printf("Latency: CSV has %u rows and %llu frames\n", csvRows, static_cast<unsigned long long>(csvTotal));
+			isLatencyCorrect = false;
+		}
+	}
+
+	// --- 敵 10000 体の 1 tick（段々の床と柱のあるマップ） ---
+	bool isAgentStepWithinBudget = true;
+	{
+		constexpr uint32_t kWidth = 512;
+		constexpr uint32_t kHeight = 64;
+		constexpr uint32_t kAgentCount = 10000;
+		std::vector<std::string> rows(kHeight, std::string(kWidth, '.'));
+		for (uint32_t y = 0; y < kHeight; ++y) {
+			rows[y].front() = '#';
+			rows[y].back() = '#';
+			if (y % 8 == 7) {
+				// 8 行ごとに床。ところどころ穴を空けて落ちる敵も混ぜる
+				for (uint32_t x = 0; x < kWidth; ++x) {
+					rows[y][x] = x % 32 < 29 ? '#' : '.';
+				}
+			} else if (y % 8 == 6) {
+				for (uint32_t x = 16; x < kWidth; x += 48) {
+					rows[y][x] = '#';
+				}
+			}
+		}
+		rows.back() = std::string(kWidth, '#');
+		fs::path agentMapPath = workDirectory / "agents.csv";
+		WriteTextFile(agentMapPath, MakeCsv(rows));
+		MapChipField agentField;
+		agentField.LoadMapChipCsv(agentMapPath.string());
+
+		AgentSystem agents;
+		agents.Reserve(kAgentCount);
+		std::mt19937 random(7);
+		std::uniform_int_distribution<uint32_t> column(1, kWidth - 2);
+		std::uniform_int_distribution<uint32_t> floorIndex(0, kHeight / 8 - 1);
+		for (uint32_t i = 0; i < kAgentCount; ++i) {
+			// 床のすぐ上の行に置く
+			Vector3 position = agentField.GetMapChipPositionByIndex(column(random), floorIndex(random) * 8 + 5);
+			agents.Spawn(static_cast<AgentKind>(i % 3), position);
+		}
+
+		Vector3 playerSize = {1.0f, 1.0f, 1.0f};
+		uint32_t tick = 0;
+		Result agentResult = Measure("AgentStep/10000", [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; ++i) {
+				// プレイヤーはマップの中を左右に往復する
+				if (++tick >= 600) {
+					tick = 0;
+					agents.Reset();
+				}
+				Vector3 playerPosition = agentField.GetMapChipPositionByIndex(1 + (tick % (kWidth - 2)), 29);
+				agents.Update(agentField, playerPosition);
+				gSink = gSink + agents.FindOverlap(playerPosition, playerSize);
+			}
+		});
+		// 1 コアで 60 Hz に収まること（1 tick の中央値が固定 tick の時間以内）
+		const double budgetNanoseconds = static_cast<double>(GameClock::kFixedDeltaTime) * 1.0e9;
+		isAgentStepWithinBudget = agentResult.medianNanoseconds < budgetNanoseconds;
+		printf("AgentStep/10000: %.3f ms/tick (%s the %.1f ms frame budget)\n", agentResult.medianNanoseconds / 1000000.0,
+		       isAgentStepWithinBudget ? "within" : "over", budgetNanoseconds / 1000000.0);
+		results.push_back(agentResult);
+	}
+
+	// --- 粒子：バースト・1 tick・描画データの作成（1000 ~ 100 万個） ---
+	bool isAllocationFree = true;
+	{
+		// 床と壁だけのマップ（当たる粒子は床で跳ねて止まる）
+		std::vector<std::string> rows(32, "#" + std::string(62, '.') + "#");
+		rows.back() = std::string(64, '#');
+		fs::path particleMapPath = workDirectory / "particles.csv";
+		WriteTextFile(particleMapPath, MakeCsv(rows));
+		MapChipField particleField;
+		particleField.LoadMapChipCsv(particleMapPath.string());
+		const Vector3 origin = particleField.GetMapChipPositionByIndex(32, 16);
+
+		ParticleEmitterDesc desc;
+		desc.speedMax = 20.0f;
+		// 計測中に消えないように寿命を長くする
+		desc.lifetimeMin = 1000000.0f;
+		desc.lifetimeMax = 1000000.0f;
+		ParticleEmitterDesc tileDesc = desc;
+		tileDesc.collidesWithTiles = true;
+
+		const uint32_t particleCounts[] = {1000, 100000, 1000000};
+		ParticleSystem particles;
+		for (uint32_t particleCount : particleCounts) {
+			particles.Initialize(particleCount);
+			desc.burstCount = particleCount;
+			tileDesc.burstCount = particleCount;
+			char name[64];
+
+			snprintf(name, sizeof(name), "ParticleBurst/%u", particleCount);
+			results.push_back(Measure(name, [&](uint64_t iterations) {
+				for (uint64_t i = 0; i < iterations; ++i) {
+					particles.Clear();
+					particles.Burst(desc, origin);
+				}
+				gSink = gSink + particles.GetCount();
+			}, 5));
+
+			snprintf(name, sizeof(name), "ParticleUpdate/%u", particleCount);
+			results.push_back(Measure(name, [&](uint64_t iterations) {
+				for (uint64_t i = 0; i < iterations; ++i) {
+					particles.Update(GameClock::kFixedDeltaTime, nullptr);
+				}
+				gSink = gSink + particles.GetCount();
+			}, 5));
+
+			particles.Clear();
+			particles.Burst(tileDesc, origin);
+			snprintf(name, sizeof(name), "ParticleUpdate/%u/tiles", particleCount);
+			results.push_back(Measure(name, [&](uint64_t iterations) {
+				for (uint64_t i = 0; i < iterations; ++i) {
+					particles.Update(GameClock::kFixedDeltaTime, &particleField);
+				}
+				gSink = gSink + particles.GetCount();
+			}, 5));
+
+			snprintf(name, sizeof(name), "ParticleInstances/%u", particleCount);
+			results.push_back(Measure(name, [&](uint64_t iterations) {
+				for (uint64_t i = 0; i < iterations; ++i) {
+					particles.BuildInstances();
+				}
+				gSink = gSink + particles.GetInstanceCount();
+			}, 5));
+
+#ifdef USE_ALLOC_TRACKER
+			// Initialize の後は、喷出・更新・描画データの作成のどれも確保しないこと
+			uint64_t allocationCount = AllocTracker::GetThreadAllocationCount();
+			particles.Clear();
+			particles.Burst(tileDesc, origin);
+			particles.StartEmitter(tileDesc, origin);
+			particles.Update(GameClock::kFixedDeltaTime, &particleField);
+			particles.BuildInstances();
+			if (AllocTracker::GetThreadAllocationCount() != allocationCount) {
+				printf("ParticleSystem: allocated after Initialize with %u particles\n", particleCount);
+				isAllocationFree = false;
+			}
+#endif
+		}
+	}
+
+	// --- インスタンスバッチ：既知のシーンの批次数・批次ごとの実例数・描画リストの順序（NullInstanceBackend） ---
+	bool isInstanceBatchCorrect = true;
+	{
+		// 描画しないので、モデルは批次を分けるためのアドレスだけあればよい
+		alignas(8) static char modelTags[3];
+		Model* const blockModel = reinterpret_cast<Model*>(&modelTags[0]);
+		Model* const agentModel = reinterpret_cast<Model*>(&modelTags[1]);
+		Model* const particleModel = reinterpret_cast<Model*>(&modelTags[2]);
+		constexpr uint32_t kBlockCount = 2048;
+		constexpr uint32_t kAgentEvery = 16; // 方块 16 個ごとに敵 1 体（GameScene と同じく途中に混ざる）
+		constexpr uint32_t kParticleCount = 300;
+		const Matrix4x4 matWorld = {};
+
+		InstanceBatchBuilder builder;
+		NullInstanceBackend backend;
+		auto buildScene = [&]() {
+			builder.Begin();
+			for (uint32_t i = 0; i < kBlockCount; ++i) {
+				builder.Add(blockModel, matWorld, {1.0f, 1.0f, 1.0f, 1.0f}, i);
+				if (i % kAgentEvery == 0) {
+					builder.Add(agentModel, matWorld, {1.0f, 0.3f, 0.3f, 1.0f}, i);
+				}
+			}
+			for (uint32_t i = 0; i < kParticleCount; ++i) {
+				builder.Add(particleModel, matWorld, {1.0f, 1.0f, 1.0f, 0.5f}, i);
+			}
+			builder.End();
+			backend.Submit(builder);
+		};
+
+		auto check = [&isInstanceBatchCorrect](bool isCorrect, const char* message) {
+			if (!isCorrect) {
+				printf("InstanceBatch: %s\n", message);
+				isInstanceBatchCorrect = false;
+			}
+		};
+		buildScene();
+		// 批次は最初に使われたモデルの順。各批次の実例は連続していて、追加した順のまま
+		const Model* const expectedModels[] = {blockModel, agentModel, particleModel};
+		const uint32_t expectedCounts[] = {kBlockCount, kBlockCount / kAgentEvery, kParticleCount};
+		const std::vector<NullInstanceBackend::DrawRecord>& drawList = backend.GetDrawList();
+		check(builder.GetBatchCount() == 3 && drawList.size() == 3, "wrong batch count");
+		uint32_t nextInstance = 0;
+		for (size_t i = 0; i < drawList.size() && i < 3; ++i) {
+			const NullInstanceBackend::DrawRecord& record = drawList[i];
+			check(record.model == expectedModels[i], "draw list out of order");
+			check(record.instanceCount == expectedCounts[i], "wrong instance count in a batch");
+			check(record.firstInstance == nextInstance, "batches are not contiguous");
+			const uint32_t variantStep = record.model == agentModel ? kAgentEvery : 1;
+			for (uint32_t j = 0; j < record.instanceCount && isInstanceBatchCorrect && isAgentStepWithinBudget; ++j) {
+				check(builder.GetInstances()[record.firstInstance + j].variant == j * variantStep, "instances reordered within a batch");
+			}
+			nextInstance += record.instanceCount;
+		}
+		check(builder.GetInstanceCount() == nextInstance, "instances outside any batch");
+
+		// 使われなかったモデルは批次にならず、残りの順序は変わらない
+		builder.Begin();
+		builder.Add(particleModel, matWorld);
+		builder.Add(blockModel, matWorld);
+		builder.End();
+		backend.Submit(builder);
+		check(drawList.size() == 2 && drawList[0].model == blockModel && drawList[1].model == particleModel && drawList[1].firstInstance == 1,
+		      "draw list order changed when a model was unused");
+
+		results.push_back(Measure("InstanceBatchBuild/2048+128+300", [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; ++i) {
+				buildScene();
+			}
+			gSink = gSink + backend.GetTotalInstanceCount();
+		}, 5));
+		printf("InstanceBatch: %u batches, %u instances, last build %.1f us\n", builder.GetBatchCount(), builder.GetInstanceCount(), builder.GetLastBuildMicroseconds());
+
+#ifdef USE_ALLOC_TRACKER
+		// 一度構築した後は、同じ規模のシーンで確保しないこと
+		uint64_t allocationCount = AllocTracker::GetThreadAllocationCount();
+		buildScene();
+		if (AllocTracker::GetThreadAllocationCount() != allocationCount) {
+			printf("InstanceBatch: allocated while rebuilding the same scene\n");
+			isAllocationFree = false;
+		}
+#endif
+	}
+
+	// --- AssetCache の参照カウントと keep-warm（偽のローダー） ---
+	bool isAssetCacheCorrect = true;
+	{
+		constexpr uint32_t kKeepWarmFrames = 3;
+		uint32_t loads = 0;
+		uint32_t unloads = 0;
+		AssetCache<int> cache;
+		cache.SetLoader([&loads](const std::string&) { return static_cast<int>(++loads); }, [&unloads](int&) { unloads++; });
+		cache.SetKeepWarmFrames(kKeepWarmFrames);
+		auto check = [&isAssetCacheCorrect](bool isCorrect, const char* message) {
+			if (!isCorrect) {
+				printf("AssetCache: %s\n", message);
+				isAssetCacheCorrect = false;
+			}
+		};
+
+		// 取得 → 解放 → 取得 では読み直さない
+		cache.Acquire("base_block");
+		cache.Release("base_block");
+		cache.Update();
+		cache.Acquire("base_block");
+		check(cache.GetLoadCount() == 1 && loads == 1 && unloads == 0 && cache.GetHitCount() == 1, "reloaded an asset that was still warm");
+		// keep-warm のフレーム数が過ぎるまでは残り、過ぎたら 1 回だけ解放する
+		cache.Release("base_block");
+		for (uint32_t frame = 1; frame < kKeepWarmFrames; ++frame) {
+			cache.Update();
+			check(cache.Contains("base_block") && unloads == 0, "evicted before the keep-warm window");
+		}
+		cache.Update();
+		check(!cache.Contains("base_block") && unloads == 1 && cache.GetEvictionCount() == 1, "did not evict after the keep-warm window");
+		cache.Acquire("base_block");
+		check(loads == 2, "did not reload an evicted asset");
+		cache.Release("base_block");
+
+		// シーンの切り替え：SceneManager と同じく古いシーンを破棄してから新しいシーンを作って Initialize で取得する
+		const char* const names[] = {"base_block", "player", "goal", "skydome", "title.png"};
+		struct FakeScene {
+			AssetCache<int>& cache;
+			const char* const* names;
+			size_t nameCount;
+			void Initialize() {
+				for (size_t i = 0; i < nameCount; ++i) {
+					cache.Acquire(names[i]);
+				}
+			}
+			~FakeScene() {
+				for (size_t i = 0; i < nameCount; ++i) {
+					cache.Release(names[i]);
+				}
+			}
+		};
+		const uint32_t loadsBeforeScenes = loads;
+		std::unique_ptr<FakeScene> scene;
+		for (uint32_t sceneChange = 0; sceneChange < 10; ++sceneChange) {
+			scene.reset();
+			scene = std::make_unique<FakeScene>(cache, names, std::size(names));
+			scene->Initialize();
+			for (uint32_t frame = 0; frame < kKeepWarmFrames * 2; ++frame) {
+				cache.Update();
+			}
+		}
+		check(loads - loadsBeforeScenes == std::size(names) - 1, "reloaded assets across scene changes");
+		bool isReferenced = true;
+		for (const char* name : names) {
+			isReferenced = isReferenced && cache.GetRefCount(name) == 1;
+		}
+		check(isReferenced, "scene does not hold exactly one reference per asset");
+		// シーンを破棄したら参照は 0 になり、keep-warm の間は残る
+		scene.reset();
+		bool isUnreferenced = true;
+		for (const char* name : names) {
+			isUnreferenced = isUnreferenced && cache.GetRefCount(name) == 0 && cache.Contains(name);
+		}
+		check(isUnreferenced, "references left after scene teardown");
+		for (uint32_t frame = 0; frame < kKeepWarmFrames; ++frame) {
+			cache.Update();
+		}
+		check(cache.GetSize() == 0 && unloads == loads, "unreferenced assets not evicted after teardown");
+		printf("AssetCache: %u loads, %u hits, %u evictions\n", cache.GetLoadCount(), cache.GetHitCount(), cache.GetEvictionCount());
+	}
+
+	// --- コールバック：Delegate と std::function ---
+	{
+		// 64 個の呼び出し先を順に呼ぶ（1 つだけだとインライン化されて比べられない）
+		constexpr uint32_t kCallbackCount = 64;
+		uint64_t counters[kCallbackCount] = {};
+		std::vector<Delegate<void()>> delegates;
+		std::vector<std::function<void()>> functions;
+		delegates.reserve(kCallbackCount);
+		functions.reserve(kCallbackCount);
+		for (uint32_t i = 0; i < kCallbackCount; ++i) {
+			uint64_t* counter = &counters[i];
+			const uint64_t step = i + 1;
+			delegates.emplace_back([counter, step] { *counter += step; });
+			functions.emplace_back([counter, step] { *counter += step; });
+		}
+		results.push_back(Measure("Callback/Delegate_invoke x64", [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; ++i) {
+				for (const Delegate<void()>& delegate : delegates) {
+					delegate();
+				}
+			}
+		}));
+		results.push_back(Measure("Callback/std_function_invoke x64", [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; ++i) {
+				for (const std::function<void()>& function : functions) {
+					function();
+				}
+			}
+		}));
+		// 3 ポインタ分（24 バイト）をキャプチャして束縛し、2 回移動して呼ぶ（std::function は実装によってはここで確保する）
+		uint64_t* first = &counters[0];
+		uint64_t* second = &counters[1];
+		uint64_t* third = &counters[2];
+		results.push_back(Measure("Callback/Delegate_bind_move", [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; ++i) {
+				Delegate<void()> bound([first, second, third] { *first += *second + *third; });
+				Delegate<void()> moved(std::move(bound));
+				Delegate<void()> target;
+				target = std::move(moved);
+				target();
+			}
+		}));
+		results.push_back(Measure("Callback/std_function_bind_move", [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; ++i) {
+				std::function<void()> bound([first, second, third] { *first += *second + *third; });
+				std::function<void()> moved(std::move(bound));
+				std::function<void()> target;
+				target = std::move(moved);
+				target();
+			}
+		}));
+		for (uint64_t counter : counters) {
+			gSink = gSink + counter;
+		}
+
+#ifdef USE_ALLOC_TRACKER
+		// 1 関卡分（25 秒）：Goal の到達コールバックと Timer の期限コールバックを、原地重开のたびに束縛し直し・移動し・呼ぶ。
+		// Goal と Timer 自体は関卡の読み込み時に作るので計測の外
+		constexpr uint32_t kGoalCount = 16;
+		constexpr uint32_t kTimerCount = 8;
+		constexpr uint32_t kLevelTicks = 25 * GameClock::kTicksPerSecond;
+		constexpr uint32_t kRestartInterval = 5 * GameClock::kTicksPerSecond;
+		TimerWheel timerWheel;
+		std::vector<std::unique_ptr<Goal>> goals;
+		for (uint32_t i = 0; i < kGoalCount; ++i) {
+			goals.push_back(std::make_unique<Goal>());
+			goals.back()->SetTimerWheel(&timerWheel);
+		}
+		std::vector<Timer> timers(kTimerCount);
+		uint32_t goalCallbackCount = 0;
+		uint32_t timerCallbackCount = 0;
+
+		const uint64_t allocationCount = AllocTracker::GetThreadAllocationCount();
+		for (uint32_t tick = 0; tick < kLevelTicks; ++tick) {
+			if (tick % kRestartInterval == 0) {
+				for (std::unique_ptr<Goal>& goal : goals) {
+					goal->ResetTrigger();
+					goal->SetOnCollisionCallback([&goalCallbackCount](Goal*) { goalCallbackCount++; });
+				}
+				for (uint32_t i = 0; i < kTimerCount; ++i) {
+					// 束縛してから移動で渡す（set_on_timeout の中でもう一度移動する）
+					Delegate<void()> callback([&timerCallbackCount] { timerCallbackCount++; });
+					Delegate<void()> moved(std::move(callback));
+					timers[i].set_wait_time(0.25f * static_cast<float>(i + 1));
+					timers[i].set_on_timeout(std::move(moved));
+					timers[i].restart();
+				}
+			}
+			for (Timer& timer : timers) {
+				timer.on_update(GameClock::kFixedDeltaTime);
+			}
+			goals[tick % kGoalCount]->TriggerCollision();
+			timerWheel.Advance();
+		}
+		const uint64_t callbackAllocations = AllocTracker::GetThreadAllocationCount() - allocationCount;
+		printf("Callback: %u goal and %u timer callbacks over %u ticks, %llu allocations\n", goalCallbackCount, timerCallbackCount, kLevelTicks,
+		       static_cast<unsigned long long>(callbackAllocations));
+		if (callbackAllocations > 0 || goalCallbackCount == 0 || timerCallbackCount == 0) {
+			isAllocationFree = false;
+		}
+#endif
+	}
+
+	// --- WorldTransform::MakeAffineMatrix4x4 ---
+	{
+		WorldTransform worldTransform;
+		worldTransform.scale_ = {0.5f, 0.5f, 0.5f};
+		results.push_back(Measure("WorldTransform::MakeAffineMatrix4x4", [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; ++i) {
+				worldTransform.translation_.x = static_cast<float>(i & 1023);
+				worldTransform.MakeAffineMatrix4x4();
+			}
+			gSink = gSink + static_cast<uint64_t>(worldTransform.matWorld_.m[3][0]);
+		}));
+	}
+
+	// --- 大きなマップの方块変換を JobSystem で並列に更新（スレッド数ごと） ---
+	bool isDeterministic = true;
+	{
+		constexpr uint32_t kWidth = 1024;
+		constexpr uint32_t kHeight = 512;
+		constexpr uint32_t kBlocksPerJob = 1024; // GameScene と同じ粒度
+		std::vector<WorldTransform> blocks(static_cast<size_t>(kWidth) * kHeight);
+		for (uint32_t y = 0; y < kHeight; ++y) {
+			for (uint32_t x = 0; x < kWidth; ++x) {
+				blocks[static_cast<size_t>(y) * kWidth + x].translation_ = {static_cast<float>(x) * MapChipField::kBlockWidth, static_cast<float>(y) * MapChipField::kBlockHeight, 0.0f};
+			}
+		}
+		float blockScale = 1.0f;
+		auto updateRows = [&](uint32_t begin, uint32_t end) {
+			for (uint32_t y = begin; y < end; ++y) {
+				for (uint32_t x = 0; x < kWidth; ++x) {
+					WorldTransform& worldTransform = blocks[static_cast<size_t>(y) * kWidth + x];
+					worldTransform.scale_ = {blockScale, blockScale, blockScale};
+					worldTransform.MakeAffineMatrix4x4();
+				}
+			}
+		};
+
+		std::vector<Matrix4x4> reference;
+		const uint32_t threadCounts[] = {1, 2, 4, 8, 16};
+		for (uint32_t threadCount : threadCounts) {
+			JobSystem::Initialize(threadCount);
+			JobSystem& jobs = JobSystem::GetInstance();
+			char name[64];
+			snprintf(name, sizeof(name), "ParallelBlockTransforms/1024x512/threads_%u", threadCount);
+			results.push_back(Measure(name, [&](uint64_t iterations) {
+				for (uint64_t i = 0; i < iterations; ++i) {
+					blockScale = 0.5f + static_cast<float>(i & 7) * 0.0625f;
+					JobCounter counter;
+					jobs.ParallelFor(counter, kHeight, kBlocksPerJob / kWidth, updateRows);
+					jobs.Wait(counter);
+				}
+				gSink = gSink + static_cast<uint64_t>(blocks.back().matWorld_.m[3][0]);
+			}, 5));
+
+			// 結果はスレッド数に依存しないこと（1 スレッドの結果とビット単位で比較する）
+			blockScale = 0.75f;
+			JobCounter counter;
+			jobs.ParallelFor(counter, kHeight, kBlocksPerJob / kWidth, updateRows);
+			jobs.Wait(counter);
+			if (reference.empty()) {
+				reference.reserve(blocks.size());
+				for (const WorldTransform& worldTransform : blocks) {
+					reference.push_back(worldTransform.matWorld_);
+				}
+			} else {
+				for (size_t i = 0; i < blocks.size(); ++i) {
+					if (std::memcmp(&reference[i], &blocks[i].matWorld_, sizeof(Matrix4x4)) != 0) {
+						printf("ParallelBlockTransforms: result with %u threads differs from 1 thread at block %zu\n", threadCount, i);
+						isDeterministic = false;
+						break;
+					}
+				}
+			}
+		}
+		// ゲーム本体と同じくハードウェアスレッド数に戻す
+		JobSystem::Initialize(0);
+	}
+
+	// --- 定常状態チェックがワーカースレッドでの確保を数えること ---
+	bool isAllocCheckCoveringJobs = true;
+#ifdef USE_ALLOC_TRACKER
+	{
+		// 呼び出し元は Wait せずに待つので、ジョブは必ずワーカーで実行される
+		JobSystem::Initialize(2);
+		JobSystem& jobs = JobSystem::GetInstance();
+		std::vector<uint32_t>* volatile allocated = nullptr;
+		uint32_t workerIndex = 0;
+		auto runOnWorker = [&jobs](auto& job) {
+			JobCounter counter;
+			jobs.Run(counter, job);
+			while (!counter.IsDone()) {
+				std::this_thread::yield();
+			}
+		};
+		auto allocatingJob = [&allocated, &workerIndex]() {
+			workerIndex = JobSystem::GetCurrentThreadIndex();
+			allocated = new std::vector<uint32_t>(16);
+		};
+		auto quietJob = [&workerIndex]() { workerIndex = JobSystem::GetCurrentThreadIndex(); };
+
+		AllocTracker::SetSteadyStateCheck(true);
+		{
+			AllocTracker::TickScope scope("Benchmark::QuietJob", true);
+			runOnWorker(quietJob);
+		}
+		if (AllocTracker::HasSteadyStateFailure()) {
+			printf("AllocCheck: a job that does not allocate was reported\n");
+			isAllocCheckCoveringJobs = false;
+		}
+		{
+			AllocTracker::TickScope scope("Benchmark::AllocatingJob", true);
+			runOnWorker(allocatingJob);
+		}
+		if (workerIndex == 0 || !AllocTracker::HasSteadyStateFailure()) {
+			printf("AllocCheck: allocation in a job on worker %u was not caught\n", workerIndex);
+			isAllocCheckCoveringJobs = false;
+		}
+		AllocTracker::SetSteadyStateCheck(false);
+		delete allocated;
+		JobSystem::Initialize(0);
+	}
+#endif
+
+	fs::remove_all(workDirectory, error);
+
+	// --- JSON ---
+	std::ofstream file(outputPath);
+	if (!file.is_open()) {
+		return false;
+	}
+#if defined(_DEBUG)
+	const char* configuration = "Debug";
+#elif defined(USE_IMGUI)
+	const char* configuration = "Develop";
+#else
+	const char* configuration = "Release";
+#endif
+#ifdef USE_PROFILER
+	const char* profiler = "true";
+#else
+	const char* profiler = "false";
+#endif
+	file << "{\n  \"configuration\": \"" << configuration << "\",\n  \"profiler\": " << profiler << ",\n  \"hardware_threads\": " << std::thread::hardware_concurrency()
+	     << ",\n  \"deterministic\": " << (isDeterministic ? "true" : "false") << ",\n  \"results\": [\n";
+	char number[64];
+	for (size_t i = 0; i < results.size(); ++i) {
+		const Result& result = results[i];
+		file << "    {\"name\": ";
+		WriteJsonString(file, result.name);
+		file << ", \"iterations\": " << result.iterations << ", \"samples\": " << result.samples;
+		snprintf(number, sizeof(number), "%.3f", result.minNanoseconds);
+		file << ", \"min_ns\": " << number;
+		snprintf(number, sizeof(number), "%.3f", result.medianNanoseconds);
+		file << ", \"median_ns\": " << number;
+		snprintf(number, sizeof(number), "%.3f", result.meanNanoseconds);
+		file << ", \"mean_ns\": " << number << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+	}
+	file << "  ]\n}\n";
+	return file.good() && isDeterministic && isAllocationFree && isAutotileCorrect && isChunkMeshCorrect && isInputCorrect && isLatencyCorrect && isCameraRateIndependent && isAssetCacheCorrect && isAllocCheckCoveringJobs && isInstanceBatchCorrect;
+}
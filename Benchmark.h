@@ -0,0 +1,10 @@
+#pragma once
+#include <string>
+
+// マップ・衝突判定・物理のホットパスのマイクロベンチマーク。
+// レンダラーを使わないので、エンジン初期化前に実行できる（起動引数 -bench [出力パス]）。
+// 結果は JSON で書き出す。計測値を正しく取るには Release 構成（プロファイラ無効）で実行すること。
+namespace Benchmark {
+	// 全ケースを実行して outputPath に書き出す。書き出しに失敗したか、並列更新の結果がスレッド数で変わったら false
+	bool RunAll(const std::string& outputPath);
+}
@@ -15,6 +15,7 @@ void CameraController::Initialize() {
 	// Initialize camera position
 	targetPosition_ = mainCamera_.translation_;
 	targetPosition_.z = -cameraDistance_;
+	focusPosition_ = targetPosition_;
 	
 	// Store the base field of view angle
 	baseFovAngleY_ = mainCamera_.fovAngleY;
@@ -36,6 +37,28 @@ void CameraController::SetFollowSpeed(float speed) {
 	} else {
 		followSpeed_ = speed;
 	}
+
+	// 60Hz で毎フレーム Lerp(speed) したときの時定数 tau に合わせる（omega = 1 / tau）
+	float tau = -GameClock::kFixedDeltaTime / std::log(1.0f - std::min(followSpeed_, 0.999f));
+	SetFollowSmoothTime(2.0f * tau);
+}
+
+void CameraController::SetFollowSmoothTime(float seconds) {
+	followSmoothTime_ = (seconds > 0.001f) ? seconds : 0.001f;
+}
+
+void CameraController::SetLookAhead(float lookAheadTime, float maxDistance) {
+	lookAheadTime_ = (lookAheadTime > 0.0f) ? lookAheadTime : 0.0f;
+	maxLookAhead_ = (maxDistance > 0.0f) ? maxDistance : 0.0f;
+}
+
+void CameraController::SetInitialPosition(const Vector3& position) {
+	targetPosition_ = position;
+	focusPosition_ = position;
+	mainCamera_.translation_ = position;
+	followVelocity_ = {0.0f, 0.0f, 0.0f};
+	lookAheadOffset_ = {0.0f, 0.0f};
+	lookAheadVelocity_ = {0.0f, 0.0f};
 }
 
 void CameraController::SetCameraDistance(float distance) {
@@ -87,6 +110,19 @@ Vector2 CameraController::GetCachedViewportSize() {
 	return cachedViewportSize_;
 }
 
+Rect CameraController::GetVisibleArea(float margin) {
+	Vector2 viewportSize = GetCachedViewportSize();
+	float halfWidth = viewportSize.x * 0.5f + margin;
+	float halfHeight = viewportSize.y * 0.5f + margin;
+
+	Rect area;
+	area.left = mainCamera_.translation_.x - halfWidth;
+	area.right = mainCamera_.translation_.x + halfWidth;
+	area.bottom = mainCamera_.translation_.y - halfHeight;
+	area.top = mainCamera_.translation_.y + halfHeight;
+	return area;
+}
+
 bool CameraController::IsValidMovableArea(const Rect& area) const {
 	return (area.left != 0.0f || area.right != 0.0f || 
 			area.top != 0.0f || area.bottom != 0.0f) &&
@@ -123,7 +159,7 @@ void CameraController::SetAutoZoomByMapWidth(float mapWidth, float referenceMapW
 	SetZoom(autoZoom);
 }
 
-void CameraController::Update() { 
+void CameraController::Update(float deltaTime) { 
 	if (!target_) {
 		mainCamera_.UpdateMatrix(); 
 		return;
@@ -132,8 +168,8 @@ void CameraController::Update() {
 	// Get player position
 	Vector3 playerPosition = target_->GetTranslation();
 	
-	// Start with current camera position
-	Vector3 desiredPosition = targetPosition_;
+	// Start from the dead zone center (without look-ahead)
+	Vector3 desiredPosition = focusPosition_;
 	desiredPosition.z = -cameraDistance_; // Keep camera at a configurable distance from the game plane
 	
 	// Use cached viewport size for better performance
@@ -162,6 +198,17 @@ void CameraController::Update() {
 	} else if (playerPosition.y > deadZoneTop) {
 		desiredPosition.y = playerPosition.y - halfDeadZoneHeight;
 	}
+	focusPosition_ = desiredPosition;
+
+	// 速度から先読み（速度は tick 単位なので秒単位に換算）
+	Vector2 playerVelocity = target_->GetVelocity();
+	float ticksPerSecond = static_cast<float>(GameClock::kTicksPerSecond);
+	float lookAheadX = std::clamp(playerVelocity.x * ticksPerSecond * lookAheadTime_, -maxLookAhead_, maxLookAhead_);
+	float lookAheadY = std::clamp(playerVelocity.y * ticksPerSecond * lookAheadTime_, -maxLookAhead_ * 0.5f, maxLookAhead_ * 0.5f);
+	lookAheadOffset_.x = SmoothDamp(lookAheadOffset_.x, lookAheadX, lookAheadVelocity_.x, lookAheadSmoothTime_, deltaTime);
+	lookAheadOffset_.y = SmoothDamp(lookAheadOffset_.y, lookAheadY, lookAheadVelocity_.y, lookAheadSmoothTime_, deltaTime);
+	desiredPosition.x += lookAheadOffset_.x;
+	desiredPosition.y += lookAheadOffset_.y;
 	
 	// Apply map bounds constraints with priority (optimized condition check)
 	if (mapBoundsPriority_ && hasValidMovableArea_) {
@@ -188,8 +235,10 @@ void CameraController::Update() {
 		if (desiredPosition.y > effectiveTop) desiredPosition.y = effectiveTop;
 	}
 	
-	// Smooth camera movement using lerp
-	targetPosition_ = Lerp(targetPosition_, desiredPosition, followSpeed_);
+	// 臨界減衰バネで追従（経過時間で積分するのでフレームレートに依存しない）
+	targetPosition_.x = SmoothDamp(targetPosition_.x, desiredPosition.x, followVelocity_.x, followSmoothTime_, deltaTime);
+	targetPosition_.y = SmoothDamp(targetPosition_.y, desiredPosition.y, followVelocity_.y, followSmoothTime_, deltaTime);
+	targetPosition_.z = SmoothDamp(targetPosition_.z, desiredPosition.z, followVelocity_.z, followSmoothTime_, deltaTime);
 	
 	// Update camera position
 	mainCamera_.translation_ = targetPosition_;
@@ -1,5 +1,6 @@
 #pragma once
 #include "KamataEngine.h"
+#include "GameClock.h"
 using namespace KamataEngine;
 class Player;
 struct Rect {
@@ -13,7 +14,8 @@ public:
 	CameraController() = default;
 	~CameraController() = default;
 	void Initialize();
-	void Update();
+	// deltaTime: 上一次 Update 以来经过的实际时间（秒）
+	void Update(float deltaTime = GameClock::kFixedDeltaTime);
 
 	void SetTarget(Player* target) { target_ = target; }
 	const Camera& GetCamera() { return mainCamera_; }
@@ -21,15 +23,22 @@ public:
 	
 	// Calculate the viewport size at a given Z distance
 	Vector2 CalculateViewportSize(float distance) const;
+
+	// World-space area visible on the game plane (z = 0), expanded by margin
+	Rect GetVisibleArea(float margin = 0.0f);
 	
 	// Set camera follow parameters
+	// 旧的参数：60Hz 下每帧的 Lerp 系数，内部换算成 smooth time
 	void SetFollowSpeed(float speed);
+	void SetFollowSmoothTime(float seconds);
+	// 按玩家速度预测前方：lookAheadTime 秒后的位置，最多 maxDistance
+	void SetLookAhead(float lookAheadTime, float maxDistance);
 	void SetCameraDistance(float distance);
 	
 	// New methods for improved camera behavior
 	void SetMapBoundsPriority(bool enabled) { mapBoundsPriority_ = enabled; }
 	void SetDeadZone(float width, float height);
-	void SetInitialPosition(const Vector3& position) { targetPosition_ = position; mainCamera_.translation_ = position; }
+	void SetInitialPosition(const Vector3& position);
 	
 	// Camera scaling methods
 	void SetZoom(float zoom);
@@ -50,7 +59,17 @@ private:
 	KamataEngine::Camera mainCamera_; // メインカメラ
 	Player* target_ = nullptr; // 追従対象のプレイヤー
 	Vector3 targetPosition_ = {0.0f, 0.0f, -50.0f}; // カメラの目標位置（スムージング用）
-	float followSpeed_ = 0.1f; // カメラの追従速度
+	float followSpeed_ = 0.1f; // カメラの追従速度（60Hz での Lerp 係数）
+	float followSmoothTime_ = 0.32f; // 追従のスムーズ時間（秒）
+	Vector3 followVelocity_ = {0.0f, 0.0f, 0.0f}; // バネの速度
+	Vector3 focusPosition_ = {0.0f, 0.0f, 0.0f}; // デッドゾーンの中心（先読み前）
+
+	// 速度による先読み
+	float lookAheadTime_ = 0.25f;
+	float maxLookAhead_ = 4.0f;
+	float lookAheadSmoothTime_ = 0.4f;
+	Vector2 lookAheadOffset_ = {0.0f, 0.0f};
+	Vector2 lookAheadVelocity_ = {0.0f, 0.0f};
 	float cameraDistance_ = 50.0f; // カメラとゲーム平面との距離
 	
 	// New members for improved camera behavior
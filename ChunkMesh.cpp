@@ -0,0 +1,212 @@
+#include "ChunkMesh.h"
+#include "Profiler.h"
+#include <chrono>
+
+namespace {
+	// 立方体の 1 面。外から見て u が右、v が上（左手系・時計回りが表）
+	struct Face {
+		float normal[3];
+		float u[3];
+		float v[3];
+		bool hasNeighbor; // 側面だけ：隣のタイルがブロックなら出さない
+		int neighborX;
+		int neighborY;   // タイル番号なので下向きが +
+		bool runsAlongX; // 横に並んだ面をまとめる（false なら縦）
+	};
+	constexpr Face kFaces[] = {
+	    {{0.0f, 0.0f, -1.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, false, 0, 0, true},   // 手前
+	    {{0.0f, 0.0f, 1.0f}, {-1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, false, 0, 0, true},   // 奥
+	    {{1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 0.0f}, true, 1, 0, false},    // 右
+	    {{-1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f}, {0.0f, 1.0f, 0.0f}, true, -1, 0, false}, // 左
+	    {{0.0f, 1.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, true, 0, -1, true},    // 上
+	    {{0.0f, -1.0f, 0.0f}, {-1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, true, 0, 1, true},   // 下
+	};
+	constexpr uint32_t kFaceCount = static_cast<uint32_t>(sizeof(kFaces) / sizeof(kFaces[0]));
+	// 左下・左上・右上・右下
+	constexpr float kCornerSigns[4][2] = {{-1.0f, -1.0f}, {-1.0f, 1.0f}, {1.0f, 1.0f}, {1.0f, -1.0f}};
+	constexpr float kCornerTexcoords[4][2] = {{0.0f, 1.0f}, {0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}};
+	constexpr uint32_t kQuadIndices[6] = {0, 1, 2, 0, 2, 3};
+
+	// first ~ last の runLength 個のタイルの face の面を 1 枚の四角として足す
+	void EmitQuad(ChunkMesh& chunk, const Face& face, const Vector3& first, const Vector3& last, uint32_t runLength, uint32_t variant) {
+		const float centers[3] = {(first.x + last.x) / 2.0f, (first.y + last.y) / 2.0f, (first.z + last.z) / 2.0f};
+		const float length = static_cast<float>(runLength);
+		const uint32_t runAxis = face.runsAlongX ? 0 : 1;
+		float halfExtents[3] = {MapChipField::kBlockWidth / 2.0f, MapChipField::kBlockHeight / 2.0f, MapChipField::kBlockWidth / 2.0f};
+		halfExtents[runAxis] *= length;
+		// 並びの方向（面の u か v）だけテクスチャを繰り返す
+		const float texcoordScaleU = face.u[runAxis] != 0.0f ? length : 1.0f;
+		const float texcoordScaleV = face.u[runAxis] != 0.0f ? 1.0f : length;
+
+		const uint32_t firstVertex = static_cast<uint32_t>(chunk.vertices.size());
+		for (uint32_t corner = 0; corner < 4; ++corner) {
+			float position[3];
+			for (uint32_t axis = 0; axis < 3; ++axis) {
+				position[axis] = centers[axis] + (face.normal[axis] + face.u[axis] * kCornerSigns[corner][0] + face.v[axis] * kCornerSigns[corner][1]) * halfExtents[axis];
+			}
+			ChunkMeshVertex vertex;
+			vertex.position = Vector3(position[0], position[1], position[2]);
+			vertex.normal = Vector3(face.normal[0], face.normal[1], face.normal[2]);
+			vertex.texcoord = Vector2(kCornerTexcoords[corner][0] * texcoordScaleU, kCornerTexcoords[corner][1] * texcoordScaleV);
+			vertex.variant = variant;
+			chunk.vertices.push_back(vertex);
+		}
+		for (uint32_t index : kQuadIndices) {
+			chunk.indices.push_back(firstVertex + index);
+		}
+	}
+}
+
+void ChunkMeshBaker::Build(const MapChipField& map, const AutotileMap* autotile, uint32_t chunkSize) {
+	PROFILE_FUNCTION();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	chunkSize_ = std::max(chunkSize, 1u);
+	chunkCountX_ = (map.GetNumBlockHorizontal() + chunkSize_ - 1) / chunkSize_;
+	chunkCountY_ = (map.GetNumBlockVertical() + chunkSize_ - 1) / chunkSize_;
+	chunks_.assign(static_cast<size_t>(chunkCountX_) * chunkCountY_, ChunkMesh{});
+	isChunkDirty_.assign(chunks_.size(), 0);
+	dirtyChunks_.clear();
+
+	blockCount_ = 0;
+	nonEmptyChunkCount_ = 0;
+	vertexCount_ = 0;
+	triangleCount_ = 0;
+	for (uint32_t chunkY = 0; chunkY < chunkCountY_; ++chunkY) {
+		for (uint32_t chunkX = 0; chunkX < chunkCountX_; ++chunkX) {
+			ChunkMesh& chunk = chunks_[static_cast<size_t>(chunkY) * chunkCountX_ + chunkX];
+			chunk.tiles.xBegin = chunkX * chunkSize_;
+			chunk.tiles.xEnd = std::min(chunk.tiles.xBegin + chunkSize_, map.GetNumBlockHorizontal());
+			chunk.tiles.yBegin = chunkY * chunkSize_;
+			chunk.tiles.yEnd = std::min(chunk.tiles.yBegin + chunkSize_, map.GetNumBlockVertical());
+			BakeChunk(chunk, map, autotile);
+			blockCount_ += chunk.blockCount;
+			nonEmptyChunkCount_ += chunk.indices.empty() ? 0 : 1;
+			vertexCount_ += chunk.vertices.size();
+			triangleCount_ += chunk.GetTriangleCount();
+		}
+	}
+
+	lastBakedChunkCount_ = static_cast<uint32_t>(chunks_.size());
+	std::chrono::duration<float, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+	lastBakeMicroseconds_ = elapsed.count();
+}
+
+void ChunkMeshBaker::MarkTileChanged(uint32_t xIndex, uint32_t yIndex) {
+	if (chunkSize_ == 0) {
+		return;
+	}
+	// 0 の左・上は符号なしで回り込み、チャンク数を超えるので飛ばされる
+	for (uint32_t y = yIndex - 1; y != yIndex + 2; ++y) {
+		for (uint32_t x = xIndex - 1; x != xIndex + 2; ++x) {
+			const uint32_t chunkX = x / chunkSize_;
+			const uint32_t chunkY = y / chunkSize_;
+			if (chunkX >= chunkCountX_ || chunkY >= chunkCountY_) {
+				continue;
+			}
+			const uint32_t chunkIndex = chunkY * chunkCountX_ + chunkX;
+			if (!isChunkDirty_[chunkIndex]) {
+				isChunkDirty_[chunkIndex] = 1;
+				dirtyChunks_.push_back(chunkIndex);
+			}
+		}
+	}
+}
+
+uint32_t ChunkMeshBaker::BakeDirty(const MapChipField& map, const AutotileMap* autotile) {
+	if (dirtyChunks_.empty()) {
+		return 0;
+	}
+	PROFILE_FUNCTION();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for (uint32_t chunkIndex : dirtyChunks_) {
+		ChunkMesh& chunk = chunks_[chunkIndex];
+		blockCount_ -= chunk.blockCount;
+		nonEmptyChunkCount_ -= chunk.indices.empty() ? 0 : 1;
+		vertexCount_ -= chunk.vertices.size();
+		triangleCount_ -= chunk.GetTriangleCount();
+		BakeChunk(chunk, map, autotile);
+		blockCount_ += chunk.blockCount;
+		nonEmptyChunkCount_ += chunk.indices.empty() ? 0 : 1;
+		vertexCount_ += chunk.vertices.size();
+		triangleCount_ += chunk.GetTriangleCount();
+		isChunkDirty_[chunkIndex] = 0;
+	}
+	lastBakedChunkCount_ = static_cast<uint32_t>(dirtyChunks_.size());
+	dirtyChunks_.clear();
+
+	std::chrono::duration<float, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+	lastBakeMicroseconds_ = elapsed.count();
+	return lastBakedChunkCount_;
+}
+
+void ChunkMeshBaker::BakeChunk(ChunkMesh& chunk, const MapChipField& map, const AutotileMap* autotile) {
+	// 焼き直しでは前回の容量をそのまま使う
+	chunk.vertices.clear();
+	chunk.indices.clear();
+	chunk.blockCount = 0;
+	chunk.revision++;
+
+	// 周り 1 タイルを含めた固さを先に読む（面ごとに何度も見るため）。0 の左・上は回り込んで範囲外（ブロック無し）になる
+	const uint32_t chunkWidth = chunk.tiles.xEnd - chunk.tiles.xBegin;
+	const uint32_t chunkHeight = chunk.tiles.yEnd - chunk.tiles.yBegin;
+	solidStride_ = chunkWidth + 2;
+	solid_.assign(static_cast<size_t>(solidStride_) * (chunkHeight + 2), 0);
+	for (uint32_t y = 0; y < chunkHeight + 2; ++y) {
+		for (uint32_t x = 0; x < solidStride_; ++x) {
+			solid_[static_cast<size_t>(y) * solidStride_ + x] = map.IsBlockAtIndex(chunk.tiles.xBegin + x - 1, chunk.tiles.yBegin + y - 1) ? 1 : 0;
+		}
+	}
+	for (uint32_t y = 0; y < chunkHeight; ++y) {
+		for (uint32_t x = 0; x < chunkWidth; ++x) {
+			chunk.blockCount += solid_[static_cast<size_t>(y + 1) * solidStride_ + x + 1];
+		}
+	}
+
+	const bool hasVariants = autotile && autotile->GetWidth() == map.GetNumBlockHorizontal() && autotile->GetHeight() == map.GetNumBlockVertical();
+	auto variantAt = [&](uint32_t x, uint32_t y) -> uint32_t { return hasVariants ? autotile->GetVariant(chunk.tiles.xBegin + x, chunk.tiles.yBegin + y) : 0; };
+	for (uint32_t faceIndex = 0; faceIndex < kFaceCount; ++faceIndex) {
+		const Face& face = kFaces[faceIndex];
+		// 行（左右の面は列）ごとに、見えていて variant が同じ面の並びを 1 枚にする
+		const uint32_t lineCount = face.runsAlongX ? chunkHeight : chunkWidth;
+		const uint32_t lineLength = face.runsAlongX ? chunkWidth : chunkHeight;
+		for (uint32_t line = 0; line < lineCount; ++line) {
+			for (uint32_t begin = 0; begin < lineLength;) {
+				const uint32_t x = face.runsAlongX ? begin : line;
+				const uint32_t y = face.runsAlongX ? line : begin;
+				if (!IsFaceVisible(faceIndex, x, y)) {
+					++begin;
+					continue;
+				}
+				const uint32_t variant = variantAt(x, y);
+				uint32_t end = begin + 1;
+				for (; end < lineLength; ++end) {
+					const uint32_t nextX = face.runsAlongX ? end : line;
+					const uint32_t nextY = face.runsAlongX ? line : end;
+					if (!IsFaceVisible(faceIndex, nextX, nextY) || variantAt(nextX, nextY) != variant) {
+						break;
+					}
+				}
+				const uint32_t lastX = face.runsAlongX ? end - 1 : line;
+				const uint32_t lastY = face.runsAlongX ? line : end - 1;
+				EmitQuad(chunk, face, map.GetMapChipPositionByIndex(chunk.tiles.xBegin + x, chunk.tiles.yBegin + y),
+				         map.GetMapChipPositionByIndex(chunk.tiles.xBegin + lastX, chunk.tiles.yBegin + lastY), end - begin, variant);
+				begin = end;
+			}
+		}
+	}
+}
+
+bool ChunkMeshBaker::IsFaceVisible(uint32_t faceIndex, uint32_t x, uint32_t y) const {
+	const Face& face = kFaces[faceIndex];
+	const size_t index = static_cast<size_t>(y + 1) * solidStride_ + x + 1;
+	if (!solid_[index]) {
+		return false;
+	}
+	if (!face.hasNeighbor) {
+		return true;
+	}
+	const size_t neighbor = static_cast<size_t>(static_cast<int>(y + 1) + face.neighborY) * solidStride_ + static_cast<size_t>(static_cast<int>(x + 1) + face.neighborX);
+	return !solid_[neighbor];
+}
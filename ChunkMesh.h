@@ -0,0 +1,99 @@
+#pragma once
+#include "MapChipField.h"
+#include "Autotile.h"
+#include <math/Vector2.h>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// 焼き込んだメッシュの頂点
+struct ChunkMeshVertex {
+	Vector3 position;
+	Vector3 normal;
+	Vector2 texcoord;     // 左上が 0, 0。まとめた面は並びの方向に 0 ~ タイル数（繰り返し）
+	uint32_t variant = 0; // ブロックのオートタイルの種類（Autotile.h）。図柄の選択はレンダラーに任せる
+};
+
+// N x N タイルのチャンク 1 つ分のメッシュ（1 回の描画で出せる）
+struct ChunkMesh {
+	TileRange tiles;              // このチャンクが受け持つタイル
+	std::vector<ChunkMeshVertex> vertices;
+	std::vector<uint32_t> indices; // 三角形リスト
+	uint32_t blockCount = 0;
+	uint32_t revision = 0; // 焼き直すたびに増える（レンダラーは変わったときだけ上げ直す）
+
+	uint32_t GetTriangleCount() const { return static_cast<uint32_t>(indices.size() / 3); }
+};
+
+// 静的なブロックをチャンクごとに 1 つのメッシュにまとめる。レンダラーには依存しない（CPU 側の頂点・インデックスだけ作る）。
+// 隣もブロックの側面は見えないので出さない（手前・奥の面は出す）。マップの外はブロック無し扱い。
+// 見える面は、同じ variant が並んでいれば 1 枚の四角にまとめる（左右の面は縦の並び、それ以外は横の並び）。
+// タイルが変わったら MarkTileChanged で印を付け、BakeDirty で印の付いたチャンクだけ焼き直す。
+class ChunkMeshBaker {
+public:
+	static constexpr uint32_t kDefaultChunkSize = 16;
+	// 比較用：ブロックを 1 つずつ描くときの 1 個分（立方体）
+	static constexpr uint32_t kCubeVertexCount = 24;
+	static constexpr uint32_t kCubeTriangleCount = 12;
+
+	// 全チャンクを焼く。autotile が同じ大きさなら variant を頂点に入れる
+	void Build(const MapChipField& map, const AutotileMap* autotile, uint32_t chunkSize = kDefaultChunkSize);
+	// (xIndex, yIndex) の固さ（またはオートタイル）が変わった。隣のチャンクの面と種類も変わりうるので周り 3x3 のチャンクに印を付ける
+	void MarkTileChanged(uint32_t xIndex, uint32_t yIndex);
+	// 印の付いたチャンクを焼き直し、その数を返す
+	uint32_t BakeDirty(const MapChipField& map, const AutotileMap* autotile);
+
+	uint32_t GetChunkSize() const { return chunkSize_; }
+	uint32_t GetChunkCountX() const { return chunkCountX_; }
+	uint32_t GetChunkCountY() const { return chunkCountY_; }
+	const ChunkMesh& GetChunk(uint32_t chunkX, uint32_t chunkY) const { return chunks_[static_cast<size_t>(chunkY) * chunkCountX_ + chunkX]; }
+
+	// tiles と重なるチャンクのうち、中身のあるものを呼ぶ（可視範囲の描画用）
+	template <typename Function>
+	void ForEachChunkInRange(const TileRange& tiles, Function&& function) const {
+		if (chunkSize_ == 0 || tiles.GetTileCount() == 0) {
+			return;
+		}
+		const uint32_t chunkXEnd = std::min(chunkCountX_, (tiles.xEnd + chunkSize_ - 1) / chunkSize_);
+		const uint32_t chunkYEnd = std::min(chunkCountY_, (tiles.yEnd + chunkSize_ - 1) / chunkSize_);
+		for (uint32_t chunkY = tiles.yBegin / chunkSize_; chunkY < chunkYEnd; ++chunkY) {
+			for (uint32_t chunkX = tiles.xBegin / chunkSize_; chunkX < chunkXEnd; ++chunkX) {
+				const ChunkMesh& chunk = GetChunk(chunkX, chunkY);
+				if (!chunk.indices.empty()) {
+					function(chunk);
+				}
+			}
+		}
+	}
+
+	// --- 統計 ---
+	uint32_t GetBlockCount() const { return blockCount_; }
+	uint32_t GetNonEmptyChunkCount() const { return nonEmptyChunkCount_; }
+	uint64_t GetVertexCount() const { return vertexCount_; }
+	uint64_t GetTriangleCount() const { return triangleCount_; }
+	// 直前の Build / BakeDirty で焼いたチャンク数と時間
+	uint32_t GetLastBakedChunkCount() const { return lastBakedChunkCount_; }
+	float GetLastBakeMicroseconds() const { return lastBakeMicroseconds_; }
+
+private:
+	void BakeChunk(ChunkMesh& chunk, const MapChipField& map, const AutotileMap* autotile);
+	// (x, y) はチャンク内のタイル番号。solid_ に読んだ固さで、face の面が見えるか
+	bool IsFaceVisible(uint32_t faceIndex, uint32_t x, uint32_t y) const;
+
+	uint32_t chunkSize_ = 0;
+	uint32_t chunkCountX_ = 0;
+	uint32_t chunkCountY_ = 0;
+	std::vector<ChunkMesh> chunks_;
+	std::vector<uint8_t> isChunkDirty_;
+	std::vector<uint32_t> dirtyChunks_; // 印の付いたチャンクの番号（重複なし）
+	// 焼いているチャンクと周り 1 タイルの固さ（作業領域）
+	std::vector<uint8_t> solid_;
+	uint32_t solidStride_ = 0;
+
+	uint32_t blockCount_ = 0;
+	uint32_t nonEmptyChunkCount_ = 0;
+	uint64_t vertexCount_ = 0;
+	uint64_t triangleCount_ = 0;
+	uint32_t lastBakedChunkCount_ = 0;
+	float lastBakeMicroseconds_ = 0.0f;
+};
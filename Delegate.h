@@ -0,0 +1,113 @@
+#pragma once
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// 固定容量、只能移动的回调。捕获的数据直接存放在对象内部，不会分配堆内存。
+// 捕获超过容量时编译报错（请改为捕获指针）。
+// 可平凡复制的可调用对象（只捕获 this 或指针的 lambda 等）移动时直接 memcpy。
+template<typename Signature, size_t Capacity = 32>
+class Delegate;
+
+template<typename R, typename... Args, size_t Capacity>
+class Delegate<R(Args...), Capacity> {
+public:
+	Delegate() = default;
+	Delegate(std::nullptr_t) {}
+
+	template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Delegate> && std::is_invocable_r_v<R, std::decay_t<F>&, Args...>>>
+	Delegate(F&& callable) {
+		Bind(std::forward<F>(callable));
+	}
+
+	Delegate(const Delegate&) = delete;
+	Delegate& operator=(const Delegate&) = delete;
+
+	Delegate(Delegate&& other) noexcept { MoveFrom(other); }
+
+	Delegate& operator=(Delegate&& other) noexcept {
+		if (this != &other) {
+			Reset();
+			MoveFrom(other);
+		}
+		return *this;
+	}
+
+	Delegate& operator=(std::nullptr_t) {
+		Reset();
+		return *this;
+	}
+
+	~Delegate() { Reset(); }
+
+	template<typename F>
+	void Bind(F&& callable) {
+		using Functor = std::decay_t<F>;
+		static_assert(sizeof(Functor) <= Capacity, "Delegate: capture is too large for the inline storage");
+		static_assert(alignof(Functor) <= alignof(std::max_align_t), "Delegate: capture alignment is not supported");
+		static_assert(std::is_nothrow_move_constructible_v<Functor>, "Delegate: callable must be nothrow movable");
+
+		Reset();
+		::new (static_cast<void*>(storage_)) Functor(std::forward<F>(callable));
+		invoke_ = &InvokeImpl<Functor>;
+		if constexpr (std::is_trivially_copyable_v<Functor>) {
+			relocate_ = nullptr;
+		} else {
+			relocate_ = &RelocateImpl<Functor>;
+		}
+	}
+
+	void Reset() {
+		if (invoke_ && relocate_) {
+			relocate_(storage_, nullptr);
+		}
+		invoke_ = nullptr;
+		relocate_ = nullptr;
+	}
+
+	R operator()(Args... args) const {
+		return invoke_(const_cast<unsigned char*>(storage_), std::forward<Args>(args)...);
+	}
+
+	explicit operator bool() const { return invoke_ != nullptr; }
+
+private:
+	using InvokeFn = R (*)(void*, Args&&...);
+	// dst 为 nullptr 时只析构 src
+	using RelocateFn = void (*)(void* src, void* dst);
+
+	template<typename Functor>
+	static R InvokeImpl(void* storage, Args&&... args) {
+		return (*static_cast<Functor*>(storage))(std::forward<Args>(args)...);
+	}
+
+	template<typename Functor>
+	static void RelocateImpl(void* src, void* dst) {
+		Functor* from = static_cast<Functor*>(src);
+		if (dst) {
+			::new (dst) Functor(std::move(*from));
+		}
+		from->~Functor();
+	}
+
+	void MoveFrom(Delegate& other) {
+		if (!other.invoke_) {
+			return;
+		}
+		if (other.relocate_) {
+			other.relocate_(other.storage_, storage_);
+		} else {
+			std::memcpy(storage_, other.storage_, Capacity);
+		}
+		invoke_ = other.invoke_;
+		relocate_ = other.relocate_;
+		other.invoke_ = nullptr;
+		other.relocate_ = nullptr;
+	}
+
+	alignas(std::max_align_t) unsigned char storage_[Capacity] = {};
+	InvokeFn invoke_ = nullptr;
+	RelocateFn relocate_ = nullptr;
+};
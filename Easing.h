@@ -3,6 +3,21 @@
 using namespace KamataEngine;
 static inline Vector3 Lerp(const Vector3& start, const Vector3& end, float t) { return {start.x + (end.x - start.x) * t, start.y + (end.y - start.y) * t, start.z + (end.z - start.z) * t}; }
 
+// 临界阻尼弹簧（Game Programming Gems 4 的近似解）。
+// 按经过时间积分，帧率不同也会得到相同的曲线。smoothTime 约为到达目标所需的时间。
+static inline float SmoothDamp(float current, float target, float& currentVelocity, float smoothTime, float deltaTime) {
+	if (deltaTime <= 0.0f) {
+		return current;
+	}
+	float omega = 2.0f / (smoothTime > 0.0001f ? smoothTime : 0.0001f);
+	float x = omega * deltaTime;
+	float decay = 1.0f / (1.0f + x + 0.48f * x * x + 0.235f * x * x * x);
+	float change = current - target;
+	float temp = (currentVelocity + omega * change) * deltaTime;
+	currentVelocity = (currentVelocity - omega * temp) * decay;
+	return target + (change + temp) * decay;
+}
+
 static inline float EaseOut(float start, float end, float t) {
 	// イージング関数（Ease Out）
 	return start + (end - start) * (1.0f - (1.0f - t) * (1.0f - t));
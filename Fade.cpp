@@ -1,5 +1,6 @@
 #include "Fade.h"
 #include "algorithm"
+#include "GameClock.h"
 Fade::~Fade() { 
 	delete fadeSprite_;
 	fadeSprite_ = nullptr;
@@ -21,7 +22,7 @@ void Fade::Update() {
 		break;
 	case Fade::Status::kFadeIn:
 		
-		counter_ += 1.0f / 60.0f; // タイマー更新
+		counter_ += GameClock::kFixedDeltaTime; // タイマー更新
 		fadeSprite_->SetColor(Vector4(0, 0, 0, std::clamp(1 - counter_ / duration_, 0.0f, 1.0f)));
 		if (counter_ >= duration_) {
 			counter_ = duration_;    // タイマーリセット
@@ -30,7 +31,7 @@ void Fade::Update() {
 		break;
 	case Fade::Status::kFadeOut:
 		
-		counter_ += 1.0f / 60.0f; // タイマー更新
+		counter_ += GameClock::kFixedDeltaTime; // タイマー更新
 		fadeSprite_->SetColor(Vector4(0, 0, 0, std::clamp(counter_ / duration_, 0.0f, 1.0f)));
 		if (counter_ >= duration_) {
 			counter_ = duration_;    // タイマーリセット
@@ -78,6 +79,17 @@ bool Fade::isFinished() const {
 	return true;
 }
 
+float Fade::GetAlpha() const {
+	switch (status_) {
+	case Fade::Status::kFadeIn:
+		return std::clamp(1 - counter_ / duration_, 0.0f, 1.0f);
+	case Fade::Status::kFadeOut:
+		return std::clamp(counter_ / duration_, 0.0f, 1.0f);
+	default:
+		return 0.0f;
+	}
+}
+
 void Fade::Start(Status status, float duration) { 
 	status_ = status; 
 	duration_ = duration;
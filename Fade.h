@@ -14,6 +14,8 @@ public:
 	void Update();
 	void Draw();
 	bool isFinished() const;
+	// 現在のフェードの不透明度（フェードしていなければ 0）
+	float GetAlpha() const;
 
 	void Start(Status status,float duration_);
 	void Stop();
@@ -0,0 +1,23 @@
+#pragma once
+#include <cstdint>
+
+// ゲーム内時間の定数。シミュレーションは固定 60Hz で進める。
+namespace GameClock {
+	inline constexpr uint32_t kTicksPerSecond = 60;
+	inline constexpr float kFixedDeltaTime = 1.0f / static_cast<float>(kTicksPerSecond);
+
+	// 秒 -> tick（切り上げ、最低 1 tick）
+	inline uint32_t SecondsToTicks(float seconds) {
+		if (seconds <= 0.0f) {
+			return 1;
+		}
+		float ticks = seconds * static_cast<float>(kTicksPerSecond);
+		uint32_t wholeTicks = static_cast<uint32_t>(ticks);
+		if (static_cast<float>(wholeTicks) < ticks) {
+			wholeTicks++;
+		}
+		return wholeTicks > 0 ? wholeTicks : 1;
+	}
+
+	inline float TicksToSeconds(uint64_t ticks) { return static_cast<float>(ticks) * kFixedDeltaTime; }
+}
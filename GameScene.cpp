@@ -3,18 +3,80 @@
 #include "SceneManager.h"
 #include "Player.h"
 #include "Goal.h"
+#include "AssetManager.h"
+#include "LevelRegistry.h"
+#include "Profiler.h"
+#include "AllocTracker.h"
+#include "Logger.h"
+#include "JobSystem.h"
+#include "ModelInstanceBackend.h"
 #include <algorithm>
+#include <chrono>
 using namespace KamataEngine;
 
+namespace {
+	// 资源缓存中的名字
+	const char* const kBlockModelName = "base_block";
+	const char* const kPlayerModelName = "player";
+	const char* const kGoalModelName = "goal";
+	const char* const kSkydomeModelName = "skydome";
+	const char* const kTitleTextureName = "title.png";
+
+	// 粒子效果（速度和重力为每秒的值）
+	ParticleEmitterDesc MakeDeathEffect() {
+		ParticleEmitterDesc desc;
+		desc.burstCount = 96;
+		desc.speedMin = 4.0f;
+		desc.speedMax = 10.0f;
+		desc.lifetimeMin = 0.5f;
+		desc.lifetimeMax = 1.0f;
+		desc.size = 0.15f;
+		desc.color = {1.0f, 0.25f, 0.2f, 1.0f};
+		desc.collidesWithTiles = true;
+		return desc;
+	}
+	ParticleEmitterDesc MakeGoalEffect() {
+		// 最初に一次喷出，之后在淡出期间持续向上冒
+		ParticleEmitterDesc desc;
+		desc.burstCount = 64;
+		desc.rate = 90.0f;
+		desc.duration = 1.0f;
+		desc.spread = 1.2f;
+		desc.speedMin = 3.0f;
+		desc.speedMax = 7.0f;
+		desc.lifetimeMin = 0.6f;
+		desc.lifetimeMax = 1.2f;
+		desc.gravity = 4.0f;
+		desc.size = 0.12f;
+		desc.color = {1.0f, 0.85f, 0.2f, 1.0f};
+		return desc;
+	}
+	ParticleEmitterDesc MakeLandingEffect() {
+		ParticleEmitterDesc desc;
+		desc.burstCount = 12;
+		desc.spread = 2.4f;
+		desc.speedMin = 1.5f;
+		desc.speedMax = 3.5f;
+		desc.lifetimeMin = 0.2f;
+		desc.lifetimeMax = 0.4f;
+		desc.gravity = 8.0f;
+		desc.size = 0.1f;
+		desc.color = {0.8f, 0.8f, 0.75f, 1.0f};
+		desc.collidesWithTiles = true;
+		return desc;
+	}
+	const ParticleEmitterDesc kDeathEffect = MakeDeathEffect();
+	const ParticleEmitterDesc kGoalEffect = MakeGoalEffect();
+	const ParticleEmitterDesc kLandingEffect = MakeLandingEffect();
+	// 下落速度（每 tick）超过这个值落地时才扬起灰尘
+	constexpr float kLandingDustSpeed = 0.3f;
+}
+
 GameScene::~GameScene() {
 	if (debugCamera_) {
 		delete debugCamera_;
 		debugCamera_ = nullptr;
 	}
-	if (mapChipField_) {
-		delete mapChipField_;
-		mapChipField_ = nullptr;
-	}
 	for (std::vector<WorldTransform*>& worldTransformLine : worldTransformBlocks_) {
 		for (WorldTransform* worldTransform : worldTransformLine) {
 			delete worldTransform;
@@ -23,40 +85,46 @@ GameScene::~GameScene() {
 	}
 	worldTransformBlocks_.clear();
 
+	// 模型归资源缓存所有，这里只释放引用
+	AssetCache<Model*>& models = AssetManager::GetInstance().GetModels();
 	if (blockModel_) {
-		delete blockModel_;
+		models.Release(kBlockModelName);
 		blockModel_ = nullptr;
 	}
 
 	if (playerModel_) {
-		delete playerModel_;
+		models.Release(kPlayerModelName);
 		playerModel_ = nullptr;
 	}
 	if (goalModel_) {
-		delete goalModel_;
+		models.Release(kGoalModelName);
 		goalModel_ = nullptr;
 	}
 
 	if (skydomeModel_) {
-		delete skydomeModel_;
+		models.Release(kSkydomeModelName);
 		skydomeModel_ = nullptr;
 	}
 
 	 if (titleSprite_) {
 		delete titleSprite_;
 		titleSprite_ = nullptr;
+		AssetManager::GetInstance().GetTextures().Release(kTitleTextureName);
 	}
 
 }
 
 void GameScene::Initialize() {
 	sceneName_ = "GameScene";
-	blockModel_ = Model::CreateFromOBJ("base_block");
-	playerModel_ = Model::CreateFromOBJ("player");
-	goalModel_ = Model::CreateFromOBJ("goal");
-	skydomeModel_ = Model::CreateFromOBJ("skydome");
-
-	titleSprite_ = Sprite::Create(TextureManager::Load("title.png"), Vector2(0, 0));
+	// 第一次之后都从缓存中取得，不再重新读取 OBJ
+	AssetCache<Model*>& models = AssetManager::GetInstance().GetModels();
+	blockModel_ = models.Acquire(kBlockModelName);
+	playerModel_ = models.Acquire(kPlayerModelName);
+	goalModel_ = models.Acquire(kGoalModelName);
+	skydomeModel_ = models.Acquire(kSkydomeModelName);
+
+	titleTextureHandle_ = AssetManager::GetInstance().GetTextures().Acquire(kTitleTextureName);
+	titleSprite_ = Sprite::Create(titleTextureHandle_, Vector2(0, 0));
 	titleSprite_->SetSize(Vector2(1280.0f, 720.0f));
 	
 }
@@ -64,15 +132,13 @@ void GameScene::Initialize() {
 void GameScene::OnEnter() {  
     // ワールドトランスフォームの初期化  
     worldTransform_.Initialize();  
-    mapChipField_ = new MapChipField();
     
     // 初始化游戏阶段相关变量
     currentStage_ = GameStage::kPreparation;
     previousStage_ = GameStage::kPreparation;
     hasLeftSpawn_ = false;
-    stageTransitionTimer_ = 0.0f;
     isPendingSceneChange_ = false;
-    sceneChangeTimer_ = 0.0f;
+    isSceneChangeReady_ = false;
 
     // 初始化倒计时相关变量
     gameLifeTime_ = maxGameLifeTime_;
@@ -87,30 +153,24 @@ void GameScene::OnEnter() {
 	fade_->Initialize();
 	fade_->Start(Fade::Status::kFadeIn, 0.5f); // 1秒淡入
 
-    
-	if (mapID != 0) {
-		std::string mapPath = "Resources/map/level" + std::to_string(mapID) + ".csv";
+	instanceBackend_ = std::make_unique<ModelInstanceBackend>(&camera_);
 
-
-		try {
-			mapChipField_->LoadMapChipCsv(mapPath);
-		} catch (...) {
-
-			mapChipField_->LoadMapChipCsv("Resources/map/test.csv");
-		}
-	} else {
-		std::string mapPath = "Resources/map/select.csv";
-
-		try {
-			mapChipField_->LoadMapChipCsv(mapPath);
-		} catch (...) {
-
-			mapChipField_->LoadMapChipCsv("Resources/map/test.csv");
-		}
+    
+	// 没有预加载的关卡数据时在这里同步构建
+	if (!levelData_ || levelData_->mapID != mapID) {
+		levelData_ = BuildLevelData(mapID);
 	}
+	PublishMap(std::move(levelData_->mapChipField));
+	autotile_ = std::move(levelData_->autotile);
+	blockMeshes_ = std::move(levelData_->blockMeshes);
 
 
     GenerateBlocks();  
+	// 粒子的容量在这里一次分配，之后的更新和喷出不再分配
+	particles_.Initialize(kParticleCapacity);
+	if (player_) {
+		player_->SetInputSource(playerInputSource_);
+	}
 
     // カメラの初期化  
 	camera_.Initialize();
@@ -125,69 +185,169 @@ void GameScene::OnEnter() {
     // Calculate and set map bounds for camera
     SetCameraMapBounds();
 
-#ifdef _DEBUG
-    printf("GameScene: Entered with Map ID %d, Stage: Preparation\n", mapID);
+    // 阶段流程：准备 -> 游戏 -> 结束
+    sequenceRunner_.Start(RunStageSequence());
+
+    LOG_DEBUG(LogCategory::kScene, "GameScene: Entered with Map ID %d, Stage: Preparation", mapID);
+#ifdef USE_HOT_RELOAD
+    // 监视当前关卡的地图文件
+    if (!levelData_->mapPath.empty()) {
+        mapHotReloader_.Start(levelData_->mapPath, mapStore_, levelData_->mapChecksum);
+    }
 #endif
 
     #ifdef _DEBUG  
-    // 座標軸  
-    AxisIndicator::GetInstance()->SetVisible(true);  
-    AxisIndicator::GetInstance()->SetTargetCamera(&debugCamera_->GetCamera());  
-    PrimitiveDrawer::GetInstance()->SetCamera(&camera_);  
+    // 座標軸（调试 UI 关闭时主线程可能在绘制，不让它引用本场景的相机）
+    if (isDebugUIEnabled_) {
+        AxisIndicator::GetInstance()->SetVisible(true);  
+        AxisIndicator::GetInstance()->SetTargetCamera(&debugCamera_->GetCamera());  
+        PrimitiveDrawer::GetInstance()->SetCamera(&camera_);  
+    }
     #endif // DEBUG  
 }
 
 void GameScene::Update() {
-	// 更新游戏阶段
-	UpdateGameStage();
-	
+	PROFILE_FUNCTION();
+#ifdef USE_HOT_RELOAD
+	// 在分配检查之外反映（重新加载本身会分配）
+	ApplyMapReload();
+#endif
+#ifdef USE_ALLOC_TRACKER
+	// 预热若干 tick 后，游戏阶段的每一帧都不应再进行堆分配
+	gameplayTickCount_ = currentStage_ == GameStage::kGameplay ? gameplayTickCount_ + 1 : 0;
+	AllocTracker::TickScope allocScope("GameScene::Update", gameplayTickCount_ > kAllocCheckWarmupTicks);
+#endif
+
+	{
+		PROFILE_SCOPE("GameScene::Update::Stage");
+		// 推进计时器（到期的回调在这里统一执行）
+		timerWheel_.Advance();
+
+		// 更新游戏阶段（阶段流程由协程推进，每个序列每 tick 最多恢复一次）
+		fade_->Update();
+		sequenceRunner_.Tick();
+	}
+
+	// 序列请求的场景切换在 Tick 之后执行（切换会立即释放本场景）
+	if (isSceneChangeReady_) {
+		SceneManager::GetInstance().SetNextMapID(pendingTargetMapID_);
+		SceneManager::GetInstance().ChangeScene(SceneManager::SceneType::kGame);
+		return;
+	}
 
 	// 根据当前阶段执行不同的逻辑
 	switch (currentStage_) {
 	case GameStage::kPreparation:
-		
-		HandlePreparationStage();
 		break;
 	case GameStage::kGameplay:
 		HandleGameplayStage();
 		break;
 	case GameStage::kEnding:
-		HandleEndingStage();
-		return; // 结束阶段时不进行其他更新
+		// 结束阶段时只推进死亡和终点的粒子
+		UpdateParticles();
+		return;
 	}
 
-	CameraUpdate();
+	JobSystem& jobs = JobSystem::GetInstance();
+
+	// 相机（含可见范围）、物体和天空盒互不依赖，作为一批任务并行更新
+	{
+		PROFILE_SCOPE("GameScene::Update::Objects");
+		JobCounter counter;
+		// 固定 tick 时用 tick 的时间；否则用实际的帧间隔（长的卡顿截断为 0.1 秒）
+		float cameraDeltaTime = GameClock::kFixedDeltaTime;
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		if (!isFixedTimestep_ && hasCameraUpdateTime_) {
+			std::chrono::duration<float> elapsed = now - lastCameraUpdateTime_;
+			cameraDeltaTime = std::min(elapsed.count(), 0.1f);
+		}
+		lastCameraUpdateTime_ = now;
+		hasCameraUpdateTime_ = true;
+		auto updateCamera = [this, cameraDeltaTime]() {
+			PROFILE_SCOPE("GameScene::Update::Camera");
+			CameraUpdate(cameraDeltaTime);
+			UpdateVisibleTileRange();
+		};
+		auto updateObjects = [this](uint32_t begin, uint32_t end) {
+			for (uint32_t i = begin; i < end; ++i) {
+				objects_[i]->Update();
+			}
+		};
+		auto updateSkydome = [this]() { skydome_->Update(); };
+		// 敌人使用上一帧的玩家位置
+		const Vector3 playerPosition = player_ ? player_->GetTranslation() : Vector3{};
+		auto updateAgents = [this, playerPosition]() { agents_.Update(*mapChipField_, playerPosition); };
+		auto updateParticles = [this]() { UpdateParticles(); };
+		jobs.Run(counter, updateCamera);
+		jobs.ParallelFor(counter, static_cast<uint32_t>(objects_.size()), kObjectsPerJob, updateObjects);
+		jobs.Run(counter, updateSkydome);
+		jobs.Run(counter, updateAgents);
+		jobs.Run(counter, updateParticles);
+		jobs.Wait(counter);
+	}
+
+	// 只更新相机可见范围内的方块。按行分批交给工作线程，主线程同时更新玩家（方块变换不读玩家状态）
+	JobCounter blockCounter;
+	const float blockScale = currentBlockScale_;
+	auto updateBlockRows = [this, blockScale](uint32_t begin, uint32_t end) {
+		PROFILE_SCOPE("GameScene::Update::Blocks");
+		for (uint32_t i = visibleTileRange_.yBegin + begin; i < visibleTileRange_.yBegin + end; ++i) {
+			for (uint32_t j = visibleTileRange_.xBegin; j < visibleTileRange_.xEnd; ++j) {
+				WorldTransform* worldTransformBlock = worldTransformBlocks_[i][j];
+				if (!worldTransformBlock)
+					continue;
+				// 缩放在这里应用，屏幕外的方块进入视野时再更新
+				worldTransformBlock->scale_ = {blockScale, blockScale, blockScale};
+				// Affine行列を作成（転送は描画時にインスタンスバックエンドで行う）
+				worldTransformBlock->MakeAffineMatrix4x4();
+			}
+		}
+	};
+	const uint32_t visibleColumns = std::max(visibleTileRange_.xEnd - visibleTileRange_.xBegin, 1u);
+	jobs.ParallelFor(blockCounter, visibleTileRange_.yEnd - visibleTileRange_.yBegin, std::max(kBlocksPerJob / visibleColumns, 1u), updateBlockRows);
 
 	if (player_ && !player_->GetIsDead()) {
+		PROFILE_SCOPE("GameScene::Update::Player");
 		player_->Update();
-		
+		CheckGoalTriggers();
+
+		// 落地扬起灰尘（脚下）
+		if (player_->GetLandingSpeed() > kLandingDustSpeed) {
+			Vector3 feetPosition = player_->GetTranslation();
+			feetPosition.y -= player_->GetPlayerSize().y * 0.5f;
+			particles_.Burst(kLandingEffect, feetPosition);
+		}
+
 		// 检查玩家是否死亡（比如掉出地图边界）
 		Vector3 playerPos = player_->GetTranslation();
 		if (playerPos.y < -20.0f) { // 如果玩家掉到地图下方
 			OnPlayerDeath();
+		} else if (agents_.FindOverlap(playerPos, player_->GetPlayerSize()) != UINT32_MAX) {
+			// 通过敌人的网格只检查玩家附近的敌人
+			OnPlayerDeath();
 		}
 	}
-	
-	for (std::unique_ptr<Object3d>& object : objects_) {
-		object->Update();
-	}
-	
-	for (std::vector<WorldTransform*>& worldTransformBlockX : worldTransformBlocks_) {
-		for (WorldTransform* worldTransformBlock : worldTransformBlockX) {
-			if (!worldTransformBlock)
-				continue;
-			// Affine行列を作成
-			worldTransformBlock->MakeAffineMatrix4x4();
-			worldTransformBlock->TransferMatrix();
-		}
-	}
-	skydome_->Update();
+
+	jobs.Wait(blockCounter);
+#ifdef USE_ALLOC_TRACKER
+	// 调试 UI 不计入
+	allocScope.End();
+#endif
 #ifdef _DEBUG
+	// 调试 UI（ImGui 只能在主线程调用，模拟线程模式下关闭）
+	if (isDebugUIEnabled_) {
+		DrawDebugUI();
+	}
+#endif
+}
 
+#ifdef _DEBUG
+void GameScene::DrawDebugUI() {
 	ImGui::Begin("Game Scene Debug");
 	ImGui::Text("Scene Name: %s", sceneName_.c_str());
 	ImGui::Text("Map ID: %d", mapID);
 	ImGui::Text("Map Size: %dx%d", mapChipField_->GetNumBlockHorizontal(), mapChipField_->GetNumBlockVertical());
+	ImGui::Text("Map Epoch: %llu (%zu retired)", static_cast<unsigned long long>(mapStore_.GetEpoch()), mapStore_.GetRetiredCount());
 	ImGui::Text("Objects Count: %d", static_cast<int>(objects_.size()));
 	
 	// 游戏阶段信息
@@ -219,6 +379,53 @@ void GameScene::Update() {
 	ImGui::ProgressBar(scaleRatio, ImVec2(0.0f, 0.0f), "");
 	ImGui::SameLine(0.0f, ImGui::GetStyle().ItemInnerSpacing.x);
 	ImGui::Text("Scale: %.1f%%", currentBlockScale_ * 100.0f);
+
+	// 实例批次信息（上一帧）
+	ImGui::Separator();
+	ImGui::Text("=== BLOCK INSTANCING ===");
+	ImGui::Text("Batches: %u  Instances: %u", instanceBatchBuilder_.GetBatchCount(), instanceBatchBuilder_.GetInstanceCount());
+	ImGui::Text("Batch Build: %.1f us", instanceBatchBuilder_.GetLastBuildMicroseconds());
+	ImGui::Text("Autotile: %u variants (%s)", AutotileMap::GetVariantCount(autotile_.GetMode()), autotile_.GetMode() == AutotileMode::kFourNeighbor ? "4-neighbor" : "8-neighbor");
+	// 合并网格：可见范围内有内容的区块数即合并后的绘制次数
+	uint32_t visibleChunkCount = 0;
+	uint32_t visibleChunkTriangleCount = 0;
+	blockMeshes_.ForEachChunkInRange(visibleTileRange_, [&](const ChunkMesh& chunk) {
+		visibleChunkCount++;
+		visibleChunkTriangleCount += chunk.GetTriangleCount();
+	});
+	ImGui::Text("Chunk Mesh: %u chunks, %llu tris (%llu as cubes)", blockMeshes_.GetNonEmptyChunkCount(), static_cast<unsigned long long>(blockMeshes_.GetTriangleCount()),
+	            static_cast<unsigned long long>(blockMeshes_.GetBlockCount()) * ChunkMeshBaker::kCubeTriangleCount);
+	ImGui::Text("Visible: %u draws, %u tris  Last Bake: %u chunks %.1f us", visibleChunkCount, visibleChunkTriangleCount, blockMeshes_.GetLastBakedChunkCount(), blockMeshes_.GetLastBakeMicroseconds());
+
+	// 关卡加载 / 切换耗时
+	ImGui::Separator();
+	ImGui::Text("=== LEVEL LOADING ===");
+	ImGui::Text("Level Build: %.2f ms (%s)", levelData_ ? levelData_->buildMilliseconds : 0.0f, SceneManager::GetInstance().WasLastLevelPreloaded() ? "preloaded" : "sync");
+	ImGui::Text("Handover Wait: %.2f ms", SceneManager::GetInstance().GetLastHandoverWaitMilliseconds());
+	ImGui::Text("Scene Change: %.2f ms", SceneManager::GetInstance().GetLastSceneChangeMilliseconds());
+	const LevelEntry* levelEntry = LevelRegistry::GetInstance().Find(mapID);
+	if (levelEntry) {
+		ImGui::Text("Level Entry: %s (%ux%u) next=%d return=%d", levelEntry->path.c_str(), levelEntry->width, levelEntry->height, levelEntry->nextID, levelEntry->returnID);
+	}
+	ImGui::Text("Timer Wheel: %u active, %u expired last tick", timerWheel_.GetActiveCount(), timerWheel_.GetLastExpiredCount());
+	ImGui::Text("Registry Errors: %zu", LevelRegistry::GetInstance().GetErrors().size());
+	ImGui::Text("In-place Restart: %.1f us (count %u)", lastRestartMicroseconds_, restartCount_);
+	ImGui::Text("Agents: %zu, update %.1f us", agents_.GetCount(), agents_.GetLastUpdateMicroseconds());
+	ImGui::Text("Particles: %u / %u, %u emitters, update %.1f us, dropped %llu", particles_.GetCount(), particles_.GetCapacity(), particles_.GetActiveEmitterCount(),
+	            particles_.GetLastUpdateMicroseconds(), static_cast<unsigned long long>(particles_.GetDroppedCount()));
+#ifdef USE_HOT_RELOAD
+	ImGui::Text("Hot Reload: %.2f ms, %u tiles (count %u, unchanged %u)", lastHotReloadMilliseconds_, lastHotReloadTileCount_, hotReloadCount_,
+	            mapHotReloader_.GetUnchangedCount());
+#endif
+	AssetCache<Model*>& cachedModels = AssetManager::GetInstance().GetModels();
+	ImGui::Text("Model Cache: %zu entries, %u loads, %u hits", cachedModels.GetSize(), cachedModels.GetLoadCount(), cachedModels.GetHitCount());
+
+	// 瓦片剔除信息
+	ImGui::Separator();
+	ImGui::Text("=== TILE CULLING ===");
+	ImGui::Text("Visible Range: x[%u, %u) y[%u, %u)", visibleTileRange_.xBegin, visibleTileRange_.xEnd, visibleTileRange_.yBegin, visibleTileRange_.yEnd);
+	ImGui::Text("Visited Tiles: %u / %u", visitedTileCount_, totalTileCount_);
+	ImGui::SliderInt("Culling Margin (tiles)", &tileCullingMargin_, 0, 8);
 	
 	if (player_) {
 		Vector3 playerPos = player_->GetTranslation();
@@ -243,16 +450,20 @@ void GameScene::Update() {
 		}
 	}
 	
-	if (currentStage_ == GameStage::kEnding) {
-		ImGui::Text("Stage Transition Timer: %.2f / %.2f", stageTransitionTimer_, endingStageDelay_);
-		ImGui::ProgressBar(stageTransitionTimer_ / endingStageDelay_);
+	// 玩家和各 Goal 自己的调试窗口（它们的 Update 可能不在主线程上执行，所以在这里显示）
+	if (player_) {
+		player_->ShowDebugWindow();
+	}
+	for (Goal* goal : goals_) {
+		goal->ShowDebugWindow();
 	}
 	
+	ImGui::Text("Sequences: %u active, %u resumed last tick", sequenceRunner_.GetActiveCount(), sequenceRunner_.GetLastResumeCount());
+	ImGui::Text("Sequence Frames: %u / %u pooled, %u heap fallbacks", SequenceFramePool::GetUsedCount(), SequenceFramePool::kBlockCount, SequenceFramePool::GetFallbackCount());
+
 	if (isPendingSceneChange_) {
 		ImGui::Text("Scene Change Pending...");
-		ImGui::Text("Timer: %.2f / %.2f", sceneChangeTimer_, sceneChangeDelay_);
 		ImGui::Text("Target Map ID: %d", pendingTargetMapID_);
-		ImGui::ProgressBar(sceneChangeTimer_ / sceneChangeDelay_);
 	} else {
 		ImGui::Text("Scene Change: Ready");
 	}
@@ -278,8 +489,8 @@ void GameScene::Update() {
 	// 阶段控制测试
 	ImGui::Separator();
 	ImGui::Text("Stage Control Testing:");
-	if (ImGui::Button("Reset to Preparation")) {
-		SetGameStage(GameStage::kPreparation);
+	if (ImGui::Button("Restart Level")) {
+		RestartLevel();
 	}
 	ImGui::SameLine();
 	if (ImGui::Button("Force Player Death")) {
@@ -290,18 +501,18 @@ void GameScene::Update() {
 	ImGui::Separator();
 	ImGui::Text("Timer & Scaling Testing:");
 	if (ImGui::Button("Reset Timer")) {
-		gameLifeTime_ = maxGameLifeTime_;
+		SetLifeTime(maxGameLifeTime_);
 		currentBlockScale_ = 1.0f;
 		UpdateBlockScaling();
 	}
 	ImGui::SameLine();
 	if (ImGui::Button("Set Timer to 5s")) {
-		gameLifeTime_ = 5.0f;
+		SetLifeTime(5.0f);
 		UpdateBlockScaling();
 	}
 	ImGui::SameLine();
 	if (ImGui::Button("Set Timer to 1s")) {
-		gameLifeTime_ = 1.0f;
+		SetLifeTime(1.0f);
 		UpdateBlockScaling();
 	}
 	
@@ -330,7 +541,7 @@ void GameScene::Update() {
 		for (const auto& object : objects_) {
 			Goal* goal = dynamic_cast<Goal*>(object.get());
 			if (goal && goal->IsActive()) {
-				printf("Debug: Manually triggering Goal collision\n");
+				LOG_DEBUG(LogCategory::kScene, "Debug: Manually triggering Goal collision");
 				OnGoalCollision(goal);
 				break;
 			}
@@ -398,7 +609,7 @@ void GameScene::Update() {
 		for (const auto& object : objects_) {
 			Goal* goal = dynamic_cast<Goal*>(object.get());
 			if (goal && goal->IsActive()) {
-				printf("Debug: Manual Goal collision test (G key pressed)\n");
+				LOG_DEBUG(LogCategory::kScene, "Debug: Manual Goal collision test (G key pressed)");
 				OnGoalCollision(goal);
 				break;
 			}
@@ -408,7 +619,7 @@ void GameScene::Update() {
 	// 新的键盘快捷键
 	if (Input::GetInstance()->TriggerKey(DIK_R)) {
 		// R键重置计时器
-		gameLifeTime_ = maxGameLifeTime_;
+		SetLifeTime(maxGameLifeTime_);
 		currentBlockScale_ = 1.0f;
 		UpdateBlockScaling();
 	}
@@ -441,10 +652,11 @@ void GameScene::Update() {
 	ImGui::Text("8. Press R to reset timer");
 	ImGui::Text("9. Press T to toggle block scaling");
 	ImGui::Text("10. Timer starts when entering gameplay stage");
-#endif // _DEBUG
 }
+#endif
 
 void GameScene::Draw() { 
+	PROFILE_FUNCTION();
 	
 	//DirectXCommon* dxCommon = DirectXCommon::GetInstance();
 	Model::PreDraw();
@@ -458,14 +670,30 @@ void GameScene::Draw() {
 		object->Draw();
 	}
 
-	for (std::vector<WorldTransform*>& worldTransformLine : worldTransformBlocks_) {
-		for (WorldTransform* worldTransform : worldTransformLine) {
+	// 天空穹先画：粒子淡出时是半透明的，要和已经画好的背景混合
+	skydome_->Draw(camera_);
+
+	// 方块按模型收集成实例批次，一次提交
+	PROFILE_SCOPE("GameScene::Draw::Blocks");
+	instanceBatchBuilder_.Begin();
+	for (uint32_t i = visibleTileRange_.yBegin; i < visibleTileRange_.yEnd; ++i) {
+		for (uint32_t j = visibleTileRange_.xBegin; j < visibleTileRange_.xEnd; ++j) {
+			WorldTransform* worldTransform = worldTransformBlocks_[i][j];
 			if (worldTransform) {
-				blockModel_->Draw(*worldTransform,camera_);
+				instanceBatchBuilder_.Add(blockModel_, worldTransform->matWorld_, {1.0f, 1.0f, 1.0f, 1.0f}, autotile_.GetVariant(j, i));
 			}
 		}
 	}
-	skydome_->Draw(camera_);
+	// 敌人用方块模型绘制，颜色按种类区分（后端通过 ObjectColor 着色），和地形区分开
+	ForEachVisibleAgent([this](uint32_t index) { instanceBatchBuilder_.Add(blockModel_, agents_.GetWorldMatrix(index), AgentSystem::GetColor(agents_.GetKind(index))); });
+	// 粒子也用方块模型（实例数据在 Update 中已经生成）。同一模型的实例按添加顺序绘制，
+	// 所以粒子排在不透明的方块和敌人之后，alpha 随寿命淡出。粒子之间不按深度排序
+	for (uint32_t i = 0; i < particles_.GetInstanceCount(); ++i) {
+		const InstanceData& instance = particles_.GetInstances()[i];
+		instanceBatchBuilder_.Add(blockModel_, instance.matWorld, instance.color);
+	}
+	instanceBatchBuilder_.End();
+	instanceBackend_->Submit(instanceBatchBuilder_);
 
 	Model::PostDraw();
 	fade_->Draw();
@@ -484,7 +712,117 @@ void GameScene::Draw() {
 
 void GameScene::OnExit() {}
 
+void GameScene::BuildRenderSnapshot(RenderSnapshot& snapshot) const {
+	PROFILE_FUNCTION();
+	snapshot.hasScene = mapChipField_ != nullptr;
+	snapshot.matView = camera_.matView;
+	snapshot.matProjection = camera_.matProjection;
+
+	// 与 Draw 相同，只收集可见范围内的方块
+	snapshot.blockInstances.clear();
+	for (uint32_t i = visibleTileRange_.yBegin; i < visibleTileRange_.yEnd; ++i) {
+		for (uint32_t j = visibleTileRange_.xBegin; j < visibleTileRange_.xEnd; ++j) {
+			const WorldTransform* worldTransform = worldTransformBlocks_[i][j];
+			if (worldTransform) {
+				InstanceData instance;
+				instance.matWorld = worldTransform->matWorld_;
+				instance.variant = autotile_.GetVariant(j, i);
+				snapshot.blockInstances.push_back(instance);
+			}
+		}
+	}
+
+	ForEachVisibleAgent([this, &snapshot](uint32_t index) {
+		InstanceData instance;
+		instance.matWorld = agents_.GetWorldMatrix(index);
+		instance.color = AgentSystem::GetColor(agents_.GetKind(index));
+		snapshot.blockInstances.push_back(instance);
+	});
+	snapshot.blockInstances.insert(snapshot.blockInstances.end(), particles_.GetInstances(), particles_.GetInstances() + particles_.GetInstanceCount());
+
+	snapshot.hasPlayer = player_ != nullptr;
+	if (player_) {
+		snapshot.playerMatrix = player_->GetWorldMatrix();
+	}
+	snapshot.goalMatrices.clear();
+	for (const Goal* goal : goals_) {
+		snapshot.goalMatrices.push_back(goal->GetWorldMatrix());
+	}
+	snapshot.skydomeMatrix = skydome_->GetWorldMatrix();
+	snapshot.fadeAlpha = fade_->GetAlpha();
+	snapshot.isTitleVisible = currentStage_ == GameStage::kPreparation && mapID == 0;
+}
+
+void GameScene::PublishMap(std::unique_ptr<MapChipField> mapChipField) {
+	mapChipField_ = &mapStore_.Publish(std::move(mapChipField))->field;
+	if (player_) {
+		player_->SetMapChipField(mapChipField_);
+	}
+}
+
+#ifdef USE_HOT_RELOAD
+void GameScene::ApplyMapReload() {
+	std::unique_ptr<MapReload> reload = mapHotReloader_.TakeReload();
+	if (!reload) {
+		return;
+	}
+	PROFILE_FUNCTION();
+	// 预加载的关卡数据可能读的是改之前的文件
+	SceneManager::GetInstance().CancelPreload();
+	if (reload->isResized) {
+		// 尺寸变了，所有方块的位置都会变，重新进入场景
+		LOG_INFO(LogCategory::kLevel, "GameScene: %s was resized, reloading the scene", reload->path.c_str());
+		pendingTargetMapID_ = mapID;
+		isSceneChangeReady_ = true;
+		return;
+	}
+	// 差分之后又发布过地图时，重新和当前地图比较
+	if (reload->baseEpoch != mapStore_.GetEpoch()) {
+		DiffMapChipFields(*mapChipField_, *reload->field, reload->changes);
+	}
+
+	uint32_t objectTileCount = 0;
+	for (const MapTileChange& change : reload->changes) {
+		bool wasBlock = change.before == MapChipType::kBlock;
+		bool isBlock = change.after == MapChipType::kBlock;
+		WorldTransform*& worldTransform = worldTransformBlocks_[change.yIndex][change.xIndex];
+		if (wasBlock != isBlock) {
+			// 周围方块的拼接种类和所在区块的网格也一起更新
+			autotile_.SetSolid(change.xIndex, change.yIndex, isBlock);
+			blockMeshes_.MarkTileChanged(change.xIndex, change.yIndex);
+		}
+		if (wasBlock && !isBlock) {
+			delete worldTransform;
+			worldTransform = nullptr;
+		} else if (!wasBlock && isBlock) {
+			worldTransform = new WorldTransform();
+			worldTransform->translation_ = reload->field->GetMapChipPositionByIndex(change.xIndex, change.yIndex);
+			worldTransform->scale_ = {currentBlockScale_, currentBlockScale_, currentBlockScale_};
+			worldTransform->MakeAffineMatrix4x4();
+		}
+		bool wasObject = !wasBlock && change.before != MapChipType::kBlank;
+		bool isObject = !isBlock && change.after != MapChipType::kBlank;
+		if (wasObject || isObject) {
+			objectTileCount++;
+		}
+	}
+	PublishMap(std::move(reload->field));
+	blockMeshes_.BakeDirty(*mapChipField_, &autotile_);
+
+	std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now().time_since_epoch() - std::chrono::nanoseconds(reload->detectedTimestamp);
+	lastHotReloadMilliseconds_ = elapsed.count();
+	lastHotReloadTileCount_ = static_cast<uint32_t>(reload->changes.size());
+	hotReloadCount_++;
+	LOG_INFO(LogCategory::kLevel, "GameScene: Applied %u changed tiles in %.2f ms after detection", lastHotReloadTileCount_, lastHotReloadMilliseconds_);
+	if (objectTileCount > 0) {
+		// 出生点、终点和敌人是物体，不做增量更新
+		LOG_WARNING(LogCategory::kLevel, "GameScene: %u spawn/goal/agent tiles changed, re-enter the level to apply them", objectTileCount);
+	}
+}
+#endif
+
 void GameScene::GenerateBlocks() {
+	PROFILE_FUNCTION();
 
 		// 要素数
 	uint32_t numBlockVertical = mapChipField_->GetNumBlockVertical();
@@ -495,101 +833,97 @@ void GameScene::GenerateBlocks() {
 	int spawnCount = 0;
 	int blockCount = 0;
 
-#ifdef _DEBUG
-	printf("GameScene: Generating blocks for %dx%d map\n", numBlockHorizontal, numBlockVertical);
-#endif
+	LOG_DEBUG(LogCategory::kScene, "GameScene: Generating blocks for %dx%d map", numBlockHorizontal, numBlockVertical);
 
 	// 要素数を変更する
 	// 列数を設定（縦方向のブロック数）"
 	worldTransformBlocks_.resize(numBlockVertical);
 	for (uint32_t i = 0; i < numBlockVertical; i++) {
-		worldTransformBlocks_[i].resize(numBlockHorizontal);
+		worldTransformBlocks_[i].resize(numBlockHorizontal, nullptr);
 	}
-	for (uint32_t i = 0; i < numBlockVertical; i++) {
-		for (uint32_t j = 0; j < numBlockHorizontal; j++) {
-			MapChipType chipType = mapChipField_->GetMapChipTypeByIndex(j, i);
-			
-			if (chipType == MapChipType::kBlock) {
-				blockCount++;
-				WorldTransform* worldTransform = new WorldTransform();
-				worldTransformBlocks_[i][j] = worldTransform;
-				worldTransformBlocks_[i][j]->Initialize();
-
-				worldTransformBlocks_[i][j]->translation_ = mapChipField_->GetMapChipPositionByIndex(j, i);
-			} else if (chipType == MapChipType::kSpawn) {
-				spawnCount++;
-#ifdef _DEBUG
-				printf("GameScene: Found spawn at (%d, %d)\n", j, i);
-#endif
-				player_ = std::make_unique<Player>();
-				player_->Initialize(playerModel_);
-				player_->SetCamera(&camera_);
-				Vector3 spawnPos = mapChipField_->GetMapChipPositionByIndex(j, i);
-				player_->SetTranslation(spawnPos);
-				
-				// 记录生成位置并初始化游戏阶段
-				spawnPosition_ = spawnPos;
-				player_->SetSpawnPosition(spawnPos);  // 也设置到Player类中
-				hasLeftSpawn_ = false;
-				SetGameStage(GameStage::kPreparation);
-				
-				// 设置地图碰撞检测引用
-				player_->SetMapChipField(mapChipField_);
-				// 设置GameScene引用以获取方块缩放信息
-				player_->SetGameScene(this);
-			} else if (chipType == MapChipType::kGoal) {
-				
-#ifdef _DEBUG
-				printf("GameScene: Found goal at (%d, %d)\n", j, i);
-#endif
-				std::unique_ptr<Goal> goal = std::make_unique<Goal>();
-				goal->Initialize(goalModel_);
-				goal->SetTranslation(mapChipField_->GetMapChipPositionByIndex(j, i));
-				
-				// 设置目标关卡ID的逻辑
-				if (mapID == 0) {
-					// 关卡选择场景：目标ID为关卡编号
-					goal->SetTargetMapID(goalCount);
-					goalCount--;
-				} else {
-					// 普通关卡场景的Goal设置
-					// 可以根据位置或其他逻辑来设置不同的目标
-					// 默认情况：返回关卡选择场景
-					goal->SetTargetMapID(0);
-					
-					// 可选：如果有多个Goal，可以设置不同的目标
-					// 例如：最右边的Goal进入下一关，最左边的Goal返回选择场景
-					if (j == numBlockHorizontal - 1) {
-						// 最右边的Goal：进入下一关
-						goal->SetTargetMapID(-1); // -1表示自动下一关
-					} else if (j == 0) {
-						// 最左边的Goal：返回关卡选择
-						goal->SetTargetMapID(0);
-					}
-				}
 
-				// 设置碰撞回调函数
-				goal->SetOnCollisionCallback([this](Goal* goal) {
-					this->OnGoalCollision(goal);
-				});
+	// 方块位置已经在 LevelData 中算好（可能是后台线程）
+	for (size_t n = 0; n < levelData_->blockIndices.size(); ++n) {
+		const IndexSet& index = levelData_->blockIndices[n];
+		blockCount++;
+		// 方块只保存变换，常量缓冲由实例后端统一管理，这里不再 Initialize
+		WorldTransform* worldTransform = new WorldTransform();
+		worldTransform->translation_ = levelData_->blockPositions[n];
+		worldTransformBlocks_[index.yIndex][index.xIndex] = worldTransform;
+	}
 
-				objects_.push_back(std::move(goal));
-			}
-			else {
-				worldTransformBlocks_[i][j] = nullptr;
+	for (const IndexSet& index : levelData_->spawnIndices) {
+		uint32_t i = index.yIndex;
+		uint32_t j = index.xIndex;
+		spawnCount++;
+		LOG_DEBUG(LogCategory::kScene, "GameScene: Found spawn at (%d, %d)", j, i);
+		player_ = std::make_unique<Player>();
+		player_->Initialize(playerModel_);
+		player_->SetCamera(&camera_);
+		Vector3 spawnPos = mapChipField_->GetMapChipPositionByIndex(j, i);
+		player_->SetTranslation(spawnPos);
+		
+		// 记录生成位置并初始化游戏阶段
+		spawnPosition_ = spawnPos;
+		player_->SetSpawnPosition(spawnPos);  // 也设置到Player类中
+		hasLeftSpawn_ = false;
+		SetGameStage(GameStage::kPreparation);
+		
+		// 设置地图碰撞检测引用
+		player_->SetMapChipField(mapChipField_);
+		// 设置GameScene引用以获取方块缩放信息
+		player_->SetGameScene(this);
+	}
+
+	for (const IndexSet& index : levelData_->goalIndices) {
+		uint32_t i = index.yIndex;
+		uint32_t j = index.xIndex;
+		LOG_DEBUG(LogCategory::kScene, "GameScene: Found goal at (%d, %d)", j, i);
+		std::unique_ptr<Goal> goal = std::make_unique<Goal>();
+		goal->Initialize(goalModel_);
+		goal->SetTimerWheel(&timerWheel_);
+		goal->SetTranslation(mapChipField_->GetMapChipPositionByIndex(j, i));
+		
+		// 设置目标关卡ID的逻辑
+		if (mapID == 0) {
+			// 关卡选择场景：目标ID为关卡编号
+			goal->SetTargetMapID(goalCount);
+			goalCount--;
+		} else {
+			// 普通关卡场景的Goal设置
+			// 可以根据位置或其他逻辑来设置不同的目标
+			// 默认情况：返回关卡选择场景
+			goal->SetTargetMapID(0);
+			
+			// 可选：如果有多个Goal，可以设置不同的目标
+			// 例如：最右边的Goal进入下一关，最左边的Goal返回选择场景
+			if (j == numBlockHorizontal - 1) {
+				// 最右边的Goal：进入下一关
+				goal->SetTargetMapID(-1); // -1表示自动下一关
+			} else if (j == 0) {
+				// 最左边的Goal：返回关卡选择
+				goal->SetTargetMapID(0);
 			}
 		}
+
+		// 设置碰撞回调函数
+		goal->SetOnCollisionCallback([this](Goal* goal) {
+			this->OnGoalCollision(goal);
+		});
+
+		objects_.push_back(std::move(goal));
 	}
 
-#ifdef _DEBUG
-	printf("GameScene: Generated %d blocks, %d spawns, %d goals\n", blockCount, spawnCount, goalCount);
-#endif
+	LOG_DEBUG(LogCategory::kScene, "GameScene: Generated %d blocks, %d spawns, %d goals", blockCount, spawnCount, goalCount);
+
+	// 剔除范围先覆盖整个地图，首次 Update 后按相机收缩
+	visibleTileRange_ = mapChipField_->GetFullTileRange();
+	totalTileCount_ = visibleTileRange_.GetTileCount();
+	visitedTileCount_ = totalTileCount_;
 
 	// 如果没有找到玩家生成点，在地图中心创建一个
 	if (!player_) {
-#ifdef _DEBUG
-		printf("GameScene: No spawn point found, creating player at map center\n");
-#endif
+		LOG_DEBUG(LogCategory::kScene, "GameScene: No spawn point found, creating player at map center");
 		player_ = std::make_unique<Player>();
 		player_->Initialize(playerModel_);
 		player_->SetCamera(&camera_);
@@ -614,11 +948,10 @@ void GameScene::GenerateBlocks() {
 
 	// 如果没有找到任何Goal，手动创建一个测试用的Goal
 	if (goalCount == 0) {
-#ifdef _DEBUG
-		printf("GameScene: No goals found, creating test goal\n");
-#endif
+		LOG_DEBUG(LogCategory::kScene, "GameScene: No goals found, creating test goal");
 		std::unique_ptr<Goal> goal = std::make_unique<Goal>();
 		goal->Initialize(goalModel_);
+		goal->SetTimerWheel(&timerWheel_);
 		// 将Goal放在地图右上角
 		Vector3 goalPos = {
 			(numBlockHorizontal - 2) * MapChipField::kBlockWidth + MapChipField::kBlockWidth / 2.0f,
@@ -642,34 +975,103 @@ void GameScene::GenerateBlocks() {
 		objects_.push_back(std::move(goal));
 	}
 
-	// 设置玩家的对象引用（用于碰撞检测）
-	if (player_) {
-		player_->SetObjects(&objects_);
+	// 触发检测用的 Goal 列表（每帧不再 dynamic_cast）
+	goals_.clear();
+	for (std::unique_ptr<Object3d>& object : objects_) {
+		Goal* goal = dynamic_cast<Goal*>(object.get());
+		if (goal) {
+			goals_.push_back(goal);
+		}
+	}
+	goalContacts_.assign(goals_.size(), 0);
+
+	// 敌人・障碍物
+	agents_.Clear();
+	agents_.Reserve(levelData_->agentIndices.size());
+	for (const IndexSet& index : levelData_->agentIndices) {
+		AgentKind kind = AgentKind::kPatrol;
+		switch (mapChipField_->GetMapChipTypeByIndex(index.xIndex, index.yIndex)) {
+		case MapChipType::kAgentFalling:
+			kind = AgentKind::kFalling;
+			break;
+		case MapChipType::kAgentChaser:
+			kind = AgentKind::kChaser;
+			break;
+		default:
+			break;
+		}
+		agents_.Spawn(kind, mapChipField_->GetMapChipPositionByIndex(index.xIndex, index.yIndex));
 	}
 }
 
-void GameScene::CameraUpdate() {
+void GameScene::UpdateParticles() {
+	particles_.Update(GameClock::kFixedDeltaTime, mapChipField_);
+	particles_.BuildInstances();
+}
+
+void GameScene::CameraUpdate(float deltaTime) {
 	if (isDebugCameraActive_) {
 		debugCamera_->Update();
 		camera_.matView = debugCamera_->GetCamera().matView;
 		camera_.matProjection = debugCamera_->GetCamera().matProjection;
 		camera_.TransferMatrix();
 	} else {
-		cameraController_->Update();
+		cameraController_->Update(deltaTime);
 		camera_.matView = cameraController_->GetCamera().matView;
 		camera_.matProjection = cameraController_->GetCamera().matProjection;
 		camera_.TransferMatrix();
 	}
 #ifdef _DEBUG
-	if (Input::GetInstance()->TriggerKey(DIK_T)) {
+	if (isDebugUIEnabled_ && Input::GetInstance()->TriggerKey(DIK_T)) {
 		isDebugCameraActive_ = !isDebugCameraActive_;
 	}
-	if (Input::GetInstance()->TriggerKey(DIK_F)) {
-		// debugCamera_->GetCamera().
-	}
 #endif // DEBUG
 }
 
+void GameScene::UpdateVisibleTileRange() {
+	if (!mapChipField_) {
+		return;
+	}
+
+	if (isDebugCameraActive_) {
+		// 调试相机可以看到整个地图，不剔除
+		visibleTileRange_ = mapChipField_->GetFullTileRange();
+	} else {
+		Rect visibleArea = cameraController_->GetVisibleArea();
+		MapChipField::Rect rect = {visibleArea.left, visibleArea.right, visibleArea.top, visibleArea.bottom};
+		visibleTileRange_ = mapChipField_->GetTileRangeByRect(rect, static_cast<uint32_t>(tileCullingMargin_));
+	}
+	visitedTileCount_ = visibleTileRange_.GetTileCount();
+}
+
+void GameScene::CheckGoalTriggers() {
+	// 接触判定与其他 Goal 无关，并行计算
+	const Vector3 playerPosition = player_->GetTranslation();
+	const Vector3 playerSize = player_->GetPlayerSize();
+	auto checkContacts = [this, &playerPosition, &playerSize](uint32_t begin, uint32_t end) {
+		for (uint32_t i = begin; i < end; ++i) {
+			goalContacts_[i] = goals_[i]->CheckCollisionWithPlayer(playerPosition, playerSize) ? 1 : 0;
+		}
+	};
+	JobSystem& jobs = JobSystem::GetInstance();
+	JobCounter counter;
+	jobs.ParallelFor(counter, static_cast<uint32_t>(goals_.size()), kGoalsPerJob, checkContacts);
+	jobs.Wait(counter);
+
+	// 回调会改变场景状态，按 Goal 的顺序在主线程触发（结果与线程数无关）
+	for (size_t i = 0; i < goals_.size(); ++i) {
+		Goal* goal = goals_[i];
+		if (!goal->IsActive()) {
+			continue;
+		}
+		bool isColliding = goalContacts_[i] != 0;
+		if (isColliding && !goal->WasCollidingLastFrame() && goal->CanTriggerCollision()) {
+			goal->TriggerCollision();
+		}
+		goal->SetWasCollidingLastFrame(isColliding);
+	}
+}
+
 void GameScene::SetCameraMapBounds() {
     if (!mapChipField_) {
         return;
@@ -728,31 +1130,26 @@ void GameScene::SetCameraMapBounds() {
 
 void GameScene::OnGoalCollision(Goal* goal) {
 	if (!goal || !goal->IsActive()) {
-#ifdef _DEBUG
-		printf("GameScene: Goal collision ignored - Goal inactive\n");
-#endif
+		LOG_DEBUG(LogCategory::kScene, "GameScene: Goal collision ignored - Goal inactive");
 		return;
 	}
 
 	// 只有在游戏阶段才能触发Goal碰撞
 	if (currentStage_ != GameStage::kGameplay) {
-#ifdef _DEBUG
-		printf("GameScene: Goal collision ignored - Not in gameplay stage (current: %d)\n", static_cast<int>(currentStage_));
-#endif
+		LOG_DEBUG(LogCategory::kScene, "GameScene: Goal collision ignored - Not in gameplay stage (current: %d)", static_cast<int>(currentStage_));
 		return;
 	}
 
 
 	int targetMapID = goal->GetTargetMapID();
 
-#ifdef _DEBUG
-	printf("GameScene: Goal collision detected! Current Map: %d, Target Map: %d\n", mapID, targetMapID);
-#endif
+	LOG_DEBUG(LogCategory::kScene, "GameScene: Goal collision detected! Current Map: %d, Target Map: %d", mapID, targetMapID);
 
 	// 确定最终的目标关卡ID
 	int finalTargetMapID = targetMapID;
 	
-	// 根据目标关卡ID执行不同的操作
+	// 根据目标关卡ID执行不同的操作（下一关/返回目标由关卡清单决定）
+	const LevelEntry* currentLevel = LevelRegistry::GetInstance().Find(mapID);
 	if (mapID == 0) {
 		// 在关卡选择场景中，切换到对应关卡
 		if (targetMapID > 0) {
@@ -762,167 +1159,96 @@ void GameScene::OnGoalCollision(Goal* goal) {
 		// 在普通关卡中的处理
 		if (targetMapID == 0) {
 			// 返回关卡选择场景
-			finalTargetMapID = 0;
+			finalTargetMapID = currentLevel ? currentLevel->returnID : 0;
 		} else if (targetMapID > 0) {
 			// 切换到指定关卡（下一关或特定关卡）
 			finalTargetMapID = targetMapID;
 		} else if (targetMapID == -1) {
 			// 自动切换到下一关
-			finalTargetMapID = mapID + 1;
+			finalTargetMapID = currentLevel ? currentLevel->nextID : 0;
 		}
 	}
 
-#ifdef _DEBUG
-	printf("GameScene: Final target map ID: %d\n", finalTargetMapID);
-#endif
+	LOG_DEBUG(LogCategory::kScene, "GameScene: Final target map ID: %d", finalTargetMapID);
 
 	// 设置等待场景切换的目标ID
 	pendingTargetMapID_ = finalTargetMapID;
 	isPendingSceneChange_ = true;
 
-	// 进入结束阶段
+	// 淡出期间在后台加载下一个关卡
+	SceneManager::GetInstance().PreloadLevel(pendingTargetMapID_);
+
+	// 进入结束阶段（淡出和等待由阶段序列处理）
 	SetGameStage(GameStage::kEnding);
-	fade_->Start(Fade::Status::kFadeOut, 1.0f); // 1秒淡出
 
 	// 禁用已触发的Goal以防重复触发
 	goal->SetActive(false);
+	particles_.StartEmitter(kGoalEffect, goal->GetTranslation());
 
-#ifdef _DEBUG
-	printf("GameScene: Goal reached, entering ending stage. Scene change will occur in %.1f seconds\n", endingStageDelay_);
-#endif
+	LOG_DEBUG(LogCategory::kScene, "GameScene: Goal reached, entering ending stage. Scene change will occur in %.1f seconds", endingStageDelay_);
 }
 
 void GameScene::SetGameStage(GameStage stage) {
 	if (currentStage_ != stage) {
 		previousStage_ = currentStage_;
 		currentStage_ = stage;
-		stageTransitionTimer_ = 0.0f;
 
 #ifdef _DEBUG
 		const char* stageNames[] = {"Preparation", "Gameplay", "Ending"};
-		printf("GameScene: Stage changed from %s to %s\n", 
-			stageNames[static_cast<int>(previousStage_)], 
+		LOG_DEBUG(LogCategory::kScene, "GameScene: Stage changed from %s to %s",
+			stageNames[static_cast<int>(previousStage_)],
 			stageNames[static_cast<int>(currentStage_)]);
 #endif
 	}
 }
 
-void GameScene::UpdateGameStage() {
-	switch (currentStage_) {
-	case GameStage::kPreparation:
-		fade_->Update();
-		// 检查玩家是否离开了生成点
-		if (player_) {
-			// 使用Player类的方法来检查是否离开生成区域
-			if (player_->HasLeftSpawnArea(1.0f) && !hasLeftSpawn_) {
-				hasLeftSpawn_ = true;
-				SetGameStage(GameStage::kGameplay);
-			}
-		}
-		break;
-	
-	case GameStage::kGameplay:
-		// 检查玩家是否死亡
-		if (player_ && player_->GetIsDead()) {
-			fade_->Start(Fade::Status::kFadeOut, 1.0f); // 1秒淡出
-			SetGameStage(GameStage::kEnding);
+Sequence GameScene::RunStageSequence() {
+	// 准备阶段：等待玩家离开生成点
+	LOG_DEBUG(LogCategory::kScene, "GameScene: Entering Preparation Stage - Move away from spawn to start");
+	co_await WaitUntil([this]() { return currentStage_ == GameStage::kEnding || (player_ && player_->HasLeftSpawnArea(1.0f)); });
 
-		}
-		break;
-	
-	case GameStage::kEnding:
-		fade_->Update();
-		// 在结束阶段，更新计时器
-		stageTransitionTimer_ += 1.0f / 60.0f; // 假设60FPS
-		break;
+	if (currentStage_ == GameStage::kPreparation) {
+		hasLeftSpawn_ = true;
+		SetGameStage(GameStage::kGameplay);
+
+		// 启动生命计时器（到期时由计时器回调处理死亡）
+		isLifeTimerActive_ = true;
+		lifeTimer_ = timerWheel_.ScheduleSeconds(gameLifeTime_, &GameScene::OnLifeTimeExpired, this);
+		LOG_DEBUG(LogCategory::kScene, "GameScene: Entering Gameplay Stage - Game started!");
+		LOG_DEBUG(LogCategory::kScene, "GameScene: Life timer started! Player has %.1f seconds", gameLifeTime_);
+
+		// 游戏阶段：等待到达Goal或死亡
+		co_await WaitUntil([this]() { return currentStage_ == GameStage::kEnding || (player_ && player_->GetIsDead()); });
 	}
-}
 
-void GameScene::HandlePreparationStage() {
-	
-	// 准备阶段：显示准备提示信息，限制某些功能等
-	// 可以在这里添加UI提示，比如"移动离开生成点开始游戏"
+	// 结束阶段：淡出，等待结束后重开或切换关卡
+	bool isDead = player_ && player_->GetIsDead();
+	SetGameStage(GameStage::kEnding);
+	fade_->Start(Fade::Status::kFadeOut, 1.0f); // 1秒淡出
+	LOG_DEBUG(LogCategory::kScene, "GameScene: Entering Ending Stage - %s", isDead ? "Player died, will reload level" : "Player reached goal");
 
-#ifdef _DEBUG
-	// 只在第一次进入准备阶段时显示消息
-	static bool hasShownPreparationMessage = false;
-	if (!hasShownPreparationMessage) {
-		printf("GameScene: Entering Preparation Stage - Move away from spawn to start\n");
-		hasShownPreparationMessage = true;
+	co_await WaitSeconds(endingStageDelay_);
+	co_await WaitFade(*fade_);
+
+	if (isDead) {
+		// 玩家死亡，原地重开当前关卡（不重建场景）
+		LOG_DEBUG(LogCategory::kScene, "GameScene: Player died, restarting current level %d in place", mapID);
+		RestartLevel();
+	} else if (isPendingSceneChange_) {
+		// 玩家到达Goal，Tick 结束后切换到目标关卡
+		LOG_DEBUG(LogCategory::kScene, "GameScene: Goal reached, switching to map %d", pendingTargetMapID_);
+		isSceneChangeReady_ = true;
 	}
-#endif
 }
 
 void GameScene::HandleGameplayStage() {
-	// 启动生命计时器
-	if (!isLifeTimerActive_) {
-		isLifeTimerActive_ = true;
-#ifdef _DEBUG
-		printf("GameScene: Life timer started! Player has %.1f seconds\n", gameLifeTime_);
-#endif
-	}
-
-	// 更新生命计时器
+	// 剩余时间从计时器读取，用于方块缩放和显示
 	if (isLifeTimerActive_) {
-		gameLifeTime_ -= 1.0f / 60.0f; // 假设60FPS
-		
-		// 检查玩家是否因时间耗尽而死亡
-		if (gameLifeTime_ <= 0.0f) {
-			gameLifeTime_ = 0.0f;
-#ifdef _DEBUG
-			printf("GameScene: Time's up! Player died from timeout\n");
-#endif
-			OnPlayerDeath();
-			return;
-		}
+		gameLifeTime_ = timerWheel_.GetRemainingSeconds(lifeTimer_);
 
 		// 更新地图方块缩放
 		UpdateBlockScaling();
 	}
-
-#ifdef _DEBUG
-	// 只在第一次进入游戏阶段时显示消息
-	static bool hasShownGameplayMessage = false;
-	if (!hasShownGameplayMessage) {
-		printf("GameScene: Entering Gameplay Stage - Game started!\n");
-		hasShownGameplayMessage = true;
-	}
-#endif
-}
-
-void GameScene::HandleEndingStage() {
-	
-	// 结束阶段：处理游戏结束逻辑
-	if (stageTransitionTimer_ >= endingStageDelay_) {
-		if (player_ && player_->GetIsDead()) {
-			// 玩家死亡，重新加载当前关卡
-#ifdef _DEBUG
-			printf("GameScene: Player died, reloading current level %d\n", mapID);
-#endif
-			SceneManager::GetInstance().SetNextMapID(mapID);
-			SceneManager::GetInstance().ChangeScene(SceneManager::SceneType::kGame);
-		} else if (isPendingSceneChange_) {
-			// 玩家到达Goal，切换到目标关卡
-#ifdef _DEBUG
-			printf("GameScene: Goal reached, switching to map %d\n", pendingTargetMapID_);
-#endif
-			SceneManager::GetInstance().SetNextMapID(pendingTargetMapID_);
-			SceneManager::GetInstance().ChangeScene(SceneManager::SceneType::kGame);
-		}
-	}
-
-#ifdef _DEBUG
-	// 只在第一次进入结束阶段时显示消息
-	static bool hasShownEndingMessage = false;
-	if (!hasShownEndingMessage) {
-		if (player_ && player_->GetIsDead()) {
-			printf("GameScene: Entering Ending Stage - Player died, will reload level\n");
-		} else {
-			printf("GameScene: Entering Ending Stage - Player reached goal\n");
-		}
-		hasShownEndingMessage = true;
-	}
-#endif
 }
 
 void GameScene::UpdateBlockScaling() {
@@ -943,31 +1269,86 @@ void GameScene::UpdateBlockScaling() {
 		currentBlockScale_ = 1.0f;
 	}
 
-	// 更新所有地图方块的缩放
-	for (std::vector<WorldTransform*>& worldTransformBlockX : worldTransformBlocks_) {
-		for (WorldTransform* worldTransformBlock : worldTransformBlockX) {
-			if (worldTransformBlock) {
-				worldTransformBlock->scale_ = {currentBlockScale_, currentBlockScale_, currentBlockScale_};
-			}
-		}
-	}
+	// 方块的 scale_ 在 Update 中只对可见范围应用
 }
 
 float GameScene::GetCurrentBlockScale() const {
 	return currentBlockScale_;
 }
 
+void GameScene::RestartLevel() {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	// 玩家回到出生点
+	if (player_) {
+		player_->ResetToSpawn();
+	}
+
+	// Goal 的触发状态
+	for (Goal* goal : goals_) {
+		goal->ResetTrigger();
+	}
+
+	agents_.Reset();
+	particles_.Clear();
+
+	// 计时器和方块缩放（方块在下一次 Update 时按 currentBlockScale_ 更新）
+	timerWheel_.Cancel(lifeTimer_);
+	gameLifeTime_ = maxGameLifeTime_;
+	isLifeTimerActive_ = false;
+	currentBlockScale_ = 1.0f;
+
+	// 阶段（结束阶段中请求的下一关预加载不再使用）
+	hasLeftSpawn_ = false;
+	isPendingSceneChange_ = false;
+	SceneManager::GetInstance().CancelPreload();
+	isSceneChangeReady_ = false;
+	SetGameStage(GameStage::kPreparation);
+
+	// 阶段序列从头开始（可能是从结束序列内部调用，旧序列在本次恢复返回后才释放）
+	sequenceRunner_.StopAll();
+	sequenceRunner_.Start(RunStageSequence());
+
+	// 相机回到初始位置，重新淡入
+	SetCameraMapBounds();
+	fade_->Start(Fade::Status::kFadeIn, 0.5f);
+
+	std::chrono::duration<float, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+	lastRestartMicroseconds_ = elapsed.count();
+	restartCount_++;
+
+	LOG_DEBUG(LogCategory::kScene, "GameScene: Level %d restarted in place (%.1f us)", mapID, lastRestartMicroseconds_);
+}
+
+void GameScene::SetLifeTime(float seconds) {
+	gameLifeTime_ = seconds;
+	// 计时中则重新登记期限
+	if (isLifeTimerActive_) {
+		timerWheel_.Cancel(lifeTimer_);
+		lifeTimer_ = timerWheel_.ScheduleSeconds(seconds, &GameScene::OnLifeTimeExpired, this);
+	}
+}
+
+void GameScene::OnLifeTimeExpired(void* context) {
+	GameScene* scene = static_cast<GameScene*>(context);
+	scene->gameLifeTime_ = 0.0f;
+	LOG_DEBUG(LogCategory::kScene, "GameScene: Time's up! Player died from timeout");
+	scene->OnPlayerDeath();
+}
+
 //让玩家死亡
 void GameScene::OnPlayerDeath() {
 	if (player_) {
+		if (!player_->GetIsDead()) {
+			particles_.Burst(kDeathEffect, player_->GetTranslation());
+		}
 		player_->SetIsDead(true);
 		SetGameStage(GameStage::kEnding);
 		
 		// 停止生命计时器
 		isLifeTimerActive_ = false;
+		timerWheel_.Cancel(lifeTimer_);
 
-#ifdef _DEBUG
-		printf("GameScene: Player death detected\n");
-#endif
+		LOG_DEBUG(LogCategory::kScene, "GameScene: Player death detected");
 	}
 }
@@ -2,11 +2,21 @@
 #include "KamataEngine.h"
 #include "IScene.h"
 #include "MapChipField.h"
+#include "MapSnapshot.h"
+#include "MapHotReload.h"
+#include "AgentSystem.h"
+#include "ParticleSystem.h"
 #include "Player.h"
 #include "CameraController.h"
 #include "Goal.h"
 #include "Skydome.h"
 #include "Fade.h"
+#include "InstanceBatch.h"
+#include "LevelData.h"
+#include "TimerWheel.h"
+#include "Sequence.h"
+#include "RenderSnapshot.h"
+#include <chrono>
 
 // 游戏阶段枚举
 enum class GameStage {
@@ -30,40 +40,125 @@ class GameScene : public IScene{
 	void OnExit() override;
 
 	void GenerateBlocks();
-	void CameraUpdate();
+	// deltaTime：相机追随的经过时间（秒）
+	void CameraUpdate(float deltaTime);
 	void SetCameraMapBounds();
+	void UpdateVisibleTileRange();
+	// 与玩家接触的 Goal 触发回调
+	void CheckGoalTriggers();
 
 	void SetMapID(int newMapID) { mapID = newMapID; }
 	int GetMapID() const { return mapID; }
 
+	// 预加载好的关卡数据（OnEnter 之前设置，否则 OnEnter 中同步加载）
+	void SetPreloadedLevel(std::unique_ptr<LevelData> levelData) { levelData_ = std::move(levelData); }
+
+	// 玩家输入来源（OnEnter 之前设置，nullptr 时读取键盘）
+	void SetPlayerInputSource(IPlayerInputSource* inputSource) { playerInputSource_ = inputSource; }
+
+	// 是否在 Update 中显示 ImGui 调试 UI（在模拟线程上更新时必须关闭）
+	void SetDebugUIEnabled(bool isEnabled) { isDebugUIEnabled_ = isEnabled; }
+
+	// 是否按固定 tick 推进相机（模拟线程、soak 中必须打开；只有按垂直同步运行的主循环使用实际帧时间）
+	void SetFixedTimestep(bool isFixed) { isFixedTimestep_ = isFixed; }
+
+	// 把当前帧要绘制的内容写入快照（只读取状态，在 Update 之后调用）
+	void BuildRenderSnapshot(RenderSnapshot& snapshot) const;
+
+	// 当前地图的发布处。其他线程（工作线程、工具）通过 MapReadGuard 只读访问
+	MapSnapshotStore& GetMapStore() { return mapStore_; }
+	// 编辑或重新加载后发布新地图（更新线程调用），玩家的碰撞立即使用新地图
+	void PublishMap(std::unique_ptr<MapChipField> mapChipField);
+
 	// 碰撞回调函数
 	void OnGoalCollision(Goal* goal);
 
 	// 游戏阶段管理
 	void SetGameStage(GameStage stage);
 	GameStage GetGameStage() const { return currentStage_; }
-	void UpdateGameStage();
-	void HandlePreparationStage();
 	void HandleGameplayStage();
-	void HandleEndingStage();
 
 	// 玩家死亡处理
 	void OnPlayerDeath();
 
+	// 原地重开当前关卡：只恢复可变状态，不重建场景
+	void RestartLevel();
+
+#ifdef USE_HOT_RELOAD
+	// 地图文件被修改后，只把变化的瓦片反映到碰撞和方块上（玩家位置和计时不变）
+	void ApplyMapReload();
+#endif
+
+	// 设置剩余生命时间（计时中会重新登记期限）
+	void SetLifeTime(float seconds);
+
+	// 原地重开的次数（死亡后重开也计入）
+	uint32_t GetRestartCount() const { return restartCount_; }
+
 	// 新的方法：更新地图方块缩放
 	void UpdateBlockScaling();
 	float GetCurrentBlockScale() const;
 
 	private:
+	// 计时器回调
+	static void OnLifeTimeExpired(void* context);
+
+	// 准备 -> 游戏 -> 结束 的阶段流程
+	Sequence RunStageSequence();
+
+#ifdef _DEBUG
+	void DrawDebugUI();
+#endif
+
+	// 推进粒子并生成本帧的实例数据
+	void UpdateParticles();
+
+	// 可见瓦片范围内的敌人（Draw 和快照共用）
+	template <typename Function>
+	void ForEachVisibleAgent(Function&& function) const {
+		if (!mapChipField_ || visibleTileRange_.GetTileCount() == 0) {
+			return;
+		}
+		float mapTop = static_cast<float>(mapChipField_->GetNumBlockVertical()) * MapChipField::kBlockHeight;
+		agents_.ForEachInRect(static_cast<float>(visibleTileRange_.xBegin) * MapChipField::kBlockWidth, mapTop - static_cast<float>(visibleTileRange_.yEnd) * MapChipField::kBlockHeight,
+		                      static_cast<float>(visibleTileRange_.xEnd) * MapChipField::kBlockWidth, mapTop - static_cast<float>(visibleTileRange_.yBegin) * MapChipField::kBlockHeight,
+		                      [&function, this](uint32_t index) {
+			                      if (agents_.IsActive(index)) {
+				                      function(index);
+			                      }
+		                      });
+	}
+
+
+	// 关卡数据
+	std::unique_ptr<LevelData> levelData_;
 
 	// block
 	std::vector<std::vector<KamataEngine::WorldTransform*>> worldTransformBlocks_;
 	KamataEngine::Model* blockModel_ = nullptr;
-	MapChipField* mapChipField_ = nullptr;
+	MapSnapshotStore mapStore_;
+	const MapChipField* mapChipField_ = nullptr; // 当前发布的地图（更新线程可直接使用）
+	AutotileMap autotile_; // 方块的拼接种类（地图改变时增量更新）
+	ChunkMeshBaker blockMeshes_; // 按区块合并的方块网格（地图改变时只重新烘焙变化的区块）
+#ifdef USE_HOT_RELOAD
+	MapHotReloader mapHotReloader_; // 在 mapStore_ 之前析构
+	float lastHotReloadMilliseconds_ = 0.0f; // 检测到文件变化 -> 反映完成
+	uint32_t lastHotReloadTileCount_ = 0;
+	uint32_t hotReloadCount_ = 0;
+#endif
+	InstanceBatchBuilder instanceBatchBuilder_;
+	std::unique_ptr<IInstanceRenderBackend> instanceBackend_;
+
+	// 相机可见范围剔除
+	TileRange visibleTileRange_;
+	uint32_t visitedTileCount_ = 0;  // 本帧访问的瓦片数
+	uint32_t totalTileCount_ = 0;    // 地图瓦片总数
+	int tileCullingMargin_ = 2;      // 可见范围外额外保留的瓦片数
 
 	// プレイヤー
 	std::unique_ptr<Player> player_;
 	KamataEngine::Model* playerModel_ = nullptr;
+	IPlayerInputSource* playerInputSource_ = nullptr;
 
 	//Goal
 	KamataEngine::Model* goalModel_ = nullptr;
@@ -77,28 +172,54 @@ class GameScene : public IScene{
 
 	//titie
 	KamataEngine::Sprite* titleSprite_ = nullptr;
+	uint32_t titleTextureHandle_ = 0;
+
+
+	// 计时器（Goal 会登记回调，必须比 objects_ 先构造、后析构）
+	TimerWheel timerWheel_;
+	TimerHandle lifeTimer_;
 
+	// 阶段序列（等待时间登记在 timerWheel_ 中，必须在它之后声明）
+	SequenceRunner sequenceRunner_{&timerWheel_};
 
 	// 存储所有除玩家和地图外的物体
 	std::vector<std::unique_ptr<Object3d>> objects_;
+	// 触发检测用：objects_ 中的 Goal 和每个 Goal 本帧是否与玩家接触（并行计算，按顺序触发）
+	std::vector<Goal*> goals_;
+	std::vector<uint8_t> goalContacts_;
+
+	// 敌人・障碍物（地图值 3/4/5），以数组形式批量更新
+	AgentSystem agents_;
+
+	// 死亡・到达终点・落地的粒子效果（容量在进入关卡时一次分配）
+	ParticleSystem particles_;
+	static constexpr uint32_t kParticleCapacity = 4096;
+
+	// 并行更新的分批粒度（只由数量决定，与线程数无关）
+	static constexpr uint32_t kBlocksPerJob = 1024;
+	static constexpr uint32_t kObjectsPerJob = 16;
+	static constexpr uint32_t kGoalsPerJob = 16;
 
 
 	KamataEngine::WorldTransform worldTransform_;
 
 	KamataEngine::Camera camera_;
 	std::unique_ptr<CameraController> cameraController_;
+	std::chrono::steady_clock::time_point lastCameraUpdateTime_;
+	bool hasCameraUpdateTime_ = false;
 	
 
 	// debugカメラ
 	KamataEngine::DebugCamera* debugCamera_ = nullptr;
 	bool isDebugCameraActive_ = false;
+	bool isDebugUIEnabled_ = true;
+	bool isFixedTimestep_ = false;
 
 	int mapID = 0;
 
 	// 场景切换相关
 	bool isPendingSceneChange_ = false;
-	float sceneChangeTimer_ = 0.0f;
-	float sceneChangeDelay_ = 1.0f; // 1秒延迟
+	bool isSceneChangeReady_ = false; // 结束序列完成，等待本帧切换
 	int pendingTargetMapID_ = 0;
 
 	// 游戏阶段相关
@@ -106,7 +227,10 @@ class GameScene : public IScene{
 	GameStage previousStage_ = GameStage::kPreparation;
 	Vector3 spawnPosition_ = {0.0f, 0.0f, 0.0f};  // 玩家初始生成位置
 	bool hasLeftSpawn_ = false;  // 玩家是否已经离开生成点
-	float stageTransitionTimer_ = 0.0f;  // 阶段转换计时器
+#ifdef USE_ALLOC_TRACKER
+	static constexpr uint32_t kAllocCheckWarmupTicks = 120; // 零分配检查前的预热 tick 数
+	uint32_t gameplayTickCount_ = 0;
+#endif
 	float endingStageDelay_ = 1.0f;  // 结束阶段延迟时间
 
 	// 游戏倒计时相关
@@ -114,6 +238,10 @@ class GameScene : public IScene{
 	float maxGameLifeTime_ = 25.0f;  // 最大游戏生命时间
 	bool isLifeTimerActive_ = false;  // 生命计时器是否激活
 
+	// 原地重开统计
+	float lastRestartMicroseconds_ = 0.0f;
+	uint32_t restartCount_ = 0;
+
 	// 地图方块缩放相关
 	float currentBlockScale_ = 1.0f;  // 当前方块缩放比例
 	float minBlockScale_ = 0.01f;      // 最小方块缩放比例
@@ -1,12 +1,13 @@
 #pragma once
 #include <KamataEngine.h>
-#include <functional>
+#include "Delegate.h"
+#include "TimerWheel.h"
 using namespace KamataEngine;
 
 class Goal : public Object3d {
 public:
 	Goal() = default;
-	~Goal() = default;
+	~Goal();
 	void Update() override;
 	void SetActive(bool isActive) { isActive_ = isActive; }
 	bool IsActive() const { return isActive_; }
@@ -14,32 +15,48 @@ public:
 	void SetTargetMapID(int newID) { id = newID; }
 	int GetTargetMapID() const { return id; }
 
-	// 碰撞检测相关方法
+	// 最后一次 Update 计算的世界矩阵（渲染快照用）
+	const Matrix4x4& GetWorldMatrix() const { return worldTransform_.matWorld_; }
+
+	// 碰撞检测相关方法（不修改状态，可以在工作线程上调用）
 	bool CheckCollisionWithPlayer(const Vector3& playerPosition, const Vector3& playerSize) const;
 	Vector3 GetGoalSize() const { return Vector3(size.x, size.y, 2.0f); }
 	void SetGoalSize(const Vector2& newSize) { size = newSize; }
 
 	// 回调函数设置
-	void SetOnCollisionCallback(std::function<void(Goal*)> callback) { onCollisionCallback_ = callback; }
+	void SetOnCollisionCallback(Delegate<void(Goal*)> callback) { onCollisionCallback_ = std::move(callback); }
 	void TriggerCollision();
 
 	// 碰撞状态管理
 	bool WasCollidingLastFrame() const { return wasCollidingLastFrame_; }
 	void SetWasCollidingLastFrame(bool colliding) { wasCollidingLastFrame_ = colliding; }
 
-	// 碰撞冷却机制
+	// 碰撞冷却机制（冷却结束的期限登记在 TimerWheel 中）
 	bool CanTriggerCollision() const;
+	void SetTimerWheel(TimerWheel* timerWheel) { timerWheel_ = timerWheel; }
+
+	// 恢复到关卡开始时的状态（原地重开用）
+	void ResetTrigger();
+
+#ifdef _DEBUG
+	// 调试窗口（Update 在工作线程上执行，ImGui 只能在主线程调用）
+	void ShowDebugWindow();
+#endif
 
 private:
 	bool isActive_ = true;
 	int id = 0;
 	bool wasCollidingLastFrame_ = false;
 	bool hasTriggered_ = false;  // 是否已经触发过
-	float collisionCooldown_ = 0.0f;  // 碰撞冷却时间
+	bool isCoolingDown_ = false;  // 碰撞冷却中
+	TimerWheel* timerWheel_ = nullptr;
+	TimerHandle cooldownTimer_;
 	static constexpr float kCollisionCooldownTime = 0.5f;  // 0.5秒冷却时间
 
 	Vector2 size = {1.8f, 1.8f};
 	
+	static void OnCooldownExpired(void* context);
+
 	// 回调函数：加载对应关卡
-	std::function<void(Goal*)> onCollisionCallback_;
+	Delegate<void(Goal*)> onCollisionCallback_;
 };
\ No newline at end of file
@@ -0,0 +1,69 @@
+#include "InstanceBatch.h"
+
+void InstanceBatchBuilder::Begin() {
+	buildStart_ = std::chrono::steady_clock::now();
+	// 只清空内容，保留容量
+	for (std::vector<InstanceData>& list : staging_) {
+		list.clear();
+	}
+	instances_.clear();
+	batches_.clear();
+}
+
+void InstanceBatchBuilder::Add(Model* model, const Matrix4x4& matWorld, const Vector4& color, uint32_t variant) {
+	if (!model) {
+		return;
+	}
+
+	// 连续添加的通常是同一个模型，先检查上一次命中的列表
+	size_t index = lastStagingIndex_;
+	if (index >= stagingModels_.size() || stagingModels_[index] != model) {
+		index = stagingModels_.size();
+		for (size_t i = 0; i < stagingModels_.size(); ++i) {
+			if (stagingModels_[i] == model) {
+				index = i;
+				break;
+			}
+		}
+		if (index == stagingModels_.size()) {
+			stagingModels_.push_back(model);
+			staging_.emplace_back();
+		}
+		lastStagingIndex_ = index;
+	}
+
+	staging_[index].push_back({matWorld, color, variant});
+}
+
+void InstanceBatchBuilder::End() {
+	size_t total = 0;
+	for (const std::vector<InstanceData>& list : staging_) {
+		total += list.size();
+	}
+	instances_.reserve(total);
+
+	for (size_t i = 0; i < staging_.size(); ++i) {
+		const std::vector<InstanceData>& list = staging_[i];
+		if (list.empty()) {
+			continue;
+		}
+		InstanceBatch batch;
+		batch.model = stagingModels_[i];
+		batch.firstInstance = static_cast<uint32_t>(instances_.size());
+		batch.instanceCount = static_cast<uint32_t>(list.size());
+		instances_.insert(instances_.end(), list.begin(), list.end());
+		batches_.push_back(batch);
+	}
+
+	std::chrono::duration<float, std::micro> elapsed = std::chrono::steady_clock::now() - buildStart_;
+	lastBuildMicroseconds_ = elapsed.count();
+}
+
+void NullInstanceBackend::Submit(const InstanceBatchBuilder& builder) {
+	drawList_.clear();
+	for (const InstanceBatch& batch : builder.GetBatches()) {
+		drawList_.push_back({batch.model, batch.firstInstance, batch.instanceCount});
+		totalInstanceCount_ += batch.instanceCount;
+	}
+	submitCount_++;
+}
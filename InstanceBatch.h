@@ -0,0 +1,87 @@
+#pragma once
+#include <math/Matrix4x4.h>
+#include <math/Vector4.h>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// 构建器只用模型的地址区分批次，不依赖引擎的渲染部分，没有渲染器也能构建（-bench）。
+// 用 KamataEngine 绘制的后端在 ModelInstanceBackend.h
+namespace KamataEngine {
+	class Model;
+}
+using namespace KamataEngine;
+
+// 一个实例的数据：世界矩阵 + 颜色（tint）+ 瓦片种类
+struct InstanceData {
+	Matrix4x4 matWorld;
+	Vector4 color = {1.0f, 1.0f, 1.0f, 1.0f};
+	uint32_t variant = 0; // 方块的自动拼接种类（见 Autotile.h，tile.tsx 的图块编号）
+};
+
+// 同一模型的实例区间（指向 InstanceBatchBuilder::GetInstances() 中的连续范围）
+struct InstanceBatch {
+	Model* model = nullptr;
+	uint32_t firstInstance = 0;
+	uint32_t instanceCount = 0;
+};
+
+// 把每帧可见的实例按模型收集到一块连续数组中，渲染器可以一次性上传。
+// 内部缓冲在帧之间复用，稳定状态下不会再分配内存。
+class InstanceBatchBuilder {
+public:
+	InstanceBatchBuilder() = default;
+	~InstanceBatchBuilder() = default;
+
+	void Begin();
+	void Add(Model* model, const Matrix4x4& matWorld, const Vector4& color = {1.0f, 1.0f, 1.0f, 1.0f}, uint32_t variant = 0);
+	void End();
+
+	const std::vector<InstanceData>& GetInstances() const { return instances_; }
+	const std::vector<InstanceBatch>& GetBatches() const { return batches_; }
+	uint32_t GetInstanceCount() const { return static_cast<uint32_t>(instances_.size()); }
+	uint32_t GetBatchCount() const { return static_cast<uint32_t>(batches_.size()); }
+
+	// 上一次 Begin()~End() 的构建耗时（微秒）
+	float GetLastBuildMicroseconds() const { return lastBuildMicroseconds_; }
+
+private:
+	// 每个模型一条暂存列表，End() 时拼接到 instances_
+	std::vector<Model*> stagingModels_;
+	std::vector<std::vector<InstanceData>> staging_;
+	size_t lastStagingIndex_ = 0;
+
+	std::vector<InstanceData> instances_;
+	std::vector<InstanceBatch> batches_;
+
+	std::chrono::steady_clock::time_point buildStart_;
+	float lastBuildMicroseconds_ = 0.0f;
+};
+
+// 渲染后端接口：把构建好的批次提交给具体的渲染器（相机等绘制状态由后端自己持有）
+class IInstanceRenderBackend {
+public:
+	virtual ~IInstanceRenderBackend() = default;
+	virtual void Submit(const InstanceBatchBuilder& builder) = 0;
+};
+
+// 不做任何绘制，只记录绘制列表。用于在没有渲染器的环境（Linux/CI）下统计批次数和构建开销。
+class NullInstanceBackend : public IInstanceRenderBackend {
+public:
+	struct DrawRecord {
+		const Model* model = nullptr;
+		uint32_t firstInstance = 0;
+		uint32_t instanceCount = 0;
+	};
+
+	void Submit(const InstanceBatchBuilder& builder) override;
+
+	const std::vector<DrawRecord>& GetDrawList() const { return drawList_; }
+	uint64_t GetSubmitCount() const { return submitCount_; }
+	uint64_t GetTotalInstanceCount() const { return totalInstanceCount_; }
+
+private:
+	std::vector<DrawRecord> drawList_;
+	uint64_t submitCount_ = 0;
+	uint64_t totalInstanceCount_ = 0;
+};
@@ -0,0 +1,246 @@
+#include "JobSystem.h"
+#include <algorithm>
+#include <cassert>
+
+std::unique_ptr<JobSystem> JobSystem::instance_ = nullptr;
+
+namespace {
+	// 呼び出し元スレッドの番号と、それがどのインスタンスのものか。
+	// 別のスレッドで作り直されたときに、古いインスタンスの番号を使わないようにする
+	thread_local uint32_t gThreadIndex = UINT32_MAX;
+	thread_local uint32_t gThreadSerial = 0;
+	std::atomic<uint32_t> gNextSerial{1};
+
+	// 寝る前に盗みを試す回数
+	constexpr uint32_t kSpinCount = 64;
+}
+
+bool JobSystem::WorkQueue::Push(Job* job) {
+	int64_t bottom = bottom_.load(std::memory_order_relaxed);
+	int64_t top = top_.load(std::memory_order_acquire);
+	if (bottom - top >= kCapacity) {
+		return false;
+	}
+	jobs_[bottom & (kCapacity - 1)].store(job, std::memory_order_relaxed);
+	bottom_.store(bottom + 1, std::memory_order_release);
+	return true;
+}
+
+JobSystem::Job* JobSystem::WorkQueue::Pop() {
+	int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+	bottom_.store(bottom, std::memory_order_seq_cst);
+	int64_t top = top_.load(std::memory_order_seq_cst);
+	if (top > bottom) {
+		// 空だった
+		bottom_.store(bottom + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+	Job* job = jobs_[bottom & (kCapacity - 1)].load(std::memory_order_relaxed);
+	if (top == bottom) {
+		// 最後の 1 件は盗みと競合するので CAS で取り合う
+		if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+			job = nullptr;
+		}
+		bottom_.store(bottom + 1, std::memory_order_relaxed);
+	}
+	return job;
+}
+
+JobSystem::Job* JobSystem::WorkQueue::Steal() {
+	int64_t top = top_.load(std::memory_order_seq_cst);
+	int64_t bottom = bottom_.load(std::memory_order_seq_cst);
+	if (top >= bottom) {
+		return nullptr;
+	}
+	Job* job = jobs_[top & (kCapacity - 1)].load(std::memory_order_relaxed);
+	if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+		return nullptr;
+	}
+	return job;
+}
+
+JobSystem& JobSystem::GetInstance() {
+	if (!instance_) {
+		Initialize(0);
+	}
+	return *instance_;
+}
+
+void JobSystem::Initialize(uint32_t threadCount) {
+	instance_.reset();
+	if (threadCount == 0) {
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+	}
+	instance_ = std::unique_ptr<JobSystem>(new JobSystem(std::min(threadCount, kMaxThreads)));
+}
+
+void JobSystem::Destroy() { instance_.reset(); }
+
+JobSystem::JobSystem(uint32_t threadCount) : threadCount_(threadCount), serial_(gNextSerial.fetch_add(1, std::memory_order_relaxed)) {
+	workers_.reserve(threadCount_);
+	for (uint32_t i = 0; i < threadCount_; ++i) {
+		workers_.push_back(std::make_unique<Worker>());
+		workers_.back()->randomState = 0x9E3779B9u * (i + 1);
+	}
+	gThreadIndex = 0;
+	gThreadSerial = serial_;
+	for (uint32_t i = 1; i < threadCount_; ++i) {
+		workers_[i]->thread = std::thread(&JobSystem::WorkerMain, this, i);
+	}
+}
+
+JobSystem::~JobSystem() {
+	isRunning_.store(false, std::memory_order_seq_cst);
+	generation_.fetch_add(1, std::memory_order_seq_cst);
+	generation_.notify_all();
+	for (std::unique_ptr<Worker>& worker : workers_) {
+		if (worker->thread.joinable()) {
+			worker->thread.join();
+		}
+	}
+	if (gThreadSerial == serial_) {
+		gThreadIndex = UINT32_MAX;
+	}
+}
+
+uint32_t JobSystem::GetCurrentThreadIndex() { return instance_ ? instance_->GetThreadIndex() : UINT32_MAX; }
+
+uint32_t JobSystem::GetThreadIndex() const { return gThreadSerial == serial_ ? gThreadIndex : UINT32_MAX; }
+
+void JobSystem::WorkerMain(uint32_t index) {
+	gThreadIndex = index;
+	gThreadSerial = serial_;
+	while (isRunning_.load(std::memory_order_acquire)) {
+		uint32_t observedGeneration = generation_.load(std::memory_order_seq_cst);
+		Job* job = nullptr;
+		for (uint32_t spin = 0; spin < kSpinCount && !job; ++spin) {
+			job = FindJob(index);
+			if (!job) {
+				std::this_thread::yield();
+			}
+		}
+		if (job) {
+			Execute(job);
+			continue;
+		}
+		// 投入があるまで寝る（投入側は寝ているワーカーがいるときだけ起こす）
+		sleepingCount_.fetch_add(1, std::memory_order_seq_cst);
+		if (isRunning_.load(std::memory_order_seq_cst)) {
+			generation_.wait(observedGeneration, std::memory_order_seq_cst);
+		}
+		sleepingCount_.fetch_sub(1, std::memory_order_seq_cst);
+	}
+}
+
+JobSystem::Job* JobSystem::FindJob(uint32_t index) {
+	Worker& self = *workers_[index];
+	if (Job* job = self.queue.Pop()) {
+		return job;
+	}
+	if (threadCount_ == 1) {
+		return nullptr;
+	}
+	// 盗む相手はランダムな位置から順に試す
+	self.randomState ^= self.randomState << 13;
+	self.randomState ^= self.randomState >> 17;
+	self.randomState ^= self.randomState << 5;
+	uint32_t offset = self.randomState % threadCount_;
+	for (uint32_t i = 0; i < threadCount_; ++i) {
+		uint32_t victim = (offset + i) % threadCount_;
+		if (victim == index) {
+			continue;
+		}
+		if (Job* job = workers_[victim]->queue.Steal()) {
+			stealCount_.fetch_add(1, std::memory_order_relaxed);
+			return job;
+		}
+	}
+	return nullptr;
+}
+
+void JobSystem::Execute(Job* job) {
+	// スロットは投入側で使い回されるので、先に写しておく
+	Job local = *job;
+#ifdef USE_ALLOC_TRACKER
+	AllocTracker::ArmedScopeBinding allocBinding(local.allocScope);
+#endif
+	local.function(local.data, local.begin, local.end);
+	local.counter->value.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+JobSystem::Job JobSystem::MakeJob(JobFunction function, void* data, JobCounter* counter, uint32_t begin, uint32_t end) {
+	Job job{function, data, counter, begin, end};
+#ifdef USE_ALLOC_TRACKER
+	job.allocScope = AllocTracker::GetArmedScope();
+#endif
+	return job;
+}
+
+void JobSystem::Submit(uint32_t index, Job* job) {
+	Worker& worker = *workers_[index];
+	Job* slot = &worker.jobPool[worker.nextJob & (Worker::kJobPoolSize - 1)];
+	*slot = *job;
+	if (worker.queue.Push(slot)) {
+		worker.nextJob++;
+	} else {
+		// キューが一杯ならその場で実行する
+		Execute(job);
+	}
+}
+
+void JobSystem::WakeWorkers() {
+	generation_.fetch_add(1, std::memory_order_seq_cst);
+	if (sleepingCount_.load(std::memory_order_seq_cst) > 0) {
+		generation_.notify_all();
+	}
+}
+
+void JobSystem::Run(JobCounter& counter, JobFunction function, void* data) {
+	counter.value.fetch_add(1, std::memory_order_relaxed);
+	Job job = MakeJob(function, data, &counter, 0, 1);
+	uint32_t index = GetThreadIndex();
+	if (index >= threadCount_) {
+		// ワーカー以外のスレッドからはその場で実行する
+		Execute(&job);
+		return;
+	}
+	Submit(index, &job);
+	WakeWorkers();
+}
+
+void JobSystem::ParallelFor(JobCounter& counter, uint32_t count, uint32_t grainSize, JobFunction function, void* data) {
+	if (count == 0) {
+		return;
+	}
+	grainSize = std::max(grainSize, 1u);
+	uint32_t jobCount = (count - 1) / grainSize + 1;
+	counter.value.fetch_add(static_cast<int32_t>(jobCount), std::memory_order_relaxed);
+
+	uint32_t index = GetThreadIndex();
+	for (uint32_t i = 0; i < jobCount; ++i) {
+		uint32_t begin = i * grainSize;
+		Job job = MakeJob(function, data, &counter, begin, std::min(count, begin + grainSize));
+		if (index >= threadCount_) {
+			Execute(&job);
+		} else {
+			Submit(index, &job);
+		}
+	}
+	if (index < threadCount_) {
+		WakeWorkers();
+	}
+}
+
+void JobSystem::Wait(JobCounter& counter) {
+	uint32_t index = GetThreadIndex();
+	assert(index < threadCount_ || counter.IsDone());
+	while (!counter.IsDone()) {
+		Job* job = index < threadCount_ ? FindJob(index) : nullptr;
+		if (job) {
+			Execute(job);
+		} else {
+			// 残りは他のスレッドが実行中
+			std::this_thread::yield();
+		}
+	}
+}
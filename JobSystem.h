@@ -0,0 +1,142 @@
+#pragma once
+#include "AllocTracker.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// ワークスティーリングのジョブシステム。
+// スレッドごとに両端キューを持ち、自分のキューは後ろから、他のスレッドのキューは前から盗んで実行する。
+//   JobCounter counter;
+//   auto updateRows = [&](uint32_t begin, uint32_t end) { ... };
+//   jobs.ParallelFor(counter, rowCount, 8, updateRows);  // 8 行ずつのジョブに分ける
+//   jobs.Wait(counter);                                  // 待つ間も自分でジョブを実行する
+// 分割は grainSize だけで決まり、スレッド数には依存しない。各ジョブが別々の要素にだけ書き込むなら、
+// 結果はスレッド数に関係なく同じになる。
+// ジョブの関数オブジェクトは参照で持つので、Wait が返るまで生かしておくこと。
+// ジョブはスレッドごとの固定プールから取るので、投入でヒープ確保は起きない。
+// USE_ALLOC_TRACKER 時は投入元の TickScope をジョブに持たせ、ワーカーでの確保も定常状態チェックに数える。
+
+// 未完了のジョブ数。0 になったら完了
+struct JobCounter {
+	std::atomic<int32_t> value{0};
+
+	bool IsDone() const { return value.load(std::memory_order_acquire) == 0; }
+};
+
+class JobSystem {
+public:
+	// [begin, end) の範囲を処理する。単体のジョブは [0, 1)
+	using JobFunction = void (*)(void* data, uint32_t begin, uint32_t end);
+
+	static constexpr uint32_t kMaxThreads = 32;
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	~JobSystem();
+
+	// 初回はハードウェアスレッド数で起動する
+	static JobSystem& GetInstance();
+	// スレッド数（呼び出し元スレッドを含む、0 ならハードウェアスレッド数）を指定して作り直す。
+	// 呼び出したスレッドがメインスレッド（0 番）になる
+	static void Initialize(uint32_t threadCount);
+	static void Destroy();
+
+	void Run(JobCounter& counter, JobFunction function, void* data);
+	// [0, count) を grainSize ずつのジョブに分けて投入する
+	void ParallelFor(JobCounter& counter, uint32_t count, uint32_t grainSize, JobFunction function, void* data);
+
+	// function は void() / function(begin, end)
+	template <typename Function>
+	void Run(JobCounter& counter, Function& function) {
+		Run(counter, &CallSingle<Function>, &function);
+	}
+	template <typename Function>
+	void ParallelFor(JobCounter& counter, uint32_t count, uint32_t grainSize, Function& function) {
+		ParallelFor(counter, count, grainSize, &CallRange<Function>, &function);
+	}
+
+	// counter が 0 になるまで、ジョブを実行しながら待つ
+	void Wait(JobCounter& counter);
+
+	uint32_t GetThreadCount() const { return threadCount_; }
+	// 呼び出し元がワーカーでなければ UINT32_MAX
+	static uint32_t GetCurrentThreadIndex();
+
+	// 他のスレッドから盗んだジョブの累計（負荷分散の確認用）
+	uint64_t GetStealCount() const { return stealCount_.load(std::memory_order_relaxed); }
+
+private:
+	struct Job {
+		JobFunction function = nullptr;
+		void* data = nullptr;
+		JobCounter* counter = nullptr;
+		uint32_t begin = 0;
+		uint32_t end = 0;
+#ifdef USE_ALLOC_TRACKER
+		AllocTracker::TickScope* allocScope = nullptr; // 投入したスレッドの定常状態チェック
+#endif
+	};
+
+	// Chase-Lev の両端キュー（容量固定）。Push / Pop は所有スレッドのみ、Steal はどのスレッドからでも
+	class WorkQueue {
+	public:
+		static constexpr int64_t kCapacity = 1 << 12;
+
+		bool Push(Job* job);
+		Job* Pop();
+		Job* Steal();
+
+	private:
+		std::atomic<int64_t> top_{0};
+		std::atomic<int64_t> bottom_{0};
+		std::unique_ptr<std::atomic<Job*>[]> jobs_ = std::make_unique<std::atomic<Job*>[]>(kCapacity);
+	};
+
+	struct Worker {
+		WorkQueue queue;
+		// ジョブの置き場（リングで使い回す。キューに入りきる数の 2 倍にして、実行前のジョブを上書きしないようにする）
+		static constexpr uint32_t kJobPoolSize = 2u * WorkQueue::kCapacity;
+		std::unique_ptr<Job[]> jobPool = std::make_unique<Job[]>(kJobPoolSize);
+		uint32_t nextJob = 0;
+		uint32_t randomState = 0; // 盗む相手を選ぶ乱数
+		std::thread thread;
+	};
+
+	explicit JobSystem(uint32_t threadCount);
+
+	// このインスタンスでの呼び出し元スレッドの番号（ワーカーでなければ UINT32_MAX）
+	uint32_t GetThreadIndex() const;
+	void WorkerMain(uint32_t index);
+	// 自分のキュー、次に他のスレッドのキューからジョブを取る
+	Job* FindJob(uint32_t index);
+	void Execute(Job* job);
+	// 投入元スレッドの状態をジョブに持たせる
+	static Job MakeJob(JobFunction function, void* data, JobCounter* counter, uint32_t begin, uint32_t end);
+	void Submit(uint32_t index, Job* job);
+	// 投入後に寝ているワーカーを起こす
+	void WakeWorkers();
+
+	template <typename Function>
+	static void CallSingle(void* data, uint32_t, uint32_t) {
+		(*static_cast<Function*>(data))();
+	}
+	template <typename Function>
+	static void CallRange(void* data, uint32_t begin, uint32_t end) {
+		(*static_cast<Function*>(data))(begin, end);
+	}
+
+	static std::unique_ptr<JobSystem> instance_;
+
+	uint32_t threadCount_ = 1;
+	uint32_t serial_ = 0; // インスタンスごとの通し番号
+	std::vector<std::unique_ptr<Worker>> workers_;
+
+	// 寝ているワーカーを起こすための世代番号
+	std::atomic<uint32_t> generation_{0};
+	std::atomic<uint32_t> sleepingCount_{0};
+	std::atomic<bool> isRunning_{true};
+	std::atomic<uint64_t> stealCount_{0};
+};
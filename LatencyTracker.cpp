@@ -0,0 +1,146 @@
+#include "LatencyTracker.h"
+#include "KamataEngine.h"
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+using namespace KamataEngine;
+
+namespace {
+	constexpr uint32_t kStageCount = static_cast<uint32_t>(LatencyStage::kCount);
+
+	float ToMilliseconds(int64_t nanoseconds) { return static_cast<float>(nanoseconds) * 1.0e-6f; }
+}
+
+void LatencyHistogram::Add(float milliseconds) {
+	milliseconds = std::max(milliseconds, 0.0f);
+	const uint32_t index = std::min(kBucketCount - 1, static_cast<uint32_t>(milliseconds / kBucketMilliseconds));
+	buckets_[index]++;
+	count_++;
+	sumMilliseconds_ += milliseconds;
+	maxMilliseconds_ = std::max(maxMilliseconds_, milliseconds);
+}
+
+void LatencyHistogram::Reset() { *this = LatencyHistogram(); }
+
+float LatencyHistogram::GetPercentileMilliseconds(double p) const {
+	if (count_ == 0) {
+		return 0.0f;
+	}
+	// Soak と同じく、ソートした位置 p * count の値が入っているバケツ
+	const uint64_t rank = std::min(count_ - 1, static_cast<uint64_t>(p * static_cast<double>(count_)));
+	uint64_t cumulative = 0;
+	for (uint32_t i = 0; i < kBucketCount; ++i) {
+		cumulative += buckets_[i];
+		if (cumulative > rank) {
+			return i + 1 == kBucketCount ? maxMilliseconds_ : std::min(static_cast<float>(i + 1) * kBucketMilliseconds, maxMilliseconds_);
+		}
+	}
+	return maxMilliseconds_;
+}
+
+void LatencyTracker::Record(const LatencySample& sample) {
+	const bool isComplete = sample.inputTimestamp != 0 && sample.consumeTimestamp != 0 && sample.publishTimestamp != 0 && sample.presentTimestamp != 0;
+	if (!isComplete || sample.consumeTimestamp < sample.inputTimestamp || sample.publishTimestamp < sample.consumeTimestamp ||
+	    sample.presentTimestamp < sample.publishTimestamp) {
+		invalidCount_++;
+		return;
+	}
+	histograms_[static_cast<uint32_t>(LatencyStage::kInputToConsume)].Add(ToMilliseconds(sample.consumeTimestamp - sample.inputTimestamp));
+	histograms_[static_cast<uint32_t>(LatencyStage::kConsumeToPublish)].Add(ToMilliseconds(sample.publishTimestamp - sample.consumeTimestamp));
+	histograms_[static_cast<uint32_t>(LatencyStage::kPublishToPresent)].Add(ToMilliseconds(sample.presentTimestamp - sample.publishTimestamp));
+	const float total = ToMilliseconds(sample.presentTimestamp - sample.inputTimestamp);
+	histograms_[static_cast<uint32_t>(LatencyStage::kInputToPresent)].Add(total);
+
+	history_[historyIndex_] = total;
+	historyIndex_ = (historyIndex_ + 1) % kHistorySize;
+}
+
+void LatencyTracker::Reset() {
+	for (LatencyHistogram& histogram : histograms_) {
+		histogram.Reset();
+	}
+	invalidCount_ = 0;
+	std::fill(std::begin(history_), std::end(history_), 0.0f);
+	historyIndex_ = 0;
+}
+
+const char* LatencyTracker::GetStageName(LatencyStage stage) {
+	switch (stage) {
+	case LatencyStage::kInputToConsume:
+		return "input_to_consume";
+	case LatencyStage::kConsumeToPublish:
+		return "consume_to_publish";
+	case LatencyStage::kPublishToPresent:
+		return "publish_to_present";
+	case LatencyStage::kInputToPresent:
+		return "input_to_present";
+	default:
+		return "unknown";
+	}
+}
+
+bool LatencyTracker::WriteCsv(const std::string& path) const {
+	std::ofstream file(path);
+	if (!file.is_open()) {
+		return false;
+	}
+	file << "bucket_begin_ms,bucket_end_ms";
+	for (uint32_t stage = 0; stage < kStageCount; ++stage) {
+		file << ',' << GetStageName(static_cast<LatencyStage>(stage));
+	}
+	file << '\n';
+	for (uint32_t i = 0; i < LatencyHistogram::kBucketCount; ++i) {
+		char range[64];
+		snprintf(range, sizeof(range), "%.2f,%.2f", static_cast<double>(i) * LatencyHistogram::kBucketMilliseconds,
+		         static_cast<double>(i + 1) * LatencyHistogram::kBucketMilliseconds);
+		file << range;
+		for (uint32_t stage = 0; stage < kStageCount; ++stage) {
+			file << ',' << histograms_[stage].GetBucket(i);
+		}
+		file << '\n';
+	}
+	return file.good();
+}
+
+void LatencyTracker::DrawImGui() {
+#ifdef USE_IMGUI
+	ImGui::Begin("Latency");
+	ImGui::Text("Frames %llu (invalid %llu)", static_cast<unsigned long long>(GetRecordedCount()), static_cast<unsigned long long>(invalidCount_));
+	for (uint32_t stage = 0; stage < kStageCount; ++stage) {
+		const LatencyHistogram& histogram = histograms_[stage];
+		ImGui::Text("%-18s avg %6.2f  p50 %6.2f  p99 %6.2f  max %6.2f ms", GetStageName(static_cast<LatencyStage>(stage)), histogram.GetMeanMilliseconds(),
+		            histogram.GetPercentileMilliseconds(0.5), histogram.GetPercentileMilliseconds(0.99), histogram.GetMaxMilliseconds());
+	}
+	ImGui::PlotLines("Input -> present (ms)", history_, static_cast<int>(kHistorySize), static_cast<int>(historyIndex_), nullptr, 0.0f, 100.0f,
+	                 ImVec2(0, 60));
+
+	// 全体のヒストグラム（0 ~ 100 ms）
+	const LatencyHistogram& total = GetHistogram(LatencyStage::kInputToPresent);
+	float buckets[LatencyHistogram::kBucketCount];
+	for (uint32_t i = 0; i < LatencyHistogram::kBucketCount; ++i) {
+		buckets[i] = static_cast<float>(total.GetBucket(i));
+	}
+	ImGui::PlotHistogram("Input -> present", buckets, static_cast<int>(LatencyHistogram::kBucketCount), 0, nullptr, 0.0f, FLT_MAX, ImVec2(0, 60));
+
+	if (ImGui::Button("Write CSV")) {
+		isLastCsvWritten_ = WriteCsv(csvPath_);
+		hasCsvResult_ = true;
+	}
+	ImGui::SameLine();
+	if (ImGui::Button("Reset")) {
+		Reset();
+	}
+	if (hasCsvResult_) {
+		ImGui::Text(isLastCsvWritten_ ? "Wrote %s" : "Failed to write %s", csvPath_.c_str());
+	}
+	ImGui::End();
+#endif
+}
+
+int64_t DirectXFramePresenter::Present() {
+	DirectXCommon::GetInstance()->PostDraw();
+	// SimulationThread::GetTimestamp と同じ基準
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <utility>
+
+// 入力から画面に出るまでの遅れ（input-to-photon）の計測。
+// フレームごとに 4 つの時刻（steady_clock のナノ秒）を集め、区間ごとのヒストグラムに積む。
+//   入力を読んだ -> シミュレーションが使った -> 描く状態を公開した -> Present を提出した
+// 時刻は呼び出し側が渡すので、偽の時計と FakeFramePresenter で描画なしに確かめられる（-bench）。
+struct LatencySample {
+	int64_t inputTimestamp = 0;   // 入力を読んだ時刻
+	int64_t consumeTimestamp = 0; // シミュレーションがその入力を使った時刻
+	int64_t publishTimestamp = 0; // 描く状態（スナップショット）を公開した時刻
+	int64_t presentTimestamp = 0; // Present を提出し終えた時刻
+};
+
+enum class LatencyStage : uint8_t {
+	kInputToConsume,
+	kConsumeToPublish,
+	kPublishToPresent,
+	kInputToPresent, // 全体
+	kCount,
+};
+
+// 固定幅のバケツのヒストグラム（確保なし）。範囲を超えた値は最後のバケツに入れる
+class LatencyHistogram {
+public:
+	static constexpr uint32_t kBucketCount = 200;
+	static constexpr float kBucketMilliseconds = 0.5f; // 0 ~ 100 ms
+
+	void Add(float milliseconds);
+	void Reset();
+
+	uint64_t GetCount() const { return count_; }
+	uint32_t GetBucket(uint32_t index) const { return buckets_[index]; }
+	float GetMeanMilliseconds() const { return count_ > 0 ? static_cast<float>(sumMilliseconds_ / static_cast<double>(count_)) : 0.0f; }
+	float GetMaxMilliseconds() const { return maxMilliseconds_; }
+	// 割合 p（0 ~ 1）の値。バケツの上端を返す（実際の値以上になる）
+	float GetPercentileMilliseconds(double p) const;
+
+private:
+	uint32_t buckets_[kBucketCount] = {};
+	uint64_t count_ = 0;
+	double sumMilliseconds_ = 0.0;
+	float maxMilliseconds_ = 0.0f;
+};
+
+class LatencyTracker {
+public:
+	static constexpr uint32_t kHistorySize = 256;
+
+	// 1 フレーム分を積む。時刻が欠けている・逆順のフレームは数えるだけで積まない
+	void Record(const LatencySample& sample);
+	void Reset();
+
+	const LatencyHistogram& GetHistogram(LatencyStage stage) const { return histograms_[static_cast<uint32_t>(stage)]; }
+	uint64_t GetRecordedCount() const { return histograms_[static_cast<uint32_t>(LatencyStage::kInputToPresent)].GetCount(); }
+	uint64_t GetInvalidCount() const { return invalidCount_; }
+	static const char* GetStageName(LatencyStage stage);
+
+	// ヒストグラムを CSV に書き出す（1 行 1 バケツ、列は区間ごとの回数）。失敗したら false
+	bool WriteCsv(const std::string& path) const;
+	// ImGui のボタンで書き出す先
+	void SetCsvPath(std::string path) { csvPath_ = std::move(path); }
+	const std::string& GetCsvPath() const { return csvPath_; }
+
+	void DrawImGui();
+
+private:
+	LatencyHistogram histograms_[static_cast<uint32_t>(LatencyStage::kCount)];
+	uint64_t invalidCount_ = 0;
+
+	// ImGui 用の直近の全体の遅れ
+	float history_[kHistorySize] = {};
+	uint32_t historyIndex_ = 0;
+	std::string csvPath_ = "latency.csv";
+	bool isLastCsvWritten_ = false;
+	bool hasCsvResult_ = false;
+};
+
+// フレームを画面に出す先。提出を終えた時刻を返す（LatencySample::presentTimestamp になる）
+class IFramePresenter {
+public:
+	virtual ~IFramePresenter() = default;
+	virtual int64_t Present() = 0;
+};
+
+// DirectXCommon::PostDraw で出す（通常のプレイ）
+class DirectXFramePresenter : public IFramePresenter {
+public:
+	int64_t Present() override;
+};
+
+// 描画しない Present（ベンチマーク用）。呼ばれた時刻は外から決め、提出にかかる時間を足して返す
+class FakeFramePresenter : public IFramePresenter {
+public:
+	void SetNow(int64_t now) { now_ = now; }
+	void SetSubmitNanoseconds(int64_t nanoseconds) { submitNanoseconds_ = nanoseconds; }
+	uint64_t GetPresentCount() const { return presentCount_; }
+
+	int64_t Present() override {
+		presentCount_++;
+		return now_ + submitNanoseconds_;
+	}
+
+private:
+	int64_t now_ = 0;
+	int64_t submitNanoseconds_ = 0;
+	uint64_t presentCount_ = 0;
+};
@@ -0,0 +1,62 @@
+#include "LevelData.h"
+#include "LevelRegistry.h"
+#include "Logger.h"
+#include "Profiler.h"
+#include <chrono>
+
+std::unique_ptr<LevelData> BuildLevelData(int mapID) {
+	PROFILE_FUNCTION();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	std::unique_ptr<LevelData> levelData = std::make_unique<LevelData>();
+	levelData->mapID = mapID;
+	levelData->mapChipField = std::make_unique<MapChipField>();
+
+	// 清单在启动时已经验证过，未登记或无效的关卡使用 fallback
+	const LevelEntry* entry = LevelRegistry::GetInstance().FindOrFallback(mapID);
+	if (entry) {
+		levelData->mapPath = entry->path;
+		levelData->mapChecksum = entry->checksum;
+		// 验证之后文件可能被删除或改坏（热重载、游戏中途），读取失败时使用空白地图
+		if (!levelData->mapChipField->LoadMapChipCsv(entry->path)) {
+			LOG_ERROR(LogCategory::kLevel, "BuildLevelData: Failed to load %s", entry->path.c_str());
+			levelData->mapChipField->ResetMapChipData();
+		}
+	} else {
+		levelData->mapChipField->ResetMapChipData();
+	}
+
+	MapChipField* mapChipField = levelData->mapChipField.get();
+	uint32_t numBlockVertical = mapChipField->GetNumBlockVertical();
+	uint32_t numBlockHorizontal = mapChipField->GetNumBlockHorizontal();
+	for (uint32_t i = 0; i < numBlockVertical; i++) {
+		for (uint32_t j = 0; j < numBlockHorizontal; j++) {
+			switch (mapChipField->GetMapChipTypeByIndex(j, i)) {
+			case MapChipType::kBlock:
+				levelData->blockIndices.push_back({j, i});
+				levelData->blockPositions.push_back(mapChipField->GetMapChipPositionByIndex(j, i));
+				break;
+			case MapChipType::kSpawn:
+				levelData->spawnIndices.push_back({j, i});
+				break;
+			case MapChipType::kGoal:
+				levelData->goalIndices.push_back({j, i});
+				break;
+			case MapChipType::kAgentPatrol:
+			case MapChipType::kAgentFalling:
+			case MapChipType::kAgentChaser:
+				levelData->agentIndices.push_back({j, i});
+				break;
+			default:
+				break;
+			}
+		}
+	}
+
+	levelData->autotile.Build(*mapChipField);
+	levelData->blockMeshes.Build(*mapChipField, &levelData->autotile);
+
+	std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	levelData->buildMilliseconds = elapsed.count();
+	return levelData;
+}
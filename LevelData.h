@@ -0,0 +1,30 @@
+#pragma once
+#include "MapChipField.h"
+#include "Autotile.h"
+#include "ChunkMesh.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// 从地图文件构建出的关卡数据。只做文件解析和索引扫描，不调用引擎，
+// 因此可以在后台线程上构建，再交给 GameScene 使用。
+struct LevelData {
+	int mapID = 0;
+	std::string mapPath;
+	uint64_t mapChecksum = 0; // 启动时验证的文件内容（热重载时内容相同就不重新读取）
+	std::unique_ptr<MapChipField> mapChipField;
+
+	// 按行优先顺序扫描得到的格子（与 GenerateBlocks 的遍历顺序一致）
+	std::vector<IndexSet> blockIndices;
+	std::vector<Vector3> blockPositions;
+	std::vector<IndexSet> spawnIndices;
+	std::vector<IndexSet> goalIndices;
+	std::vector<IndexSet> agentIndices; // 敌人・障碍物（种类看地图的值）
+	AutotileMap autotile; // 每个方块的拼接种类（在这里预先算好）
+	ChunkMeshBaker blockMeshes; // 按区块合并好的方块网格
+
+	float buildMilliseconds = 0.0f; // 构建耗时
+};
+
+// 加载地图并扫描方块/出生点/终点（路径从 LevelRegistry 中取得）
+std::unique_ptr<LevelData> BuildLevelData(int mapID);
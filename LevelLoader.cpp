@@ -0,0 +1,73 @@
+#include "LevelLoader.h"
+#include "Logger.h"
+#include <chrono>
+#include <cstdio>
+
+namespace {
+	// 作废请求的列表的初始容量（通常只有 0 ~ 1 个）
+	constexpr size_t kRetiredReserve = 4;
+}
+
+LevelLoader::LevelLoader() { retired_.reserve(kRetiredReserve); }
+
+void LevelLoader::Request(int mapID) {
+	Update();
+	if (HasRequest(mapID)) {
+		return;
+	}
+
+	Retire();
+	requestedMapID_ = mapID;
+	hasRequest_ = true;
+	future_ = std::async(std::launch::async, [mapID]() { return BuildLevelData(mapID); });
+
+	LOG_DEBUG(LogCategory::kLevel, "LevelLoader: Preloading map %d in background", mapID);
+}
+
+void LevelLoader::Cancel() {
+	if (hasRequest_) {
+		LOG_DEBUG(LogCategory::kLevel, "LevelLoader: Cancelled preload of map %d", requestedMapID_);
+	}
+	Retire();
+	hasRequest_ = false;
+}
+
+void LevelLoader::Update() {
+	if (retired_.empty()) {
+		return;
+	}
+	std::erase_if(retired_, [](const std::future<std::unique_ptr<LevelData>>& future) {
+		return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+	});
+}
+
+bool LevelLoader::IsReady() const {
+	if (!hasRequest_ || !future_.valid()) {
+		return false;
+	}
+	return future_.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+std::unique_ptr<LevelData> LevelLoader::Take(int mapID) {
+	if (!HasRequest(mapID) || !future_.valid()) {
+		return nullptr;
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::unique_ptr<LevelData> levelData = future_.get();
+	std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	lastWaitMilliseconds_ = elapsed.count();
+	hasRequest_ = false;
+	return levelData;
+}
+
+void LevelLoader::Retire() {
+	if (!future_.valid()) {
+		return;
+	}
+	if (future_.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+		retired_.push_back(std::move(future_));
+	}
+	// 已经完成的直接释放（不会等待）
+	future_ = {};
+}
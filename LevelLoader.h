@@ -0,0 +1,45 @@
+#pragma once
+#include "LevelData.h"
+#include <future>
+#include <memory>
+#include <vector>
+
+// 在后台线程预先构建下一个关卡的 LevelData。
+// 结束阶段的淡出开始时 Request()，淡出结束切换场景时 Take()。
+// 没有被取走的请求在场景切换、重新开始和热重载时 Cancel()，以免之后交出旧的数据。
+// 作废或被替换的请求不在主线程上等待，放进列表里，完成后再释放。
+class LevelLoader {
+public:
+	LevelLoader();
+	// 还在运行的后台任务在这里等待结束（只在退出时）
+	~LevelLoader() = default;
+
+	// 开始在后台加载（同一关卡已在加载中则什么都不做，其他关卡的请求被作废）
+	void Request(int mapID);
+	// 作废当前的请求（之后的 Take() 返回 nullptr）
+	void Cancel();
+	// 释放已经完成的作废请求（每帧调用，不会等待）
+	void Update();
+
+	// 是否有指定关卡的预加载
+	bool HasRequest(int mapID) const { return hasRequest_ && requestedMapID_ == mapID; }
+	bool IsReady() const;
+
+	// 取出预加载结果。还没完成时会等待完成；没有请求过该关卡则返回 nullptr
+	std::unique_ptr<LevelData> Take(int mapID);
+
+	// 上一次 Take() 等待后台线程的时间（毫秒）
+	float GetLastWaitMilliseconds() const { return lastWaitMilliseconds_; }
+	// 还没结束的作废请求数
+	size_t GetRetiredCount() const { return retired_.size(); }
+
+private:
+	// 作废请求的 future（析构会等待，所以不能直接丢弃）
+	void Retire();
+
+	std::future<std::unique_ptr<LevelData>> future_;
+	std::vector<std::future<std::unique_ptr<LevelData>>> retired_;
+	int requestedMapID_ = 0;
+	bool hasRequest_ = false;
+	float lastWaitMilliseconds_ = 0.0f;
+};
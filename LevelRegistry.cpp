@@ -0,0 +1,219 @@
+#include "LevelRegistry.h"
+#include "Logger.h"
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <sstream>
+
+std::unique_ptr<LevelRegistry> LevelRegistry::instance_ = nullptr;
+
+namespace {
+	std::vector<std::string> SplitCsvLine(const std::string& line) {
+		std::vector<std::string> fields;
+		std::istringstream lineStream(line);
+		std::string field;
+		while (std::getline(lineStream, field, ',')) {
+			// 去掉前后空白（包括 Windows 的 \r）
+			size_t begin = field.find_first_not_of(" \t\r");
+			size_t end = field.find_last_not_of(" \t\r");
+			fields.push_back(begin == std::string::npos ? std::string() : field.substr(begin, end - begin + 1));
+		}
+		return fields;
+	}
+
+	bool ParseInt(const std::string& text, int& value) {
+		const char* last = text.data() + text.size();
+		std::from_chars_result result = std::from_chars(text.data(), last, value);
+		return result.ec == std::errc() && result.ptr == last;
+	}
+
+	LevelFormat ParseFormat(const std::string& text) {
+		if (text == "csv") {
+			return LevelFormat::kCsv;
+		}
+		if (text == "tmx") {
+			return LevelFormat::kTmx;
+		}
+		return LevelFormat::kUnknown;
+	}
+}
+
+LevelRegistry& LevelRegistry::GetInstance() {
+	if (!instance_) {
+		instance_ = std::unique_ptr<LevelRegistry>(new LevelRegistry());
+	}
+	return *instance_;
+}
+
+void LevelRegistry::Destroy() { instance_.reset(); }
+
+bool LevelRegistry::LoadManifest(const std::string& manifestPath) {
+	entries_.clear();
+	indexByID_.clear();
+	errors_.clear();
+	hasFallback_ = false;
+
+	std::ifstream file(manifestPath);
+	if (!file.is_open()) {
+		errors_.push_back("Level manifest not found: " + manifestPath);
+		LOG_ERROR(LogCategory::kLevel, "LevelRegistry: %s", errors_.back());
+		return false;
+	}
+
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(file, line)) {
+		lineNumber++;
+		std::vector<std::string> fields = SplitCsvLine(line);
+		if (fields.empty() || fields[0].empty() || fields[0][0] == '#') {
+			continue;
+		}
+
+		if (fields[0] == "fallback") {
+			if (fields.size() < 3) {
+				errors_.push_back("levels.csv:" + std::to_string(lineNumber) + ": fallback needs path and format");
+				continue;
+			}
+			fallback_ = LevelEntry();
+			fallback_.id = -1;
+			fallback_.path = fields[1];
+			fallback_.format = ParseFormat(fields[2]);
+			hasFallback_ = true;
+			continue;
+		}
+
+		LevelEntry entry;
+		if (fields.size() < 5 || !ParseInt(fields[0], entry.id) || entry.id < 0 || !ParseInt(fields[3], entry.nextID) || !ParseInt(fields[4], entry.returnID)) {
+			errors_.push_back("levels.csv:" + std::to_string(lineNumber) + ": expected id,path,format,next,return");
+			continue;
+		}
+		// 重复的 id 不覆盖先登记的关卡
+		if (static_cast<size_t>(entry.id) >= indexByID_.size()) {
+			indexByID_.resize(static_cast<size_t>(entry.id) + 1, -1);
+		}
+		if (indexByID_[entry.id] != -1) {
+			errors_.push_back("levels.csv:" + std::to_string(lineNumber) + ": duplicate level id " + std::to_string(entry.id));
+			continue;
+		}
+		indexByID_[entry.id] = static_cast<int32_t>(entries_.size());
+		entry.path = fields[1];
+		entry.format = ParseFormat(fields[2]);
+		entries_.push_back(std::move(entry));
+	}
+
+	// 所有文件并行验证
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::vector<std::future<void>> validations;
+	for (LevelEntry& entry : entries_) {
+		validations.push_back(std::async(std::launch::async, [&entry]() { ValidateEntry(entry); }));
+	}
+	if (hasFallback_) {
+		validations.push_back(std::async(std::launch::async, [this]() { ValidateEntry(fallback_); }));
+	}
+	for (std::future<void>& validation : validations) {
+		validation.get();
+	}
+	std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	validationMilliseconds_ = elapsed.count();
+
+	// 启动时报告所有问题
+	for (const LevelEntry& entry : entries_) {
+		if (!entry.isValid) {
+			errors_.push_back("Level " + std::to_string(entry.id) + " (" + entry.path + "): " + entry.error);
+		}
+		if (!Find(entry.nextID) || !Find(entry.returnID)) {
+			errors_.push_back("Level " + std::to_string(entry.id) + ": next/return target is not registered");
+		}
+	}
+	if (hasFallback_ && !fallback_.isValid) {
+		errors_.push_back("Fallback level (" + fallback_.path + "): " + fallback_.error);
+	}
+
+	LOG_DEBUG(LogCategory::kLevel, "LevelRegistry: %zu levels validated in %.2f ms", entries_.size(), validationMilliseconds_);
+	for (const std::string& error : errors_) {
+		LOG_ERROR(LogCategory::kLevel, "LevelRegistry: %s", error);
+	}
+
+	return errors_.empty();
+}
+
+const LevelEntry* LevelRegistry::Find(int id) const {
+	if (id < 0 || static_cast<size_t>(id) >= indexByID_.size() || indexByID_[id] < 0) {
+		return nullptr;
+	}
+	return &entries_[indexByID_[id]];
+}
+
+const LevelEntry* LevelRegistry::FindOrFallback(int id) const {
+	const LevelEntry* entry = Find(id);
+	if (entry && entry->isValid) {
+		return entry;
+	}
+	if (hasFallback_ && fallback_.isValid) {
+		return &fallback_;
+	}
+	return nullptr;
+}
+
+uint64_t LevelRegistry::ComputeChecksum(const std::string& content) {
+	// FNV-1a 64bit
+	uint64_t hash = 14695981039346656037ull;
+	for (char c : content) {
+		hash ^= static_cast<uint8_t>(c);
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+void LevelRegistry::ValidateEntry(LevelEntry& entry) {
+	if (entry.format != LevelFormat::kCsv) {
+		entry.error = "unsupported format";
+		return;
+	}
+
+	std::ifstream file(entry.path, std::ios::binary);
+	if (!file.is_open()) {
+		entry.error = "file not found";
+		return;
+	}
+	std::stringstream contentStream;
+	contentStream << file.rdbuf();
+	const std::string content = contentStream.str();
+
+	entry.checksum = ComputeChecksum(content);
+
+	// 尺寸：非空行数 x 最大列数（与 LoadMapChipCsv 相同的规则）
+	uint32_t rows = 0;
+	uint32_t maxColumns = 0;
+	uint32_t columns = 1;
+	bool lineHasContent = false;
+	for (char c : content) {
+		if (c == '\n') {
+			if (lineHasContent) {
+				rows++;
+				maxColumns = columns > maxColumns ? columns : maxColumns;
+			}
+			columns = 1;
+			lineHasContent = false;
+		} else if (c != '\r') {
+			lineHasContent = true;
+			if (c == ',') {
+				columns++;
+			}
+		}
+	}
+	if (lineHasContent) {
+		rows++;
+		maxColumns = columns > maxColumns ? columns : maxColumns;
+	}
+
+	if (rows == 0 || maxColumns == 0) {
+		entry.error = "empty map";
+		return;
+	}
+	entry.width = maxColumns;
+	entry.height = rows;
+	entry.isValid = true;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 关卡文件格式
+enum class LevelFormat {
+	kCsv,
+	kTmx,
+	kUnknown,
+};
+
+// 清单中的一个关卡。启动时验证后不再修改，可以从任意线程读取。
+struct LevelEntry {
+	int id = 0;
+	std::string path;
+	LevelFormat format = LevelFormat::kUnknown;
+	int nextID = 0;   // 自动下一关的目标
+	int returnID = 0; // 返回的目标
+
+	// 验证结果
+	bool isValid = false;
+	uint32_t width = 0;
+	uint32_t height = 0;
+	uint64_t checksum = 0; // 文件内容的 FNV-1a
+	std::string error;
+};
+
+// 启动时读取一次关卡清单（Resources/map/levels.csv），并行验证所有文件。
+// 切换场景时只做 O(1) 查找，不再访问文件系统。
+class LevelRegistry {
+public:
+	LevelRegistry(const LevelRegistry&) = delete;
+	LevelRegistry& operator=(const LevelRegistry&) = delete;
+
+	~LevelRegistry() = default;
+
+	static LevelRegistry& GetInstance();
+	static void Destroy();
+
+	// 读取清单并验证，全部关卡有效时返回 true
+	bool LoadManifest(const std::string& manifestPath);
+
+	// 查找关卡（未登记时返回 nullptr）
+	const LevelEntry* Find(int id) const;
+	// 查找有效的关卡，没有时返回 fallback 关卡
+	const LevelEntry* FindOrFallback(int id) const;
+
+	// 文件内容的 FNV-1a 64bit（与 LevelEntry::checksum 相同，热重载用来判断内容是否真的变了）
+	static uint64_t ComputeChecksum(const std::string& content);
+
+	const std::vector<LevelEntry>& GetEntries() const { return entries_; }
+	const std::vector<std::string>& GetErrors() const { return errors_; }
+	float GetValidationMilliseconds() const { return validationMilliseconds_; }
+
+private:
+	LevelRegistry() = default;
+	static std::unique_ptr<LevelRegistry> instance_;
+
+	static void ValidateEntry(LevelEntry& entry);
+
+	std::vector<LevelEntry> entries_;
+	std::vector<int32_t> indexByID_; // id -> entries_ 的下标（-1 表示未登记）
+	LevelEntry fallback_;
+	bool hasFallback_ = false;
+	std::vector<std::string> errors_;
+	float validationMilliseconds_ = 0.0f;
+};
@@ -0,0 +1,318 @@
+#include "Logger.h"
+#include "KamataEngine.h"
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+
+std::unique_ptr<Logger> Logger::instance_ = nullptr;
+
+namespace {
+	const char* const kLevelNames[] = {"TRACE", "DEBUG", "INFO", "WARN", "ERROR"};
+	const char* const kCategoryNames[] = {"General", "Player", "Goal", "Scene", "Level", "Sequence"};
+	static_assert(std::size(kCategoryNames) == static_cast<size_t>(LogCategory::kCount));
+
+	constexpr std::chrono::milliseconds kIdleSleep(1);
+
+	int64_t AsSigned(LogRecord::ArgumentType type, uint64_t value) {
+		if (type == LogRecord::ArgumentType::kDouble) {
+			double number = 0.0;
+			std::memcpy(&number, &value, sizeof(number));
+			return static_cast<int64_t>(number);
+		}
+		return static_cast<int64_t>(value);
+	}
+
+	double AsDouble(LogRecord::ArgumentType type, uint64_t value) {
+		switch (type) {
+		case LogRecord::ArgumentType::kDouble: {
+			double number = 0.0;
+			std::memcpy(&number, &value, sizeof(number));
+			return number;
+		}
+		case LogRecord::ArgumentType::kSigned:
+			return static_cast<double>(static_cast<int64_t>(value));
+		default:
+			return static_cast<double>(value);
+		}
+	}
+}
+
+Logger& Logger::GetInstance() {
+	if (!instance_) {
+		instance_ = std::unique_ptr<Logger>(new Logger());
+	}
+	return *instance_;
+}
+
+void Logger::Destroy() { instance_.reset(); }
+
+Logger::Logger() {
+	cells_ = std::make_unique<Cell[]>(kCapacity);
+	for (uint32_t i = 0; i < kCapacity; ++i) {
+		cells_[i].sequence.store(i, std::memory_order_relaxed);
+	}
+#ifdef _DEBUG
+	minimumLevel_.store(static_cast<uint8_t>(LogLevel::kTrace), std::memory_order_relaxed);
+#else
+	minimumLevel_.store(static_cast<uint8_t>(LogLevel::kInfo), std::memory_order_relaxed);
+#endif
+	originTicks_ = Now();
+	originTime_ = std::chrono::steady_clock::now();
+	worker_ = std::thread(&Logger::Run, this);
+}
+
+Logger::~Logger() {
+	isRunning_.store(false, std::memory_order_release);
+	if (worker_.joinable()) {
+		worker_.join();
+	}
+}
+
+uint16_t Logger::AssignThreadID() {
+	static std::atomic<uint16_t> nextThreadID{0};
+	return nextThreadID.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Logger::SetCategoryEnabled(LogCategory category, bool isEnabled) {
+	uint32_t bit = 1u << static_cast<uint32_t>(category);
+	if (isEnabled) {
+		categoryMask_.fetch_or(bit, std::memory_order_relaxed);
+	} else {
+		categoryMask_.fetch_and(~bit, std::memory_order_relaxed);
+	}
+}
+
+Logger::Cell* Logger::Claim(uint64_t& position) {
+	position = enqueuePosition_.load(std::memory_order_relaxed);
+	for (;;) {
+		Cell* cell = &cells_[position & (kCapacity - 1)];
+		uint64_t sequence = cell->sequence.load(std::memory_order_acquire);
+		int64_t difference = static_cast<int64_t>(sequence) - static_cast<int64_t>(position);
+		if (difference == 0) {
+			// 失敗したら position が最新の値になるのでやり直す
+			if (enqueuePosition_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+				return cell;
+			}
+		} else if (difference < 0) {
+			// 1 周前のレコードがまだ出力されていない
+			return nullptr;
+		} else {
+			position = enqueuePosition_.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+bool Logger::Admit(LogSite& site, uint32_t& suppressedBefore) {
+	uint32_t window = currentWindow_.load(std::memory_order_relaxed);
+	if (site.window.load(std::memory_order_relaxed) != window) {
+		// 新しい 1 秒に入った。最初に気付いたスレッドだけがリセットする
+		if (site.window.exchange(window, std::memory_order_relaxed) != window) {
+			site.count.store(0, std::memory_order_relaxed);
+			suppressedBefore = site.suppressed.exchange(0, std::memory_order_relaxed);
+		}
+	}
+	if (site.count.fetch_add(1, std::memory_order_relaxed) < site.ratePerSecond) {
+		return true;
+	}
+	site.suppressed.fetch_add(1, std::memory_order_relaxed);
+	suppressedCount_.fetch_add(1, std::memory_order_relaxed);
+	return false;
+}
+
+uint64_t Logger::StoreString(LogRecord& record, std::string_view text) {
+	size_t remaining = LogRecord::kTextCapacity - record.textUsed;
+	if (remaining == 0) {
+		// 最後の 1 バイトは常に終端
+		return LogRecord::kTextCapacity - 1;
+	}
+	size_t offset = record.textUsed;
+	size_t length = std::min(text.size(), remaining - 1);
+	std::memcpy(record.text + offset, text.data(), length);
+	record.text[offset + length] = '\0';
+	record.textUsed = static_cast<uint8_t>(offset + length + 1);
+	return offset;
+}
+
+void Logger::Run() {
+	std::string output;
+	output.reserve(64 * 1024);
+	while (isRunning_.load(std::memory_order_acquire)) {
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		std::chrono::duration<double> elapsed = now - originTime_;
+		currentWindow_.store(static_cast<uint32_t>(elapsed.count()) + 1, std::memory_order_relaxed);
+#ifdef LOGGER_HAS_RDTSC
+		// 起動からの経過で TSC の周波数を補正する
+		if (elapsed.count() > 0.001) {
+			ticksPerSecond_ = static_cast<double>(Now() - originTicks_) / elapsed.count();
+		}
+#endif
+		if (Drain(output) == 0) {
+			std::this_thread::sleep_for(kIdleSleep);
+		}
+	}
+	Drain(output);
+}
+
+size_t Logger::Drain(std::string& output) {
+	output.clear();
+	size_t count = 0;
+	for (;;) {
+		Cell& cell = cells_[dequeuePosition_ & (kCapacity - 1)];
+		if (cell.sequence.load(std::memory_order_acquire) != dequeuePosition_ + 1) {
+			break;
+		}
+		FormatRecord(cell.record, output);
+		// セルを 1 周後の書き込みに開放する
+		cell.sequence.store(dequeuePosition_ + kCapacity, std::memory_order_release);
+		dequeuePosition_++;
+		count++;
+	}
+	if (count > 0) {
+		fwrite(output.data(), 1, output.size(), stdout);
+		fflush(stdout);
+		writtenCount_.fetch_add(count, std::memory_order_relaxed);
+	}
+	drainedPosition_.store(dequeuePosition_, std::memory_order_release);
+	return count;
+}
+
+void Logger::FormatRecord(const LogRecord& record, std::string& out) const {
+	char buffer[256];
+	double seconds = static_cast<double>(record.timestamp - originTicks_) / ticksPerSecond_;
+	int written = snprintf(buffer, sizeof(buffer), "[%10.4f] %-5s %-8s ", seconds, kLevelNames[static_cast<size_t>(record.level)],
+	                       kCategoryNames[static_cast<size_t>(record.category)]);
+	out.append(buffer, static_cast<size_t>(std::clamp(written, 0, static_cast<int>(sizeof(buffer) - 1))));
+
+	// printf の書式を 1 つずつ読み、型タグに合わせた長さ指定を付け直して整形する
+	size_t argumentIndex = 0;
+	for (const char* c = record.format; *c; ++c) {
+		if (*c != '%') {
+			// 末尾の改行は後で付ける
+			if (!(*c == '\n' && c[1] == '\0')) {
+				out += *c;
+			}
+			continue;
+		}
+		if (c[1] == '%') {
+			out += '%';
+			++c;
+			continue;
+		}
+
+		char spec[32] = {'%'};
+		size_t specLength = 1;
+		const char* p = c + 1;
+		for (; *p && std::strchr("-+ #0123456789.", *p); ++p) {
+			if (specLength < sizeof(spec) - 4) {
+				spec[specLength++] = *p;
+			}
+		}
+		for (; *p && std::strchr("hlzjtL", *p); ++p) {
+		}
+		const char conversion = *p;
+		if (conversion == '\0') {
+			break;
+		}
+		c = p;
+		if (argumentIndex >= record.argumentCount) {
+			out += "<?>";
+			continue;
+		}
+		const LogRecord::ArgumentType type = record.types[argumentIndex];
+		const uint64_t value = record.values[argumentIndex];
+		argumentIndex++;
+
+		written = -1;
+		switch (conversion) {
+		case 'd':
+		case 'i':
+			std::memcpy(spec + specLength, "lld", 4);
+			written = snprintf(buffer, sizeof(buffer), spec, static_cast<long long>(AsSigned(type, value)));
+			break;
+		case 'u':
+		case 'x':
+		case 'X':
+		case 'o':
+			spec[specLength] = 'l';
+			spec[specLength + 1] = 'l';
+			spec[specLength + 2] = conversion;
+			spec[specLength + 3] = '\0';
+			{
+				uint64_t bits = static_cast<uint64_t>(AsSigned(type, value));
+				// printf と同じく、int の負数は 32 ビットの符号なしとして表示する
+				if (type == LogRecord::ArgumentType::kSigned && static_cast<int64_t>(bits) < 0 && static_cast<int64_t>(bits) >= INT32_MIN) {
+					bits &= UINT32_MAX;
+				}
+				written = snprintf(buffer, sizeof(buffer), spec, static_cast<unsigned long long>(bits));
+			}
+			break;
+		case 'c':
+			spec[specLength] = 'c';
+			spec[specLength + 1] = '\0';
+			written = snprintf(buffer, sizeof(buffer), spec, static_cast<int>(AsSigned(type, value)));
+			break;
+		case 'f':
+		case 'F':
+		case 'e':
+		case 'E':
+		case 'g':
+		case 'G':
+		case 'a':
+		case 'A':
+			spec[specLength] = conversion;
+			spec[specLength + 1] = '\0';
+			written = snprintf(buffer, sizeof(buffer), spec, AsDouble(type, value));
+			break;
+		case 's':
+			if (type == LogRecord::ArgumentType::kString) {
+				spec[specLength] = 's';
+				spec[specLength + 1] = '\0';
+				written = snprintf(buffer, sizeof(buffer), spec, record.text + value);
+			}
+			break;
+		case 'p':
+			written = snprintf(buffer, sizeof(buffer), "%p", reinterpret_cast<void*>(static_cast<uintptr_t>(value)));
+			break;
+		default:
+			break;
+		}
+		if (written < 0) {
+			out += "<?>";
+		} else {
+			out.append(buffer, static_cast<size_t>(std::min(written, static_cast<int>(sizeof(buffer) - 1))));
+		}
+	}
+
+	if (record.suppressedBefore > 0) {
+		written = snprintf(buffer, sizeof(buffer), " (+%u suppressed)", record.suppressedBefore);
+		out.append(buffer, static_cast<size_t>(std::max(written, 0)));
+	}
+	out += '\n';
+}
+
+void Logger::Flush() {
+	uint64_t target = enqueuePosition_.load(std::memory_order_acquire);
+	while (drainedPosition_.load(std::memory_order_acquire) < target && isRunning_.load(std::memory_order_acquire)) {
+		std::this_thread::sleep_for(kIdleSleep);
+	}
+}
+
+void Logger::DrawImGui() {
+#ifdef USE_IMGUI
+	ImGui::Begin("Logger");
+	ImGui::Text("Written: %llu  Dropped: %llu  Rate-limited: %llu", static_cast<unsigned long long>(GetWrittenCount()),
+	            static_cast<unsigned long long>(GetDroppedCount()), static_cast<unsigned long long>(GetSuppressedCount()));
+	int level = minimumLevel_.load(std::memory_order_relaxed);
+	if (ImGui::Combo("Level", &level, kLevelNames, static_cast<int>(std::size(kLevelNames)))) {
+		SetMinimumLevel(static_cast<LogLevel>(level));
+	}
+	uint32_t mask = categoryMask_.load(std::memory_order_relaxed);
+	for (size_t i = 0; i < std::size(kCategoryNames); ++i) {
+		bool isEnabled = (mask & (1u << i)) != 0;
+		if (ImGui::Checkbox(kCategoryNames[i], &isEnabled)) {
+			SetCategoryEnabled(static_cast<LogCategory>(i), isEnabled);
+		}
+	}
+	ImGui::End();
+#endif
+}
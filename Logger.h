@@ -0,0 +1,284 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define LOGGER_HAS_RDTSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define LOGGER_HAS_RDTSC 1
+#endif
+
+// 非同期ロガー。ログの呼び出し側は引数をそのままレコードに詰めてリングに入れるだけで、
+// 整形と出力はバックグラウンドのスレッドで行う。
+//   LOG_INFO(LogCategory::kScene, "Changing to map %d", mapID);
+//   LOG_DEBUG_RATE(LogCategory::kPlayer, 2, "Wall contact: %.3f", x);  // 呼び出し箇所ごとに 1 秒 2 件まで
+// 書式は printf と同じ（* 指定は不可）。書式文字列は文字列リテラルを渡すこと。文字列の引数はレコードにコピーされる。
+// Trace / Debug は _DEBUG 構成でのみコンパイルされる（それ以外の構成では引数も評価されない）。
+
+enum class LogLevel : uint8_t {
+	kTrace,
+	kDebug,
+	kInfo,
+	kWarning,
+	kError,
+};
+
+enum class LogCategory : uint8_t {
+	kGeneral,
+	kPlayer,
+	kGoal,
+	kScene,
+	kLevel,
+	kSequence,
+	kCount,
+};
+
+// これより下のレベルはコンパイルしない
+#ifdef _DEBUG
+constexpr LogLevel kLogCompiledLevel = LogLevel::kTrace;
+#else
+constexpr LogLevel kLogCompiledLevel = LogLevel::kInfo;
+#endif
+
+#define LOG_AT(level, category, ratePerSecond, ...) \
+	do { \
+		if constexpr ((level) >= kLogCompiledLevel) { \
+			static LogSite logSite{level, category, ratePerSecond}; \
+			Logger::Write(logSite, __VA_ARGS__); \
+		} \
+	} while (0)
+
+#define LOG_TRACE(category, ...) LOG_AT(LogLevel::kTrace, category, 0, __VA_ARGS__)
+#define LOG_DEBUG(category, ...) LOG_AT(LogLevel::kDebug, category, 0, __VA_ARGS__)
+#define LOG_INFO(category, ...) LOG_AT(LogLevel::kInfo, category, 0, __VA_ARGS__)
+#define LOG_WARNING(category, ...) LOG_AT(LogLevel::kWarning, category, 0, __VA_ARGS__)
+#define LOG_ERROR(category, ...) LOG_AT(LogLevel::kError, category, 0, __VA_ARGS__)
+// 毎フレーム通るような箇所用（超えた分は捨てて、次に出たときに件数を添える）
+#define LOG_TRACE_RATE(category, perSecond, ...) LOG_AT(LogLevel::kTrace, category, perSecond, __VA_ARGS__)
+#define LOG_DEBUG_RATE(category, perSecond, ...) LOG_AT(LogLevel::kDebug, category, perSecond, __VA_ARGS__)
+
+// ログの呼び出し箇所ごとの静的な情報とレート制限の状態
+struct LogSite {
+	constexpr LogSite(LogLevel siteLevel, LogCategory siteCategory, uint32_t siteRatePerSecond)
+	    : level(siteLevel), category(siteCategory), ratePerSecond(siteRatePerSecond) {}
+
+	const LogLevel level;
+	const LogCategory category;
+	const uint32_t ratePerSecond; // 0 なら無制限
+	std::atomic<uint32_t> window{0};
+	std::atomic<uint32_t> count{0};
+	std::atomic<uint32_t> suppressed{0};
+};
+
+// リングに入れる 1 件分。引数は型タグ付きの 8 バイト値、文字列は text にコピーする
+struct LogRecord {
+	static constexpr size_t kMaxArguments = 8;
+	static constexpr size_t kTextCapacity = 144;
+
+	enum class ArgumentType : uint8_t {
+		kSigned,
+		kUnsigned,
+		kDouble,
+		kString, // value は text 内のオフセット
+		kPointer,
+	};
+
+	uint64_t timestamp = 0;
+	const char* format = nullptr;
+	uint32_t suppressedBefore = 0; // この前にレート制限で捨てた件数
+	uint16_t threadID = 0;
+	LogLevel level = LogLevel::kInfo;
+	LogCategory category = LogCategory::kGeneral;
+	uint8_t argumentCount = 0;
+	uint8_t textUsed = 0;
+	ArgumentType types[kMaxArguments] = {};
+	uint64_t values[kMaxArguments] = {};
+	char text[kTextCapacity] = {};
+};
+
+namespace LoggerDetail {
+	// ログを書くたびに関数呼び出しをしないようにヘッダーに置く
+	inline thread_local uint16_t threadID = UINT16_MAX;
+}
+
+class Logger {
+public:
+	// 1 件 256 バイト。書き込み先が L2 に収まる程度の大きさにする
+	static constexpr uint32_t kCapacity = 1u << 10;
+
+	Logger(const Logger&) = delete;
+	Logger& operator=(const Logger&) = delete;
+
+	~Logger();
+
+	// 最初の呼び出しでバックグラウンドスレッドを起動する。それまでのログは捨てられる
+	static Logger& GetInstance();
+	// 残っているログを出力してから終了する
+	static void Destroy();
+
+	template <typename... Args>
+	static void Write(LogSite& site, const char* format, const Args&... args);
+
+	static bool IsEnabled(LogLevel level, LogCategory category) {
+		Logger* logger = instance_.get();
+		return logger && static_cast<uint8_t>(level) >= logger->minimumLevel_.load(std::memory_order_relaxed) &&
+		       (logger->categoryMask_.load(std::memory_order_relaxed) & (1u << static_cast<uint32_t>(category))) != 0;
+	}
+
+	void SetMinimumLevel(LogLevel level) { minimumLevel_.store(static_cast<uint8_t>(level), std::memory_order_relaxed); }
+	void SetCategoryEnabled(LogCategory category, bool isEnabled);
+
+	// リングが一杯で捨てた件数 / レート制限で捨てた件数 / 出力した件数
+	uint64_t GetDroppedCount() const { return droppedCount_.load(std::memory_order_relaxed); }
+	uint64_t GetSuppressedCount() const { return suppressedCount_.load(std::memory_order_relaxed); }
+	uint64_t GetWrittenCount() const { return writtenCount_.load(std::memory_order_relaxed); }
+
+	// バックグラウンドスレッドが追いつくまで待つ（テストや終了前用）
+	void Flush();
+
+	void DrawImGui();
+
+	// 呼び出し元スレッドの番号（ログの表示用）
+	static uint16_t GetThreadID() {
+		if (LoggerDetail::threadID == UINT16_MAX) {
+			LoggerDetail::threadID = AssignThreadID();
+		}
+		return LoggerDetail::threadID;
+	}
+
+private:
+	struct alignas(64) Cell {
+		std::atomic<uint64_t> sequence{0};
+		LogRecord record;
+	};
+	static_assert(sizeof(Cell) == 256, "Logger: cell should fill whole cache lines");
+
+	Logger();
+	static uint16_t AssignThreadID();
+
+	static uint64_t Now() {
+#ifdef LOGGER_HAS_RDTSC
+		return __rdtsc();
+#else
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+	}
+
+	// 空きセルを確保する（一杯なら nullptr）。書き終えたら Publish する
+	Cell* Claim(uint64_t& position);
+	static void Publish(Cell* cell, uint64_t position) { cell->sequence.store(position + 1, std::memory_order_release); }
+
+	// レート制限。通してよければ true（suppressedBefore にそれまで捨てた件数を入れる）
+	bool Admit(LogSite& site, uint32_t& suppressedBefore);
+
+	void Run();
+	// 溜まっているレコードを整形して出力する。出力した件数を返す
+	size_t Drain(std::string& output);
+	void FormatRecord(const LogRecord& record, std::string& out) const;
+
+	template <typename T>
+	static void StoreArgument(LogRecord& record, const T& value);
+	// text にコピーしてオフセットを返す（入りきらない分は切り詰める）
+	static uint64_t StoreString(LogRecord& record, std::string_view text);
+
+	static std::unique_ptr<Logger> instance_;
+
+	std::unique_ptr<Cell[]> cells_;
+	std::atomic<uint64_t> enqueuePosition_{0};
+	uint64_t dequeuePosition_ = 0; // バックグラウンドスレッドのみ
+	std::atomic<uint64_t> drainedPosition_{0}; // 出力まで済んだ位置（Flush 用）
+
+	std::atomic<uint8_t> minimumLevel_{0};
+	std::atomic<uint32_t> categoryMask_{~0u};
+	// レート制限の 1 秒単位の時刻（バックグラウンドスレッドが進める）
+	std::atomic<uint32_t> currentWindow_{1};
+
+	std::atomic<uint64_t> droppedCount_{0};
+	std::atomic<uint64_t> suppressedCount_{0};
+	std::atomic<uint64_t> writtenCount_{0};
+
+	// タイムスタンプ -> 秒の換算
+	uint64_t originTicks_ = 0;
+	std::chrono::steady_clock::time_point originTime_;
+	double ticksPerSecond_ = 1.0e9;
+
+	std::atomic<bool> isRunning_{true};
+	std::thread worker_;
+};
+
+template <typename T>
+void Logger::StoreArgument(LogRecord& record, const T& value) {
+	using Type = std::decay_t<T>;
+	LogRecord::ArgumentType& type = record.types[record.argumentCount];
+	uint64_t& slot = record.values[record.argumentCount];
+	record.argumentCount++;
+
+	if constexpr (std::is_same_v<Type, bool>) {
+		type = LogRecord::ArgumentType::kSigned;
+		slot = value ? 1 : 0;
+	} else if constexpr (std::is_enum_v<Type>) {
+		type = LogRecord::ArgumentType::kSigned;
+		slot = static_cast<uint64_t>(static_cast<int64_t>(value));
+	} else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>) {
+		type = LogRecord::ArgumentType::kSigned;
+		slot = static_cast<uint64_t>(static_cast<int64_t>(value));
+	} else if constexpr (std::is_integral_v<Type>) {
+		type = LogRecord::ArgumentType::kUnsigned;
+		slot = static_cast<uint64_t>(value);
+	} else if constexpr (std::is_floating_point_v<Type>) {
+		type = LogRecord::ArgumentType::kDouble;
+		double number = static_cast<double>(value);
+		std::memcpy(&slot, &number, sizeof(number));
+	} else if constexpr (std::is_same_v<Type, const char*> || std::is_same_v<Type, char*>) {
+		type = LogRecord::ArgumentType::kString;
+		slot = StoreString(record, value ? std::string_view(value) : std::string_view("(null)"));
+	} else if constexpr (std::is_same_v<Type, std::string> || std::is_same_v<Type, std::string_view>) {
+		type = LogRecord::ArgumentType::kString;
+		slot = StoreString(record, value);
+	} else if constexpr (std::is_pointer_v<Type>) {
+		type = LogRecord::ArgumentType::kPointer;
+		slot = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(value));
+	} else {
+		static_assert(std::is_pointer_v<Type>, "Logger: unsupported argument type");
+	}
+}
+
+template <typename... Args>
+void Logger::Write(LogSite& site, const char* format, const Args&... args) {
+	static_assert(sizeof...(Args) <= LogRecord::kMaxArguments, "Logger: too many arguments");
+	if (!IsEnabled(site.level, site.category)) {
+		return;
+	}
+	Logger* logger = instance_.get();
+	uint32_t suppressedBefore = 0;
+	if (site.ratePerSecond > 0 && !logger->Admit(site, suppressedBefore)) {
+		return;
+	}
+
+	uint64_t position = 0;
+	Cell* cell = logger->Claim(position);
+	if (!cell) {
+		logger->droppedCount_.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	LogRecord& record = cell->record;
+	record.timestamp = Now();
+	record.format = format;
+	record.suppressedBefore = suppressedBefore;
+	record.threadID = GetThreadID();
+	record.level = site.level;
+	record.category = site.category;
+	record.argumentCount = 0;
+	record.textUsed = 0;
+	(StoreArgument(record, args), ...);
+	Publish(cell, position);
+}
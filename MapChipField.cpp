@@ -1,15 +1,21 @@
 #include "MapChipField.h"
+#include "Profiler.h"
 #include <map>
 #include <string>
 #include <fstream>
 #include <sstream>
 #include <cassert>
+#include <cmath>
+#include <algorithm>
 namespace {
-    std::map<std::string, MapChipType> mapChipTable = {
+    const std::map<std::string, MapChipType> mapChipTable = {
         {"-1", MapChipType::kBlank},
         {"0", MapChipType::kBlock},
 		{"1", MapChipType::kSpawn},
 		{"2",  MapChipType::kGoal },
+		{"3", MapChipType::kAgentPatrol},
+		{"4", MapChipType::kAgentFalling},
+		{"5", MapChipType::kAgentChaser},
     };
 }
     MapChipField::MapChipField() {}
@@ -27,10 +33,13 @@ namespace {
 		}
     }
 
-    void MapChipField::LoadMapChipCsv(const std::string& filePath) {  
+    bool MapChipField::LoadMapChipCsv(const std::string& filePath) {  
+		PROFILE_FUNCTION();
 		std::ifstream file;
 	    file.open(filePath);
-		assert(file.is_open());
+		if (!file.is_open()) {
+			return false;
+		}
 
 		std::stringstream mapChipCsvStream;
 		mapChipCsvStream << file.rdbuf();
@@ -80,8 +89,10 @@ namespace {
 				
 				std::string word;
 				while (std::getline(line_stream, word, ',') && currentCol < numBlockHorizontal_) {
-					if (mapChipTable.contains(word)) {
-						mapChipData_.data_[currentRow][currentCol] = mapChipTable[word];
+					// find() 只读访问，后台线程加载时也是安全的
+					auto it = mapChipTable.find(word);
+					if (it != mapChipTable.end()) {
+						mapChipData_.data_[currentRow][currentCol] = it->second;
 					} else {
 						mapChipData_.data_[currentRow][currentCol] = MapChipType::kBlank;
 					}
@@ -97,9 +108,10 @@ namespace {
 				currentRow++;
 			}
 		}
+		return true;
     }
 
-    MapChipType MapChipField::GetMapChipTypeByIndex(uint32_t xIndex, uint32_t yIndex) { 
+    MapChipType MapChipField::GetMapChipTypeByIndex(uint32_t xIndex, uint32_t yIndex) const { 
         if (xIndex < 0 || numBlockHorizontal_ - 1 < xIndex) {
 		    return MapChipType::kBlank;
 	    }
@@ -110,12 +122,19 @@ namespace {
         return mapChipData_.data_[yIndex][xIndex];
     }
 
-    Vector3 MapChipField::GetMapChipPositionByIndex(uint32_t xIndex, uint32_t yIndex) { 
+    void MapChipField::SetMapChipTypeByIndex(uint32_t xIndex, uint32_t yIndex, MapChipType type) {
+        if (!IsIndexInMapBounds(xIndex, yIndex)) {
+            return;
+        }
+        mapChipData_.data_[yIndex][xIndex] = type;
+    }
+
+    Vector3 MapChipField::GetMapChipPositionByIndex(uint32_t xIndex, uint32_t yIndex) const { 
         
         return Vector3(xIndex * kBlockWidth + kBlockWidth / 2, kBlockHeight * (numBlockVertical_ - 1 - yIndex) + kBlockHeight / 2, 0.0f); 
 	}
 
-    IndexSet MapChipField::GetMapChipIndexByPosition(const Vector3& position) { 
+    IndexSet MapChipField::GetMapChipIndexByPosition(const Vector3& position) const { 
 		IndexSet indexSet = {};
 	    indexSet.xIndex = static_cast<uint32_t>((floor)(position.x / kBlockWidth));
 	    indexSet.yIndex = static_cast<uint32_t>(numBlockVertical_ - 1 - (floor)(position.y / kBlockHeight));
@@ -123,7 +142,7 @@ namespace {
 		return indexSet; 
 	}
 
-    MapChipField::Rect MapChipField::GetRectByIndex(uint32_t xIndex, uint32_t yIndex) { 
+    MapChipField::Rect MapChipField::GetRectByIndex(uint32_t xIndex, uint32_t yIndex) const { 
 		Vector3 center = GetMapChipPositionByIndex(xIndex, yIndex);
 		
 		Rect rect;
@@ -134,7 +153,7 @@ namespace {
 	    return rect;
     }
 
-    MapChipField::Rect MapChipField::GetScaledRectByIndex(uint32_t xIndex, uint32_t yIndex, float scale) { 
+    MapChipField::Rect MapChipField::GetScaledRectByIndex(uint32_t xIndex, uint32_t yIndex, float scale) const { 
 		Vector3 center = GetMapChipPositionByIndex(xIndex, yIndex);
 		
 		float scaledWidth = kBlockWidth * scale;
@@ -149,7 +168,8 @@ namespace {
     }
 
     // 碰撞检测方法实现
-    bool MapChipField::CheckCollision(const Rect& playerRect) {
+    bool MapChipField::CheckCollision(const Rect& playerRect) const {
+        PROFILE_FUNCTION();
         // 获取玩家矩形覆盖的地图瓦片范围
         int leftIndex = static_cast<int>(playerRect.left / kBlockWidth);
         int rightIndex = static_cast<int>(playerRect.right / kBlockWidth);
@@ -176,7 +196,8 @@ namespace {
         return false;
     }
 
-    bool MapChipField::CheckScaledCollision(const Rect& playerRect, float blockScale) {
+    bool MapChipField::CheckScaledCollision(const Rect& playerRect, float blockScale) const {
+        PROFILE_FUNCTION();
         // 获取玩家矩形覆盖的地图瓦片范围
         int leftIndex = static_cast<int>(playerRect.left / kBlockWidth);
         int rightIndex = static_cast<int>(playerRect.right / kBlockWidth);
@@ -203,29 +224,54 @@ namespace {
         return false;
     }
 
-    bool MapChipField::CheckCollisionAtPosition(const Vector3& position, const Vector3& size) {
+    bool MapChipField::CheckCollisionAtPosition(const Vector3& position, const Vector3& size) const {
         Rect playerRect = GetPlayerRect(position, size);
         return CheckCollision(playerRect);
     }
 
-    bool MapChipField::CheckScaledCollisionAtPosition(const Vector3& position, const Vector3& size, float blockScale) {
+    bool MapChipField::CheckScaledCollisionAtPosition(const Vector3& position, const Vector3& size, float blockScale) const {
         Rect playerRect = GetPlayerRect(position, size);
         return CheckScaledCollision(playerRect, blockScale);
     }
 
-    bool MapChipField::IsBlockAtIndex(uint32_t xIndex, uint32_t yIndex) {
+    bool MapChipField::IsBlockAtIndex(uint32_t xIndex, uint32_t yIndex) const {
         MapChipType chipType = GetMapChipTypeByIndex(xIndex, yIndex);
         return chipType == MapChipType::kBlock;
     }
 
-    bool MapChipField::RectIntersectsRect(const Rect& rect1, const Rect& rect2) {
+    void MapChipField::IsBlockAtIndices(const uint32_t* xIndices, const uint32_t* yIndices, uint8_t* results, size_t count) const {
+        PROFILE_FUNCTION();
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t x = xIndices[i];
+            uint32_t y = yIndices[i];
+            results[i] = x < numBlockHorizontal_ && y < numBlockVertical_ && mapChipData_.data_[y][x] == MapChipType::kBlock ? 1 : 0;
+        }
+    }
+
+    void MapChipField::GetBlockRowBits(uint32_t yIndex, uint64_t* words) const {
+        if (yIndex >= numBlockVertical_) {
+            return;
+        }
+        const std::vector<MapChipType>& row = mapChipData_.data_[yIndex];
+        for (uint32_t begin = 0; begin < numBlockHorizontal_; begin += 64) {
+            // 每 64 块在局部变量中拼好再写入
+            uint32_t count = std::min(64u, numBlockHorizontal_ - begin);
+            uint64_t bits = 0;
+            for (uint32_t i = 0; i < count; ++i) {
+                bits |= static_cast<uint64_t>(row[begin + i] == MapChipType::kBlock) << i;
+            }
+            words[begin >> 6] |= bits;
+        }
+    }
+
+    bool MapChipField::RectIntersectsRect(const Rect& rect1, const Rect& rect2) const {
         return !(rect1.right <= rect2.left || 
                  rect1.left >= rect2.right || 
                  rect1.top <= rect2.bottom || 
                  rect1.bottom >= rect2.top);
     }
 
-    MapChipField::Rect MapChipField::GetPlayerRect(const Vector3& position, const Vector3& size) {
+    MapChipField::Rect MapChipField::GetPlayerRect(const Vector3& position, const Vector3& size) const {
         Rect rect;
         rect.left = position.x - size.x / 2.0f;
         rect.right = position.x + size.x / 2.0f;
@@ -235,7 +281,8 @@ namespace {
     }
 
     // 获取与玩家碰撞的所有方块索引
-    std::vector<IndexSet> MapChipField::GetCollidingBlocks(const Vector3& position, const Vector3& size) {
+    std::vector<IndexSet> MapChipField::GetCollidingBlocks(const Vector3& position, const Vector3& size) const {
+        PROFILE_FUNCTION();
         std::vector<IndexSet> collidingBlocks;
         Rect playerRect = GetPlayerRect(position, size);
         
@@ -265,7 +312,8 @@ namespace {
         return collidingBlocks;
     }
 
-    std::vector<IndexSet> MapChipField::GetScaledCollidingBlocks(const Vector3& position, const Vector3& size, float blockScale) {
+    std::vector<IndexSet> MapChipField::GetScaledCollidingBlocks(const Vector3& position, const Vector3& size, float blockScale) const {
+        PROFILE_FUNCTION();
         std::vector<IndexSet> collidingBlocks;
         Rect playerRect = GetPlayerRect(position, size);
         
@@ -295,12 +343,41 @@ namespace {
         return collidingBlocks;
     }
 
-    bool MapChipField::IsPositionInMapBounds(const Vector3& position) {
+    bool MapChipField::IsPositionInMapBounds(const Vector3& position) const {
         return position.x >= 0.0f && position.x < (numBlockHorizontal_ * kBlockWidth) &&
                position.y >= 0.0f && position.y < (numBlockVertical_ * kBlockHeight);
     }
 
-    bool MapChipField::IsIndexInMapBounds(uint32_t xIndex, uint32_t yIndex) {
+    bool MapChipField::IsIndexInMapBounds(uint32_t xIndex, uint32_t yIndex) const {
         return xIndex < numBlockHorizontal_ && yIndex < numBlockVertical_;
     }
 
+    TileRange MapChipField::GetTileRangeByRect(const Rect& rect, uint32_t margin) const {
+        PROFILE_FUNCTION();
+        TileRange range;
+        if (numBlockHorizontal_ == 0 || numBlockVertical_ == 0) {
+            return range;
+        }
+
+        // 世界坐标 -> 瓦片索引（y 轴方向相反，索引 0 为最上方）
+        float mapTop = numBlockVertical_ * kBlockHeight;
+        int left = static_cast<int>(std::floor(rect.left / kBlockWidth)) - static_cast<int>(margin);
+        int right = static_cast<int>(std::floor(rect.right / kBlockWidth)) + static_cast<int>(margin);
+        int top = static_cast<int>(std::floor((mapTop - rect.top) / kBlockHeight)) - static_cast<int>(margin);
+        int bottom = static_cast<int>(std::floor((mapTop - rect.bottom) / kBlockHeight)) + static_cast<int>(margin);
+
+        left = std::max(0, left);
+        top = std::max(0, top);
+        right = std::min(static_cast<int>(numBlockHorizontal_) - 1, right);
+        bottom = std::min(static_cast<int>(numBlockVertical_) - 1, bottom);
+
+        if (left > right || top > bottom) {
+            return range;
+        }
+
+        range.xBegin = static_cast<uint32_t>(left);
+        range.xEnd = static_cast<uint32_t>(right + 1);
+        range.yBegin = static_cast<uint32_t>(top);
+        range.yEnd = static_cast<uint32_t>(bottom + 1);
+        return range;
+    }
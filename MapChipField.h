@@ -10,6 +10,9 @@ enum class MapChipType {
 	kBlock, // ブロック
 	kSpawn, // スポーン地点
 	kGoal,  // ゴール地点
+	kAgentPatrol,  // 往復する敵（AgentSystem）
+	kAgentFalling, // 落ちてくるブロック
+	kAgentChaser,  // 追いかけてくる敵
 };  
 
 struct MapChipData {  
@@ -21,6 +24,16 @@ struct IndexSet {
 	uint32_t yIndex;
 };
 
+// 瓦片索引范围 [xBegin, xEnd) x [yBegin, yEnd)
+struct TileRange {
+	uint32_t xBegin = 0;
+	uint32_t xEnd = 0;
+	uint32_t yBegin = 0;
+	uint32_t yEnd = 0;
+
+	uint32_t GetTileCount() const { return (xEnd - xBegin) * (yEnd - yBegin); }
+};
+
 class MapChipField {  
 public:  
 	struct Rect {
@@ -32,37 +45,53 @@ public:
 	
 	MapChipField();  
 	~MapChipField();  
+	// 发布快照时移动数据（见 MapSnapshot.h）
+	MapChipField(const MapChipField&) = default;
+	MapChipField(MapChipField&&) = default;
+	MapChipField& operator=(const MapChipField&) = default;
+	MapChipField& operator=(MapChipField&&) = default;
 	void Update();  
 	void Draw();  
 
 	void ResetMapChipData();  
-	void LoadMapChipCsv(const std::string& filePath);  
+	// 读取失败（文件不存在等）时返回 false，数据保持为空
+	bool LoadMapChipCsv(const std::string& filePath);  
 
-	MapChipType GetMapChipTypeByIndex(uint32_t xIndex, uint32_t yIndex);  
+	MapChipType GetMapChipTypeByIndex(uint32_t xIndex, uint32_t yIndex) const;  
+	// 范围外则什么都不做（只用于发布前的新快照，见 MapSnapshot.h）
+	void SetMapChipTypeByIndex(uint32_t xIndex, uint32_t yIndex, MapChipType type);
 
 	// マップチップの位置を取得
-	Vector3 GetMapChipPositionByIndex(uint32_t xIndex, uint32_t yIndex);
-	IndexSet GetMapChipIndexByPosition(const Vector3& position);
+	Vector3 GetMapChipPositionByIndex(uint32_t xIndex, uint32_t yIndex) const;
+	IndexSet GetMapChipIndexByPosition(const Vector3& position) const;
 
-	Rect GetRectByIndex(uint32_t xIndex, uint32_t yIndex);
-	Rect GetScaledRectByIndex(uint32_t xIndex, uint32_t yIndex, float scale);
+	Rect GetRectByIndex(uint32_t xIndex, uint32_t yIndex) const;
+	Rect GetScaledRectByIndex(uint32_t xIndex, uint32_t yIndex, float scale) const;
 
 	// 碰撞检测相关方法
-	bool CheckCollision(const Rect& playerRect);
-	bool CheckCollisionAtPosition(const Vector3& position, const Vector3& size);
-	bool IsBlockAtIndex(uint32_t xIndex, uint32_t yIndex);
-	bool RectIntersectsRect(const Rect& rect1, const Rect& rect2);
-	Rect GetPlayerRect(const Vector3& position, const Vector3& size);
+	bool CheckCollision(const Rect& playerRect) const;
+	bool CheckCollisionAtPosition(const Vector3& position, const Vector3& size) const;
+	bool IsBlockAtIndex(uint32_t xIndex, uint32_t yIndex) const;
+	// 批量查询：results[i] = (xIndices[i], yIndices[i]) 是否为方块（范围外为 0）
+	void IsBlockAtIndices(const uint32_t* xIndices, const uint32_t* yIndices, uint8_t* results, size_t count) const;
+	// 把第 yIndex 行的方块按位写入 words（第 x 块 = words[x / 64] 的第 x % 64 位）。只设置方块的位，调用方先清零
+	void GetBlockRowBits(uint32_t yIndex, uint64_t* words) const;
+	bool RectIntersectsRect(const Rect& rect1, const Rect& rect2) const;
+	Rect GetPlayerRect(const Vector3& position, const Vector3& size) const;
 	
 	// 新的缩放碰撞检测方法
-	bool CheckScaledCollision(const Rect& playerRect, float blockScale);
-	bool CheckScaledCollisionAtPosition(const Vector3& position, const Vector3& size, float blockScale);
-	std::vector<IndexSet> GetScaledCollidingBlocks(const Vector3& position, const Vector3& size, float blockScale);
+	bool CheckScaledCollision(const Rect& playerRect, float blockScale) const;
+	bool CheckScaledCollisionAtPosition(const Vector3& position, const Vector3& size, float blockScale) const;
+	std::vector<IndexSet> GetScaledCollidingBlocks(const Vector3& position, const Vector3& size, float blockScale) const;
 	
 	// 获取碰撞信息的额外方法
-	std::vector<IndexSet> GetCollidingBlocks(const Vector3& position, const Vector3& size);
-	bool IsPositionInMapBounds(const Vector3& position);
-	bool IsIndexInMapBounds(uint32_t xIndex, uint32_t yIndex);
+	std::vector<IndexSet> GetCollidingBlocks(const Vector3& position, const Vector3& size) const;
+	bool IsPositionInMapBounds(const Vector3& position) const;
+	bool IsIndexInMapBounds(uint32_t xIndex, uint32_t yIndex) const;
+
+	// 与矩形重叠的瓦片范围（已裁剪到地图内），margin 为额外扩展的瓦片数
+	TileRange GetTileRangeByRect(const Rect& rect, uint32_t margin = 0) const;
+	TileRange GetFullTileRange() const { return {0, numBlockHorizontal_, 0, numBlockVertical_}; }
 
 	uint32_t GetNumBlockHorizontal() const { return numBlockHorizontal_; }
 	uint32_t GetNumBlockVertical() const { return numBlockVertical_; }
@@ -0,0 +1,177 @@
+#include "MapHotReload.h"
+#include "LevelRegistry.h"
+#include "Logger.h"
+#include "Profiler.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+namespace {
+	// 通知が無い環境での確認間隔
+	constexpr std::chrono::milliseconds kPollInterval(16);
+	// 通知の後、書き込みが終わるまで待つ時間（保存途中のファイルを読まないように）
+	constexpr std::chrono::milliseconds kSettleTime(5);
+
+	int64_t GetTimestamp() {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	// ファイルの更新時刻（読めなければ 0）
+	int64_t GetWriteTime(const std::string& path) {
+		std::error_code error;
+		std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(path, error);
+		return error ? 0 : static_cast<int64_t>(writeTime.time_since_epoch().count());
+	}
+
+	// ファイルの内容の FNV-1a（読めなければ 0）
+	uint64_t GetFileChecksum(const std::string& path) {
+		std::ifstream file(path, std::ios::binary);
+		if (!file.is_open()) {
+			return 0;
+		}
+		std::stringstream content;
+		content << file.rdbuf();
+		return LevelRegistry::ComputeChecksum(content.str());
+	}
+}
+
+bool DiffMapChipFields(const MapChipField& before, const MapChipField& after, std::vector<MapTileChange>& changes) {
+	changes.clear();
+	if (before.GetNumBlockHorizontal() != after.GetNumBlockHorizontal() || before.GetNumBlockVertical() != after.GetNumBlockVertical()) {
+		return false;
+	}
+	for (uint32_t y = 0; y < after.GetNumBlockVertical(); ++y) {
+		for (uint32_t x = 0; x < after.GetNumBlockHorizontal(); ++x) {
+			MapChipType beforeType = before.GetMapChipTypeByIndex(x, y);
+			MapChipType afterType = after.GetMapChipTypeByIndex(x, y);
+			if (beforeType != afterType) {
+				changes.push_back({x, y, beforeType, afterType});
+			}
+		}
+	}
+	return true;
+}
+
+MapHotReloader::~MapHotReloader() { Stop(); }
+
+void MapHotReloader::Start(const std::string& path, MapSnapshotStore& store, uint64_t checksum) {
+	Stop();
+	path_ = path;
+	store_ = &store;
+	lastWriteTime_ = GetWriteTime(path_);
+	lastChecksum_ = checksum;
+	isStopRequested_.store(false, std::memory_order_relaxed);
+
+#ifdef _WIN32
+	std::filesystem::path directory = std::filesystem::path(path_).parent_path();
+	stopEvent_ = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+	HANDLE changeHandle = FindFirstChangeNotificationW(directory.wstring().c_str(), FALSE, FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME);
+	// 通知が使えなければポーリングにする
+	changeHandle_ = changeHandle != INVALID_HANDLE_VALUE ? changeHandle : nullptr;
+#endif
+
+	thread_ = std::thread(&MapHotReloader::ThreadMain, this);
+	LOG_DEBUG(LogCategory::kLevel, "MapHotReloader: Watching %s (%s)", path_.c_str(), changeHandle_ ? "change notification" : "polling");
+}
+
+void MapHotReloader::Stop() {
+	if (!thread_.joinable()) {
+		return;
+	}
+	isStopRequested_.store(true, std::memory_order_release);
+#ifdef _WIN32
+	SetEvent(stopEvent_);
+#endif
+	thread_.join();
+#ifdef _WIN32
+	if (changeHandle_) {
+		FindCloseChangeNotification(changeHandle_);
+		changeHandle_ = nullptr;
+	}
+	CloseHandle(stopEvent_);
+	stopEvent_ = nullptr;
+#endif
+}
+
+std::unique_ptr<MapReload> MapHotReloader::TakeReload() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return std::move(pending_);
+}
+
+void MapHotReloader::ThreadMain() {
+	while (WaitForChange()) {
+		// 同じディレクトリの別のファイルの変更でも起きるので、更新時刻で確かめる
+		int64_t writeTime = GetWriteTime(path_);
+		if (writeTime == 0 || writeTime == lastWriteTime_) {
+			continue;
+		}
+		int64_t detectedTimestamp = GetTimestamp();
+		std::this_thread::sleep_for(kSettleTime);
+		lastWriteTime_ = GetWriteTime(path_);
+		// 保存し直しただけなど、内容が変わっていなければ読み直さない
+		const uint64_t checksum = GetFileChecksum(path_);
+		if (checksum != 0 && checksum == lastChecksum_) {
+			unchangedCount_.fetch_add(1, std::memory_order_relaxed);
+			LOG_DEBUG(LogCategory::kLevel, "MapHotReloader: %s touched but unchanged", path_.c_str());
+			continue;
+		}
+		if (Reload(detectedTimestamp)) {
+			lastChecksum_ = checksum;
+		}
+	}
+}
+
+bool MapHotReloader::WaitForChange() {
+#ifdef _WIN32
+	if (changeHandle_) {
+		HANDLE handles[] = {changeHandle_, stopEvent_};
+		DWORD result = WaitForMultipleObjects(2, handles, FALSE, INFINITE);
+		if (result != WAIT_OBJECT_0) {
+			return false;
+		}
+		FindNextChangeNotification(changeHandle_);
+		return !isStopRequested_.load(std::memory_order_acquire);
+	}
+#endif
+	std::this_thread::sleep_for(kPollInterval);
+	return !isStopRequested_.load(std::memory_order_acquire);
+}
+
+bool MapHotReloader::Reload(int64_t detectedTimestamp) {
+	PROFILE_FUNCTION();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::unique_ptr<MapReload> reload = std::make_unique<MapReload>();
+	reload->path = path_;
+	reload->detectedTimestamp = detectedTimestamp;
+	reload->field = std::make_unique<MapChipField>();
+	if (!reload->field->LoadMapChipCsv(path_) || reload->field->GetNumBlockVertical() == 0) {
+		// 保存の途中などで読めなかった。次の変更で読み直す
+		LOG_WARNING(LogCategory::kLevel, "MapHotReloader: Failed to parse %s", path_.c_str());
+		return false;
+	}
+
+	// 公開中のマップとの差分（更新スレッドを止めずに読む）
+	{
+		MapReadGuard guard(*store_);
+		if (guard) {
+			reload->baseEpoch = guard->epoch;
+			reload->isResized = !DiffMapChipFields(guard->field, *reload->field, reload->changes);
+		} else {
+			// 比べるものが無いので全部作り直してもらう
+			reload->isResized = true;
+		}
+	}
+	std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	reload->parseMilliseconds = elapsed.count();
+
+	LOG_INFO(LogCategory::kLevel, "MapHotReloader: %s changed, %zu tiles%s (%.2f ms)", path_.c_str(), reload->changes.size(),
+	         reload->isResized ? ", resized" : "", reload->parseMilliseconds);
+	std::lock_guard<std::mutex> lock(mutex_);
+	pending_ = std::move(reload);
+	reloadCount_.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include "MapChipField.h"
+#include "MapSnapshot.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 変わったマップチップ 1 つ
+struct MapTileChange {
+	uint32_t xIndex = 0;
+	uint32_t yIndex = 0;
+	MapChipType before = MapChipType::kBlank;
+	MapChipType after = MapChipType::kBlank;
+};
+
+// before と after の差分。サイズが違えば false（タイル単位の差分にならない）
+bool DiffMapChipFields(const MapChipField& before, const MapChipField& after, std::vector<MapTileChange>& changes);
+
+// 読み直したマップと、その時点で公開中だったマップとの差分
+struct MapReload {
+	std::string path;
+	std::unique_ptr<MapChipField> field;
+	std::vector<MapTileChange> changes;
+	uint64_t baseEpoch = 0;   // 差分の基準にしたマップのエポック
+	bool isResized = false;   // サイズが変わった（差分は空）
+	int64_t detectedTimestamp = 0; // 変更に気付いた時刻（steady_clock のナノ秒）
+	float parseMilliseconds = 0.0f;
+};
+
+// マップファイルの変更を監視し、バックグラウンドで読み直して差分を作る（USE_HOT_RELOAD の構成のみ使う）。
+// Windows ではディレクトリの変更通知で起き、それ以外では更新時刻をポーリングする。
+// 更新スレッドは毎 tick TakeReload して、変わったタイルだけを反映する。
+class MapHotReloader {
+public:
+	MapHotReloader() = default;
+	~MapHotReloader();
+
+	MapHotReloader(const MapHotReloader&) = delete;
+	MapHotReloader& operator=(const MapHotReloader&) = delete;
+
+	// path を監視する。差分は store の公開中のマップに対して作る（store は Stop まで生かしておくこと）
+	// checksum は読み込み済みの内容の FNV-1a（LevelEntry::checksum）。更新時刻が変わっても内容が同じなら読み直さない。0 なら常に読み直す
+	void Start(const std::string& path, MapSnapshotStore& store, uint64_t checksum = 0);
+	void Stop();
+
+	// 読み直し済みの変更があれば取り出す（無ければ nullptr）。まだ取り出されていない古い結果は新しい結果で置き換わる
+	std::unique_ptr<MapReload> TakeReload();
+
+	uint32_t GetReloadCount() const { return reloadCount_.load(std::memory_order_relaxed); }
+	uint32_t GetUnchangedCount() const { return unchangedCount_.load(std::memory_order_relaxed); }
+
+private:
+	void ThreadMain();
+	// 変更がありそうなら true、停止するなら false
+	bool WaitForChange();
+	// 読み直せたら true
+	bool Reload(int64_t detectedTimestamp);
+
+	std::string path_;
+	MapSnapshotStore* store_ = nullptr;
+	int64_t lastWriteTime_ = 0;
+	uint64_t lastChecksum_ = 0; // 最後に反映した内容（監視スレッドのみ）
+
+	std::thread thread_;
+	std::atomic<bool> isStopRequested_{false};
+	std::atomic<uint32_t> reloadCount_{0};
+	std::atomic<uint32_t> unchangedCount_{0}; // 更新時刻だけ変わって読み直さなかった回数
+	void* stopEvent_ = nullptr;   // Windows の停止イベント
+	void* changeHandle_ = nullptr; // Windows の変更通知
+
+	std::mutex mutex_;
+	std::unique_ptr<MapReload> pending_;
+};
@@ -0,0 +1,81 @@
+#include "MapSnapshot.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cassert>
+
+namespace {
+	// 枠を探し始める位置（スレッドごとにずらして取り合いを減らす）
+	std::atomic<uint32_t> gNextSlotHint{0};
+	thread_local uint32_t gSlotHint = UINT32_MAX;
+}
+
+MapSnapshotStore::~MapSnapshotStore() {
+	for (std::atomic<uint64_t>& readerEpoch : readerEpochs_) {
+		assert(readerEpoch.load(std::memory_order_relaxed) == 0);
+		(void)readerEpoch;
+	}
+	for (const Retired& retired : retired_) {
+		delete retired.snapshot;
+	}
+	delete current_.load(std::memory_order_relaxed);
+}
+
+const MapSnapshot* MapSnapshotStore::Publish(std::unique_ptr<MapChipField> field) {
+	PROFILE_FUNCTION();
+	MapSnapshot* snapshot = new MapSnapshot{epoch_.load(std::memory_order_relaxed) + 1, std::move(*field)};
+	// 差し替えてからエポックを進める。進んだ後に読み始めたスレッドは必ず新しい方を見る
+	const MapSnapshot* previous = current_.exchange(snapshot, std::memory_order_seq_cst);
+	uint64_t epoch = epoch_.fetch_add(1, std::memory_order_seq_cst) + 1;
+	if (previous) {
+		retired_.push_back({previous, epoch});
+	}
+	Reclaim();
+	return snapshot;
+}
+
+std::unique_ptr<MapChipField> MapSnapshotStore::CloneCurrent() const {
+	const MapSnapshot* snapshot = GetCurrent();
+	return snapshot ? std::make_unique<MapChipField>(snapshot->field) : std::make_unique<MapChipField>();
+}
+
+void MapSnapshotStore::Reclaim() {
+	if (retired_.empty()) {
+		return;
+	}
+	// 読み出し中のスレッドのうち、一番古いエポック
+	uint64_t oldestEpoch = UINT64_MAX;
+	for (const std::atomic<uint64_t>& readerEpoch : readerEpochs_) {
+		uint64_t value = readerEpoch.load(std::memory_order_seq_cst);
+		if (value != 0) {
+			oldestEpoch = std::min(oldestEpoch, value - 1);
+		}
+	}
+	// 外されたエポック以降に読み始めたスレッドしかいなければ、もう誰も見ていない
+	std::erase_if(retired_, [oldestEpoch](const Retired& retired) {
+		if (retired.epoch > oldestEpoch) {
+			return false;
+		}
+		delete retired.snapshot;
+		return true;
+	});
+}
+
+uint32_t MapSnapshotStore::BeginRead(const MapSnapshot*& snapshot) {
+	if (gSlotHint == UINT32_MAX) {
+		gSlotHint = gNextSlotHint.fetch_add(1, std::memory_order_relaxed) % kMaxReaders;
+	}
+	// エポックを書いてからポインタを読む。書き込み側は書かれたエポックより古いマップを解放しない
+	uint64_t value = epoch_.load(std::memory_order_seq_cst) + 1;
+	for (uint32_t i = 0; i < kMaxReaders; ++i) {
+		uint32_t slot = (gSlotHint + i) % kMaxReaders;
+		uint64_t expected = 0;
+		if (readerEpochs_[slot].compare_exchange_strong(expected, value, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+			snapshot = current_.load(std::memory_order_seq_cst);
+			return slot;
+		}
+	}
+	// 枠が足りない（kMaxReaders を増やすこと）
+	assert(false && "MapSnapshotStore: too many concurrent readers");
+	snapshot = nullptr;
+	return UINT32_MAX;
+}
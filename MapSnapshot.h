@@ -0,0 +1,84 @@
+#pragma once
+#include "MapChipField.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// 公開後は変更されないマップ。何スレッドからでも同時に読める
+struct MapSnapshot {
+	uint64_t epoch = 0; // 公開ごとに増える
+	MapChipField field;
+};
+
+// 現在のマップを公開する（RCU）。書き込み 1 スレッド、読み出しは何スレッドでも。
+// 読み出し側はロックも待ちもしない（自分の枠にエポックを書いてポインタを読むだけ）。
+// 書き込み側は新しいマップを作ってから Publish で差し替え、古いものは読んでいるスレッドがいなくなってから解放する。
+//   読み出し: MapReadGuard guard(store); if (guard) { guard->field.IsBlockAtIndex(x, y); }
+//   編集:     auto next = store.CloneCurrent(); next->SetMapChipTypeByIndex(x, y, type); store.Publish(std::move(next));
+class MapSnapshotStore {
+public:
+	// 同時に読み出し中でいられる数（ワーカー数より十分多く）
+	static constexpr uint32_t kMaxReaders = 64;
+
+	MapSnapshotStore() = default;
+	// 読み出し中のスレッドが残っていないこと
+	~MapSnapshotStore();
+
+	MapSnapshotStore(const MapSnapshotStore&) = delete;
+	MapSnapshotStore& operator=(const MapSnapshotStore&) = delete;
+
+	// --- 書き込み側 ---
+	// 差し替えて、新しいマップを返す（書き込み側はガードなしでそのまま使ってよい）
+	const MapSnapshot* Publish(std::unique_ptr<MapChipField> field);
+	// 現在のマップの複製（編集の下書き用）。まだ何も公開していなければ空のマップ
+	std::unique_ptr<MapChipField> CloneCurrent() const;
+	// 書き込み側から見た現在のマップ
+	const MapSnapshot* GetCurrent() const { return current_.load(std::memory_order_acquire); }
+	// 読み終わった古いマップを解放する（Publish でも呼ばれる）
+	void Reclaim();
+
+	uint64_t GetEpoch() const { return epoch_.load(std::memory_order_acquire); }
+	size_t GetRetiredCount() const { return retired_.size(); }
+
+private:
+	friend class MapReadGuard;
+
+	// 読み出しを始める。枠が足りなければ UINT32_MAX
+	uint32_t BeginRead(const MapSnapshot*& snapshot);
+	void EndRead(uint32_t slot) { readerEpochs_[slot].store(0, std::memory_order_release); }
+
+	struct Retired {
+		const MapSnapshot* snapshot;
+		uint64_t epoch; // このエポック以降に読み始めたスレッドは見ていない
+	};
+
+	std::atomic<const MapSnapshot*> current_{nullptr};
+	std::atomic<uint64_t> epoch_{0};
+	// 読み出し中のスレッドが読み始めたエポック + 1（0 は空き）
+	std::atomic<uint64_t> readerEpochs_[kMaxReaders] = {};
+	std::vector<Retired> retired_; // 書き込み側のみ
+};
+
+// スコープの間、読み始めたときのマップを保持する
+class MapReadGuard {
+public:
+	explicit MapReadGuard(MapSnapshotStore& store) : store_(store) { slot_ = store_.BeginRead(snapshot_); }
+	~MapReadGuard() {
+		if (slot_ != UINT32_MAX) {
+			store_.EndRead(slot_);
+		}
+	}
+
+	MapReadGuard(const MapReadGuard&) = delete;
+	MapReadGuard& operator=(const MapReadGuard&) = delete;
+
+	explicit operator bool() const { return snapshot_ != nullptr; }
+	const MapSnapshot* Get() const { return snapshot_; }
+	const MapSnapshot* operator->() const { return snapshot_; }
+
+private:
+	MapSnapshotStore& store_;
+	const MapSnapshot* snapshot_ = nullptr;
+	uint32_t slot_ = UINT32_MAX;
+};
@@ -0,0 +1,30 @@
+#include "ModelInstanceBackend.h"
+
+void ModelInstanceBackend::Submit(const InstanceBatchBuilder& builder) {
+	const std::vector<InstanceData>& instances = builder.GetInstances();
+
+	// 可见实例数增长时才补充常量缓冲
+	while (transformPool_.size() < instances.size()) {
+		std::unique_ptr<WorldTransform> worldTransform = std::make_unique<WorldTransform>();
+		worldTransform->Initialize();
+		transformPool_.push_back(std::move(worldTransform));
+	}
+	while (colorPool_.size() < instances.size()) {
+		std::unique_ptr<ObjectColor> objectColor = std::make_unique<ObjectColor>();
+		objectColor->Initialize();
+		colorPool_.push_back(std::move(objectColor));
+	}
+
+	for (const InstanceBatch& batch : builder.GetBatches()) {
+		for (uint32_t i = 0; i < batch.instanceCount; ++i) {
+			uint32_t instanceIndex = batch.firstInstance + i;
+			WorldTransform& worldTransform = *transformPool_[instanceIndex];
+			worldTransform.matWorld_ = instances[instanceIndex].matWorld;
+			worldTransform.TransferMatrix();
+			ObjectColor& objectColor = *colorPool_[instanceIndex];
+			objectColor.SetColor(instances[instanceIndex].color);
+			objectColor.TransferMatrix();
+			batch.model->Draw(worldTransform, *camera_, &objectColor);
+		}
+	}
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include "KamataEngine.h"
+#include "InstanceBatch.h"
+#include <memory>
+#include <vector>
+
+// KamataEngine 后端。引擎的 Model 还没有实例化绘制接口，
+// 所以这里用一组复用的 WorldTransform 和 ObjectColor（常量缓冲）逐个绘制。
+// InstanceData::color 通过 ObjectColor 乘到材质颜色上（alpha 由 Model 管线的半透明混合处理）。
+// 常量缓冲只在可见实例数增长时创建，不再是每个方块一个。
+class ModelInstanceBackend : public IInstanceRenderBackend {
+public:
+	// camera 在后端的整个生命周期内有效
+	explicit ModelInstanceBackend(const Camera* camera) : camera_(camera) {}
+
+	void Submit(const InstanceBatchBuilder& builder) override;
+
+	uint32_t GetPoolSize() const { return static_cast<uint32_t>(transformPool_.size()); }
+
+private:
+	const Camera* camera_ = nullptr;
+	std::vector<std::unique_ptr<WorldTransform>> transformPool_;
+	std::vector<std::unique_ptr<ObjectColor>> colorPool_;
+};
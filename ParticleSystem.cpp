@@ -0,0 +1,254 @@
+#include "ParticleSystem.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define PARTICLE_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace {
+	// タイルに当たったときの横（床なら滑る方向）の減速
+	constexpr float kTileFriction = 0.6f;
+	// これより遅い横の速度は 0 にする（減速を続けると非正規化数になり、SIMD の積算が極端に遅くなる）
+	constexpr float kRestSpeed = 0.05f;
+
+	// ワールド座標 -> タイル番号（マップの外は UINT32_MAX、IsBlockAtIndices ではブロック無し扱い）
+	uint32_t ToTileX(float x) {
+		float index = std::floor(x / MapChipField::kBlockWidth);
+		return index >= 0.0f ? static_cast<uint32_t>(index) : UINT32_MAX;
+	}
+	uint32_t ToTileY(float y, uint32_t numBlockVertical) {
+		float row = std::floor(y / MapChipField::kBlockHeight);
+		if (row < 0.0f || row >= static_cast<float>(numBlockVertical)) {
+			return UINT32_MAX;
+		}
+		return numBlockVertical - 1 - static_cast<uint32_t>(row);
+	}
+}
+
+void ParticleSystem::Initialize(uint32_t capacity) {
+	// SIMD のループは 4 つ単位で末尾まで読むので、その分も確保しておく
+	const size_t paddedCapacity = (static_cast<size_t>(capacity) + 3) & ~static_cast<size_t>(3);
+	capacity_ = capacity;
+	positionX_.assign(paddedCapacity, 0.0f);
+	positionY_.assign(paddedCapacity, 0.0f);
+	velocityX_.assign(paddedCapacity, 0.0f);
+	velocityY_.assign(paddedCapacity, 0.0f);
+	gravity_.assign(paddedCapacity, 0.0f);
+	life_.assign(paddedCapacity, 0.0f);
+	inverseLifetime_.assign(paddedCapacity, 0.0f);
+	size_.assign(paddedCapacity, 0.0f);
+	restitution_.assign(paddedCapacity, -1.0f);
+	color_.assign(capacity, Vector4{0.0f, 0.0f, 0.0f, 0.0f});
+	probeParticles_.resize(capacity);
+	probeX_.resize(capacity);
+	probeY_.resize(capacity);
+	probeHits_.resize(capacity);
+	instances_.resize(capacity);
+	droppedCount_ = 0;
+	Clear();
+}
+
+void ParticleSystem::Clear() {
+	count_ = 0;
+	collidingCount_ = 0;
+	instanceCount_ = 0;
+	for (Emitter& emitter : emitters_) {
+		emitter.isActive = false;
+	}
+}
+
+void ParticleSystem::Burst(const ParticleEmitterDesc& desc, const Vector3& position) { Emit(desc, position, desc.burstCount); }
+
+bool ParticleSystem::StartEmitter(const ParticleEmitterDesc& desc, const Vector3& position) {
+	for (Emitter& emitter : emitters_) {
+		if (emitter.isActive) {
+			continue;
+		}
+		emitter.desc = desc;
+		emitter.position = position;
+		emitter.remaining = desc.duration;
+		emitter.accumulator = 0.0f;
+		emitter.isActive = true;
+		Emit(desc, position, desc.burstCount);
+		return true;
+	}
+	return false;
+}
+
+uint32_t ParticleSystem::GetActiveEmitterCount() const {
+	uint32_t activeCount = 0;
+	for (const Emitter& emitter : emitters_) {
+		activeCount += emitter.isActive ? 1 : 0;
+	}
+	return activeCount;
+}
+
+void ParticleSystem::Update(float deltaTime, const MapChipField* map) {
+	PROFILE_FUNCTION();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	// 持続エミッタ（端数は次の tick に持ち越す）
+	for (Emitter& emitter : emitters_) {
+		if (!emitter.isActive) {
+			continue;
+		}
+		emitter.accumulator += emitter.desc.rate * deltaTime;
+		uint32_t emitCount = static_cast<uint32_t>(emitter.accumulator);
+		emitter.accumulator -= static_cast<float>(emitCount);
+		Emit(emitter.desc, emitter.position, emitCount);
+		emitter.remaining -= deltaTime;
+		emitter.isActive = emitter.remaining > 0.0f;
+	}
+
+	Integrate(deltaTime);
+	if (map && collidingCount_ > 0) {
+		CollideWithTiles(deltaTime, *map);
+	}
+	RemoveExpired();
+
+	std::chrono::duration<float, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+	lastUpdateMicroseconds_ = elapsed.count();
+}
+
+void ParticleSystem::BuildInstances() {
+	PROFILE_FUNCTION();
+	for (uint32_t i = 0; i < count_; ++i) {
+		InstanceData& instance = instances_[i];
+		Matrix4x4& matrix = instance.matWorld;
+		matrix = {};
+		matrix.m[0][0] = size_[i];
+		matrix.m[1][1] = size_[i];
+		matrix.m[2][2] = size_[i];
+		matrix.m[3][0] = positionX_[i];
+		matrix.m[3][1] = positionY_[i];
+		matrix.m[3][3] = 1.0f;
+		// 寿命に合わせて薄くする
+		instance.color = color_[i];
+		instance.color.w *= std::clamp(life_[i] * inverseLifetime_[i], 0.0f, 1.0f);
+	}
+	instanceCount_ = count_;
+}
+
+void ParticleSystem::Emit(const ParticleEmitterDesc& desc, const Vector3& position, uint32_t count) {
+	const uint32_t available = capacity_ - count_;
+	if (count > available) {
+		droppedCount_ += count - available;
+		count = available;
+	}
+	const float restitution = desc.collidesWithTiles ? desc.restitution : -1.0f;
+	for (uint32_t n = 0; n < count; ++n) {
+		const uint32_t i = count_++;
+		float angle = desc.direction + (NextRandom() - 0.5f) * desc.spread;
+		float speed = desc.speedMin + (desc.speedMax - desc.speedMin) * NextRandom();
+		float lifetime = std::max(desc.lifetimeMin + (desc.lifetimeMax - desc.lifetimeMin) * NextRandom(), 0.001f);
+		positionX_[i] = position.x;
+		positionY_[i] = position.y;
+		velocityX_[i] = std::cos(angle) * speed;
+		velocityY_[i] = std::sin(angle) * speed;
+		gravity_[i] = desc.gravity;
+		life_[i] = lifetime;
+		inverseLifetime_[i] = 1.0f / lifetime;
+		size_[i] = desc.size;
+		restitution_[i] = restitution;
+		color_[i] = desc.color;
+	}
+	if (desc.collidesWithTiles) {
+		collidingCount_ += count;
+	}
+}
+
+void ParticleSystem::Integrate(float deltaTime) {
+	// 末尾の端数も 4 つ単位で進める（count_ より後ろの枠は動いても読まれない）
+	const uint32_t paddedCount = (count_ + 3u) & ~3u;
+	float* positionX = positionX_.data();
+	float* positionY = positionY_.data();
+	const float* velocityX = velocityX_.data();
+	float* velocityY = velocityY_.data();
+	const float* gravity = gravity_.data();
+	float* life = life_.data();
+#ifdef PARTICLE_USE_SSE
+	const __m128 delta = _mm_set1_ps(deltaTime);
+	for (uint32_t i = 0; i < paddedCount; i += 4) {
+		__m128 newVelocityY = _mm_sub_ps(_mm_loadu_ps(velocityY + i), _mm_mul_ps(_mm_loadu_ps(gravity + i), delta));
+		_mm_storeu_ps(positionX + i, _mm_add_ps(_mm_loadu_ps(positionX + i), _mm_mul_ps(_mm_loadu_ps(velocityX + i), delta)));
+		_mm_storeu_ps(positionY + i, _mm_add_ps(_mm_loadu_ps(positionY + i), _mm_mul_ps(newVelocityY, delta)));
+		_mm_storeu_ps(velocityY + i, newVelocityY);
+		_mm_storeu_ps(life + i, _mm_sub_ps(_mm_loadu_ps(life + i), delta));
+	}
+#else
+	for (uint32_t i = 0; i < paddedCount; ++i) {
+		velocityY[i] -= gravity[i] * deltaTime;
+		positionX[i] += velocityX[i] * deltaTime;
+		positionY[i] += velocityY[i] * deltaTime;
+		life[i] -= deltaTime;
+	}
+#endif
+}
+
+void ParticleSystem::CollideWithTiles(float deltaTime, const MapChipField& map) {
+	PROFILE_FUNCTION();
+	const uint32_t numBlockVertical = map.GetNumBlockVertical();
+
+	// 当たる粒子の移動先のタイルを集めて、一度に引く
+	uint32_t probeCount = 0;
+	for (uint32_t i = 0; i < count_; ++i) {
+		if (restitution_[i] < 0.0f) {
+			continue;
+		}
+		probeParticles_[probeCount] = i;
+		probeX_[probeCount] = ToTileX(positionX_[i]);
+		probeY_[probeCount] = ToTileY(positionY_[i], numBlockVertical);
+		probeCount++;
+	}
+	map.IsBlockAtIndices(probeX_.data(), probeY_.data(), probeHits_.data(), probeCount);
+
+	for (uint32_t n = 0; n < probeCount; ++n) {
+		if (!probeHits_[n]) {
+			continue;
+		}
+		// この tick の移動を戻し、行が変わっていれば上下、同じ行なら左右に跳ね返る
+		const uint32_t i = probeParticles_[n];
+		positionX_[i] -= velocityX_[i] * deltaTime;
+		positionY_[i] -= velocityY_[i] * deltaTime;
+		if (ToTileY(positionY_[i], numBlockVertical) != probeY_[n]) {
+			velocityY_[i] = -velocityY_[i] * restitution_[i];
+			velocityX_[i] = std::fabs(velocityX_[i]) > kRestSpeed ? velocityX_[i] * kTileFriction : 0.0f;
+		} else {
+			velocityX_[i] = -velocityX_[i] * restitution_[i];
+		}
+	}
+}
+
+void ParticleSystem::RemoveExpired() {
+	for (uint32_t i = 0; i < count_;) {
+		if (life_[i] > 0.0f) {
+			++i;
+			continue;
+		}
+		if (restitution_[i] >= 0.0f) {
+			collidingCount_--;
+		}
+		// 末尾の粒子で埋める（順番は変わるが、生きている粒子は先頭に詰まったまま）
+		const uint32_t last = --count_;
+		positionX_[i] = positionX_[last];
+		positionY_[i] = positionY_[last];
+		velocityX_[i] = velocityX_[last];
+		velocityY_[i] = velocityY_[last];
+		gravity_[i] = gravity_[last];
+		life_[i] = life_[last];
+		inverseLifetime_[i] = inverseLifetime_[last];
+		size_[i] = size_[last];
+		restitution_[i] = restitution_[last];
+		color_[i] = color_[last];
+	}
+}
+
+float ParticleSystem::NextRandom() {
+	randomState_ ^= randomState_ << 13;
+	randomState_ ^= randomState_ >> 17;
+	randomState_ ^= randomState_ << 5;
+	return static_cast<float>(randomState_ >> 8) * (1.0f / 16777216.0f);
+}
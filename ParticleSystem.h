@@ -0,0 +1,105 @@
+#pragma once
+#include "KamataEngine.h"
+#include "InstanceBatch.h"
+#include "MapChipField.h"
+#include <cstdint>
+#include <vector>
+using namespace KamataEngine;
+
+// 粒子の出し方（効果ごとに 1 つ用意して使い回す）
+struct ParticleEmitterDesc {
+	uint32_t burstCount = 16; // Burst / StartEmitter の開始時に出す数
+	float rate = 0.0f;        // 持続エミッタが 1 秒あたりに出す数
+	float duration = 0.0f;    // 持続エミッタが出し続ける秒数
+	float direction = 1.5707963f; // 中心の向き（ラジアン、+y が上）
+	float spread = 6.2831853f;    // 向きのばらつき（全幅）
+	float speedMin = 4.0f;        // 1 秒あたりの速さ
+	float speedMax = 8.0f;
+	float lifetimeMin = 0.4f;
+	float lifetimeMax = 0.8f;
+	float gravity = 20.0f; // 下向きの加速度
+	float size = 0.2f;
+	Vector4 color = {1.0f, 1.0f, 1.0f, 1.0f};
+	bool collidesWithTiles = false;
+	float restitution = 0.4f; // タイルに当たったときの跳ね返り
+};
+
+// CPU の粒子。容量を Initialize で 1 回だけ確保し、以降の Burst / Update / 描画データの作成では確保しない。
+// 粒子は配列（SoA）で持ち、生きているものを先頭に詰めておく（消えたら末尾と入れ替える）。
+// 移動は SSE で 4 つずつ進め、タイルとの当たりは当たる粒子の分だけ MapChipField::IsBlockAtIndices で一度に引く。
+class ParticleSystem {
+public:
+	static constexpr uint32_t kMaxEmitters = 32;
+
+	// capacity 個分を確保する（関卡のロード時に呼ぶ）
+	void Initialize(uint32_t capacity);
+	// 粒子とエミッタを全部消す（確保したものはそのまま）
+	void Clear();
+
+	// その場で desc.burstCount 個出す。容量を超えた分は捨てる
+	void Burst(const ParticleEmitterDesc& desc, const Vector3& position);
+	// desc.duration 秒間出し続けるエミッタを始める。エミッタが埋まっていれば false
+	bool StartEmitter(const ParticleEmitterDesc& desc, const Vector3& position);
+
+	// deltaTime 秒進める。map があればタイルと当たる粒子を跳ね返す
+	void Update(float deltaTime, const MapChipField* map);
+	// 生きている粒子の描画データ（大きさの行列と寿命で薄くなる色）を作る
+	void BuildInstances();
+
+	const InstanceData* GetInstances() const { return instances_.data(); }
+	uint32_t GetInstanceCount() const { return instanceCount_; }
+
+	uint32_t GetCount() const { return count_; }
+	uint32_t GetCapacity() const { return capacity_; }
+	uint32_t GetActiveEmitterCount() const;
+	// 容量が足りずに捨てた数（Initialize からの累計）
+	uint64_t GetDroppedCount() const { return droppedCount_; }
+	float GetLastUpdateMicroseconds() const { return lastUpdateMicroseconds_; }
+
+private:
+	struct Emitter {
+		ParticleEmitterDesc desc;
+		Vector3 position = {0.0f, 0.0f, 0.0f};
+		float remaining = 0.0f;   // 残りの秒数
+		float accumulator = 0.0f; // 出しきれていない端数
+		bool isActive = false;
+	};
+
+	void Emit(const ParticleEmitterDesc& desc, const Vector3& position, uint32_t count);
+	void Integrate(float deltaTime);
+	void CollideWithTiles(float deltaTime, const MapChipField& map);
+	void RemoveExpired();
+	// 0 ~ 1 の乱数（確保なしの xorshift）
+	float NextRandom();
+
+	uint32_t capacity_ = 0;
+	uint32_t count_ = 0;
+
+	// --- 粒子ごとの状態（SIMD で 4 つずつ読めるよう、容量は 4 の倍数に切り上げる） ---
+	std::vector<float> positionX_;
+	std::vector<float> positionY_;
+	std::vector<float> velocityX_;
+	std::vector<float> velocityY_;
+	std::vector<float> gravity_;
+	std::vector<float> life_;            // 残りの秒数
+	std::vector<float> inverseLifetime_; // 1 / 最初の寿命（色を薄くする割合）
+	std::vector<float> size_;
+	std::vector<float> restitution_; // タイルと当たらない粒子は負の値
+	std::vector<Vector4> color_;
+
+	// --- タイル判定の作業領域（当たる粒子の分だけ使う） ---
+	std::vector<uint32_t> probeParticles_;
+	std::vector<uint32_t> probeX_;
+	std::vector<uint32_t> probeY_;
+	std::vector<uint8_t> probeHits_;
+	uint32_t collidingCount_ = 0; // タイルと当たる粒子の数（0 なら判定を飛ばす）
+
+	Emitter emitters_[kMaxEmitters];
+
+	std::vector<InstanceData> instances_;
+	uint32_t instanceCount_ = 0;
+
+	uint32_t randomState_ = 0x9E3779B9u;
+	uint64_t droppedCount_ = 0;
+	float lastUpdateMicroseconds_ = 0.0f;
+};
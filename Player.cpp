@@ -1,7 +1,9 @@
 #include "Player.h"
 #include "MapChipField.h"
-#include "Goal.h"
 #include "GameScene.h"
+#include "GameClock.h"
+#include "Profiler.h"
+#include "Logger.h"
 #include <cmath>
 
 void Player::Initialize(Model* model) { 
@@ -12,29 +14,34 @@ void Player::Initialize(Model* model) {
 
 void Player::Update() {
 	Move();
-	CheckObjectCollisions();
 	worldTransform_.MakeAffineMatrix4x4();
 	worldTransform_.TransferMatrix();
-
-#ifdef _DEBUG
-	ShowDebugWindow();
-#endif
 }
 
 void Player::Move() {
+	PROFILE_FUNCTION();
+
 	// Update frame-independent timers first
-	const float deltaTime = 1.0f / 60.0f; // TODO: Get real delta time
-	UpdateTimers(deltaTime);
+	UpdateTimers(GameClock::kFixedDeltaTime);
 	
 	// Handle input and physics
-	HandleInput();
-	UpdatePhysics();
+	{
+		PROFILE_SCOPE("Player::Move::InputPhysics");
+		HandleInput();
+		UpdatePhysics();
+	}
 	
 	// Perform movement with collision detection
-	ApplyMovementWithCollision();
+	{
+		PROFILE_SCOPE("Player::Move::Collision");
+		ApplyMovementWithCollision();
+	}
 	
 	// Update collision states AFTER movement (critical for wall sliding)
-	UpdateCollisionStatesPostMovement();
+	{
+		PROFILE_SCOPE("Player::Move::PostMovement");
+		UpdateCollisionStatesPostMovement();
+	}
 	
 	// Clear frame input flags
 	ClearFrameInputs();
@@ -53,26 +60,32 @@ void Player::UpdateTimers(float deltaTime) {
 	if (wallJumpDirectionLockTimer > 0.0f) {
 		wallJumpDirectionLockTimer -= deltaTime;
 	}
+
+	airTime = isOnGround ? 0.0f : airTime + deltaTime;
 }
 
 void Player::HandleInput() {
 	// Process movement input
-	isLeft = Input::GetInstance()->PushKey(DIK_A) || Input::GetInstance()->PushKey(DIK_LEFT);
-	isRight = Input::GetInstance()->PushKey(DIK_D) || Input::GetInstance()->PushKey(DIK_RIGHT);
+	PlayerInputState input = inputSource_ ? inputSource_->Poll() : keyboardInput_.Poll();
+	// 带时间戳的输入源给出本 tick 内按住的比例，其他输入源按住即为 1
+	leftInput = input.leftHeld >= 0.0f ? input.leftHeld : (input.left ? 1.0f : 0.0f);
+	rightInput = input.rightHeld >= 0.0f ? input.rightHeld : (input.right ? 1.0f : 0.0f);
 	
 	// Process jump input
-	isJumpTriggered = Input::GetInstance()->TriggerKey(DIK_SPACE) || Input::GetInstance()->TriggerKey(DIK_W);
+	isJumpTriggered = input.jumpTriggered;
 	
 	// Set jump buffers if jump was triggered
 	if (isJumpTriggered) {
-		jumpBufferTimer = jumpBufferTime;
-		wallJumpBufferTimer = wallJumpBufferTime;
+		// 缓冲从实际按下的时刻开始计时（jumpAge：按下到本 tick 的秒数）
+		jumpBufferTimer = jumpBufferTime - input.jumpAge;
+		wallJumpBufferTimer = wallJumpBufferTime - input.jumpAge;
 	}
 }
 
 void Player::UpdatePhysics() {
 	// Store previous states
 	wasOnGround = isOnGround;
+	landingSpeed_ = 0.0f;
 	wasOnWall = isOnWallLeft || isOnWallRight;
 	
 	// Handle jumping (regular and wall jump)
@@ -80,7 +93,7 @@ void Player::UpdatePhysics() {
 	
 	// Apply horizontal movement (if not locked by wall jump)
 	if (wallJumpDirectionLockTimer <= 0.0f) {
-		velocity.x = static_cast<float>(isRight - isLeft) * speed;
+		velocity.x = (rightInput - leftInput) * speed;
 	}
 	
 	// Apply gravity and physics
@@ -109,11 +122,10 @@ void Player::ApplyMovementWithCollision() {
 		velocity.x = 0.0f;
 		targetPos.x = adjustedPos.x;
 		
-#ifdef _DEBUG
-		printf("Wall contact: %s - Adjusted from %.3f to %.3f\n", 
+		// 贴墙期间每帧都会走到这里
+		LOG_DEBUG_RATE(LogCategory::kPlayer, 4, "Wall contact: %s - Adjusted from %.3f to %.3f",
 			   isMovingRight ? "RIGHT" : "LEFT", 
 			   currentPos.x + velocity.x, adjustedPos.x);
-#endif
 	}
 	
 	// Apply Y movement
@@ -123,6 +135,9 @@ void Player::ApplyMovementWithCollision() {
 		// Y collision
 		if (velocity.y < 0.0f) {
 			// Hitting ground
+			if (!wasOnGround) {
+				landingSpeed_ = -velocity.y;
+			}
 			isOnGround = true;
 			lastCollisionDirection_ = CollisionDirection::kDown;
 		} else {
@@ -140,6 +155,9 @@ void Player::ApplyMovementWithCollision() {
 void Player::UpdateCollisionStatesPostMovement() {
 	// Update ground state based on current position
 	isOnGround = CheckGroundCollision();
+	if (isOnGround) {
+		canCoyoteJump = true;
+	}
 	
 	// Check wall contact at current position (after movement)
 	Vector3 currentPos = worldTransform_.translation_;
@@ -165,15 +183,13 @@ void Player::UpdateCollisionStatesPostMovement() {
 		}
 	}
 
-#ifdef _DEBUG
 	// Debug wall contact
 	if ((isOnWallLeft || isOnWallRight) && !isOnGround) {
-		printf("Wall contact detected: Left=%s Right=%s Pos=(%.3f,%.3f)\n",
+		LOG_DEBUG_RATE(LogCategory::kPlayer, 4, "Wall contact detected: Left=%s Right=%s Pos=(%.3f,%.3f)",
 			   isOnWallLeft ? "YES" : "NO",
 			   isOnWallRight ? "YES" : "NO",
 			   currentPos.x, currentPos.y);
 	}
-#endif
 }
 
 bool Player::CheckWallCollisionAtPosition(const Vector3& position, bool isLeftSide) const {
@@ -282,33 +298,8 @@ void Player::ApplyWallSlide() {
 	if (canSlide && (isOnWallLeft || isOnWallRight || hasPreviousWallContact)) {
 		if (velocity.y < -wallSlideSpeed) {
 			velocity.y = -wallSlideSpeed;
-			
-#ifdef _DEBUG
-			static int slideCounter = 0;
-			if (slideCounter++ % 30 == 0) { // Print every half second at 60fps
-				printf("Wall sliding: velocity.y = %.3f, walls: L=%s R=%s\n",
-					   velocity.y, isOnWallLeft ? "YES" : "NO", isOnWallRight ? "YES" : "NO");
-			}
-#endif
-		}
-	}
-}
-
-void Player::CheckObjectCollisions() {
-	if (!objects_) {
-		return;
-	}
-
-	for (const auto& object : *objects_) {
-		Goal* goal = dynamic_cast<Goal*>(object.get());
-		if (goal && goal->IsActive()) {
-			bool isColliding = goal->CheckCollisionWithPlayer(worldTransform_.translation_, playerSize_);
-			
-			if (isColliding && !goal->WasCollidingLastFrame() && goal->CanTriggerCollision()) {
-				goal->TriggerCollision();
-			}
-			
-			goal->SetWasCollidingLastFrame(isColliding);
+			LOG_DEBUG_RATE(LogCategory::kPlayer, 2, "Wall sliding: velocity.y = %.3f, walls: L=%s R=%s",
+				   velocity.y, isOnWallLeft ? "YES" : "NO", isOnWallRight ? "YES" : "NO");
 		}
 	}
 }
@@ -339,6 +330,9 @@ void Player::ResetToSpawn() {
 	isOnWallRight = false;
 	wasOnWall = false;
 	isDead = false;
+	landingSpeed_ = 0.0f;
+	airTime = 0.0f;
+	canCoyoteJump = false;
 	
 	// Reset timers
 	jumpBufferTimer = 0.0f;
@@ -349,9 +343,7 @@ void Player::ResetToSpawn() {
 	wallJumpDirection = CollisionDirection::kNone;
 	lastCollisionDirection_ = CollisionDirection::kNone;
 	
-#ifdef _DEBUG
-	printf("Player reset to spawn: (%.2f, %.2f)\n", spawnPosition_.x, spawnPosition_.y);
-#endif
+	LOG_DEBUG(LogCategory::kPlayer, "Player reset to spawn: (%.2f, %.2f)", spawnPosition_.x, spawnPosition_.y);
 }
 
 void Player::HandleJumping() {
@@ -376,7 +368,15 @@ bool Player::CanWallJump() const {
 }
 
 bool Player::CanRegularJump() const {
-	return isOnGround && jumpBufferTimer > 0.0f;
+	if (jumpBufferTimer <= 0.0f) {
+		return false;
+	}
+	if (isOnGround) {
+		return true;
+	}
+	// 土狼时间：按下时的滞空时间 = 当前滞空时间 - 按下后经过的时间
+	float pressAge = jumpBufferTime - jumpBufferTimer;
+	return canCoyoteJump && velocity.y <= 0.0f && airTime - pressAge <= coyoteTime;
 }
 
 void Player::PerformWallJump() {
@@ -401,11 +401,10 @@ void Player::PerformWallJump() {
 		wallJumpBufferTimer = 0.0f;
 		jumpBufferTimer = 0.0f;
 		isOnGround = false;
+		canCoyoteJump = false;
 		
-#ifdef _DEBUG
-		printf("Wall jump: %s wall -> velocity(%.2f, %.2f)\n", 
+		LOG_DEBUG(LogCategory::kPlayer, "Wall jump: %s wall -> velocity(%.2f, %.2f)",
 			   jumpDir == CollisionDirection::kLeft ? "LEFT" : "RIGHT", velocity.x, velocity.y);
-#endif
 	}
 }
 
@@ -413,10 +412,9 @@ void Player::PerformRegularJump() {
 	velocity.y = jumpForce;
 	isOnGround = false;
 	jumpBufferTimer = 0.0f;
+	canCoyoteJump = false;
 	
-#ifdef _DEBUG
-	printf("Regular jump: velocity.y = %.2f\n", velocity.y);
-#endif
+	LOG_DEBUG(LogCategory::kPlayer, "Regular jump: velocity.y = %.2f", velocity.y);
 }
 
 #ifdef _DEBUG
@@ -434,6 +432,7 @@ void Player::ShowDebugWindow() {
 	ImGui::Text("On Ground: %s", isOnGround ? "YES" : "NO");
 	ImGui::Text("Was On Ground: %s", wasOnGround ? "YES" : "NO");
 	ImGui::Text("Jump Buffer: %.3f", jumpBufferTimer);
+	ImGui::Text("Air Time: %.3f (coyote %.3f, %s)", airTime, coyoteTime, canCoyoteJump ? "ready" : "used");
 	
 	// Wall jump state with enhanced info
 	ImGui::Separator();
@@ -544,7 +543,7 @@ void Player::ApplyGravity() {
 }
 
 void Player::ClearFrameInputs() {
-	isLeft = false;
-	isRight = false;
+	leftInput = 0.0f;
+	rightInput = 0.0f;
 	isJumpTriggered = false;
 }
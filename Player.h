@@ -2,9 +2,9 @@
 #include <KamataEngine.h>
 #include <vector>
 #include <memory>
+#include "PlayerInput.h"
 using namespace KamataEngine;
 class MapChipField;
-class Goal;
 class GameScene;
 
 enum class CollisionDirection {
@@ -23,8 +23,10 @@ public:
 
 	void Update() override;
 
-	void SetMapChipField(MapChipField* mapChipField) { mapChipField_ = mapChipField; }
+	void SetMapChipField(const MapChipField* mapChipField) { mapChipField_ = mapChipField; }
 	void SetGameScene(GameScene* gameScene) { gameScene_ = gameScene; }
+	// 入力の取得元（nullptr ならキーボード）
+	void SetInputSource(IPlayerInputSource* inputSource) { inputSource_ = inputSource; }
 	void Move();
 
 	// 碰撞检测相关方法
@@ -33,9 +35,12 @@ public:
 	Vector3 GetPlayerSize() const { return playerSize_; }
 	void SetPlayerSize(const Vector3& size) { playerSize_ = size; }
 
-	// 对象碰撞检测相关方法
-	void SetObjects(const std::vector<std::unique_ptr<Object3d>>* objects) { objects_ = objects; }
-	void CheckObjectCollisions();
+	// 每 tick 的移动量
+	Vector2 GetVelocity() const { return velocity; }
+	// 本 tick 落地时的下落速度（没有落地则为 0，用于落地效果）
+	float GetLandingSpeed() const { return landingSpeed_; }
+	// 最后一次 Update 计算的世界矩阵（渲染快照用）
+	const Matrix4x4& GetWorldMatrix() const { return worldTransform_.matWorld_; }
 
 	void SetIsDead(bool dead) { isDead = dead; }
 	bool GetIsDead() const { return isDead; }
@@ -48,11 +53,22 @@ public:
 
 	// 重置玩家状态（用于重新开始关卡）
 	void ResetToSpawn();
+	// 直接设置位置和每 tick 的移动量（基准测试中让相机沿指定轨迹追随）
+	void SetState(const Vector3& position, const Vector2& tickVelocity) {
+		worldTransform_.translation_ = position;
+		velocity = tickVelocity;
+	}
+
+#ifdef _DEBUG
+	// 调试窗口（由 GameScene 的调试 UI 调用，ImGui 只能在主线程使用）
+	void ShowDebugWindow();
+#endif
 
 private:
-	MapChipField* mapChipField_ = nullptr;
+	const MapChipField* mapChipField_ = nullptr;
 	GameScene* gameScene_ = nullptr;
-	const std::vector<std::unique_ptr<Object3d>>* objects_ = nullptr;
+	IPlayerInputSource* inputSource_ = nullptr;
+	KeyboardInputSource keyboardInput_;
 	
 	// Physics properties
 	Vector2 velocity = {0.0f, 0.0f};
@@ -69,15 +85,20 @@ private:
 	bool isOnWallLeft = false;
 	bool isOnWallRight = false;
 	bool wasOnWall = false;
+	float landingSpeed_ = 0.0f;
 
 	// Input state (frame-based)
-	bool isLeft = false;
-	bool isRight = false;
+	float leftInput = 0.0f;  // 本 tick 内按住左键的比例（0 ~ 1）
+	float rightInput = 0.0f;
 	bool isJumpTriggered = false;
 
 	// Jump parameters
 	float jumpBufferTime = 0.1f;
 	float jumpBufferTimer = 0.0f;
+	// 土狼时间：离开地面后仍可起跳的秒数（按按下的时刻判断）
+	float coyoteTime = 0.08f;
+	float airTime = 0.0f; // 上次着地后的秒数
+	bool canCoyoteJump = false;
 
 	// Wall jump parameters
 	float wallJumpForce = 0.45f;
@@ -129,8 +150,4 @@ private:
 	// 新增：墙体贴合方法
 	Vector3 AdjustPositionToWall(const Vector3& currentPos, const Vector3& targetPos, bool isLeftWall);
 	float FindWallContactPosition(const Vector3& centerPos, bool isLeftSide) const;
-
-#ifdef _DEBUG
-	void ShowDebugWindow();
-#endif
 };
\ No newline at end of file
@@ -0,0 +1,127 @@
+#include "PlayerInput.h"
+#include "KamataEngine.h"
+#include "GameClock.h"
+#include <algorithm>
+#include <chrono>
+using namespace KamataEngine;
+
+PlayerInputState KeyboardInputSource::Poll() {
+	Input* input = Input::GetInstance();
+	PlayerInputState state;
+	state.left = input->PushKey(DIK_A) || input->PushKey(DIK_LEFT);
+	state.right = input->PushKey(DIK_D) || input->PushKey(DIK_RIGHT);
+	state.jumpTriggered = input->TriggerKey(DIK_SPACE) || input->TriggerKey(DIK_W);
+	return state;
+}
+
+PlayerInputState RandomInputSource::Poll() {
+	if (holdTicks_ == 0) {
+		// 右に進みやすくして、ゴールまでたどり着けるようにする
+		uint32_t direction = Next() % 4;
+		held_.left = direction == 1;
+		held_.right = direction >= 2;
+		holdTicks_ = 15 + Next() % 90;
+	}
+	holdTicks_--;
+
+	PlayerInputState state = held_;
+	state.jumpTriggered = Next() % 20 == 0;
+	return state;
+}
+
+bool InputEventQueue::Push(const InputEvent& event) {
+	const uint32_t tail = tail_.load(std::memory_order_relaxed);
+	if (tail - head_.load(std::memory_order_acquire) >= kCapacity) {
+		droppedCount_.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	events_[tail % kCapacity] = event;
+	tail_.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+bool InputEventQueue::Peek(InputEvent& event) const {
+	const uint32_t head = head_.load(std::memory_order_relaxed);
+	if (head == tail_.load(std::memory_order_acquire)) {
+		return false;
+	}
+	event = events_[head % kCapacity];
+	return true;
+}
+
+void InputEventQueue::Pop() { head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+void LatchedInputSource::Latch(const PlayerInputState& state, int64_t timestamp) {
+	// 変わったキーだけイベントにする（ジャンプは押した瞬間だけ）
+	if (state.left != latched_.left) {
+		queue_.Push({timestamp, InputAction::kLeft, state.left});
+	}
+	if (state.right != latched_.right) {
+		queue_.Push({timestamp, InputAction::kRight, state.right});
+	}
+	if (state.jumpTriggered) {
+		queue_.Push({timestamp, InputAction::kJump, true});
+	}
+	latched_ = state;
+	latchedTimestamp_.store(timestamp, std::memory_order_release);
+}
+
+void LatchedInputSource::PushEvent(const InputEvent& event) {
+	queue_.Push(event);
+	latchedTimestamp_.store(event.timestamp, std::memory_order_release);
+}
+
+PlayerInputState LatchedInputSource::Poll() {
+	return PollAt(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+PlayerInputState LatchedInputSource::PollAt(int64_t now) {
+	// 前回の Poll から now までを 1 tick の区間とする（最初は 1 tick 前から）
+	const int64_t fixedDeltaNanoseconds = static_cast<int64_t>(GameClock::kFixedDeltaTime * 1.0e9f);
+	const int64_t windowBegin = lastPollTimestamp_ != 0 ? std::min(lastPollTimestamp_, now) : now - fixedDeltaNanoseconds;
+	const int64_t windowLength = std::max<int64_t>(now - windowBegin, 1);
+
+	PlayerInputState state;
+	int64_t cursor = windowBegin;
+	int64_t leftHeld = 0;
+	int64_t rightHeld = 0;
+	int64_t lastJumpTimestamp = 0;
+	InputEvent event;
+	// now より後のイベントは次の tick に回す
+	while (queue_.Peek(event) && event.timestamp <= now) {
+		queue_.Pop();
+		// 前の区間に遅れて届いたイベントは区間の始めに押したものとして扱う
+		const int64_t timestamp = std::max(event.timestamp, windowBegin);
+		leftHeld += isLeftHeld_ ? timestamp - cursor : 0;
+		rightHeld += isRightHeld_ ? timestamp - cursor : 0;
+		cursor = timestamp;
+		switch (event.action) {
+		case InputAction::kLeft:
+			isLeftHeld_ = event.isPressed;
+			break;
+		case InputAction::kRight:
+			isRightHeld_ = event.isPressed;
+			break;
+		case InputAction::kJump:
+			if (event.isPressed) {
+				state.jumpTriggered = true;
+				lastJumpTimestamp = event.timestamp;
+			}
+			break;
+		}
+	}
+	leftHeld += isLeftHeld_ ? now - cursor : 0;
+	rightHeld += isRightHeld_ ? now - cursor : 0;
+
+	// 区間の途中で離したキーも、押していた分は動かす
+	state.left = isLeftHeld_ || leftHeld > 0;
+	state.right = isRightHeld_ || rightHeld > 0;
+	state.leftHeld = static_cast<float>(static_cast<double>(leftHeld) / static_cast<double>(windowLength));
+	state.rightHeld = static_cast<float>(static_cast<double>(rightHeld) / static_cast<double>(windowLength));
+	state.jumpAge = state.jumpTriggered ? static_cast<float>(static_cast<double>(std::max<int64_t>(now - lastJumpTimestamp, 0)) * 1.0e-9) : 0.0f;
+
+	lastPollTimestamp_ = now;
+	// now より後に Latch された入力はまだ取り込んでいない
+	polledTimestamp_ = std::min(latchedTimestamp_.load(std::memory_order_acquire), now);
+	return state;
+}
@@ -0,0 +1,146 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// 1 tick 分のプレイヤー入力
+struct PlayerInputState {
+	bool left = false;
+	bool right = false;
+	bool jumpTriggered = false;
+
+	// 以下は時刻付きのイベントから作る入力元（LatchedInputSource）だけが入れる。tick の中のタイミング
+	float jumpAge = 0.0f;   // 最後にジャンプを押してから Poll までの秒数
+	float leftHeld = -1.0f; // 前回の Poll からの間に左を押していた割合（0 ~ 1）。負なら left を使う
+	float rightHeld = -1.0f;
+};
+
+// 押した・離したの時刻付きイベント
+enum class InputAction : uint8_t {
+	kLeft,
+	kRight,
+	kJump,
+};
+struct InputEvent {
+	int64_t timestamp = 0; // steady_clock のナノ秒
+	InputAction action = InputAction::kJump;
+	bool isPressed = false;
+};
+
+// 単一生産者・単一消費者の固定長キュー（確保なし）。満杯なら捨てて数える
+class InputEventQueue {
+public:
+	static constexpr uint32_t kCapacity = 256;
+
+	// 生産者スレッドから
+	bool Push(const InputEvent& event);
+	// 消費者スレッドから
+	bool Peek(InputEvent& event) const;
+	void Pop();
+
+	uint64_t GetDroppedCount() const { return droppedCount_.load(std::memory_order_relaxed); }
+
+private:
+	InputEvent events_[kCapacity];
+	std::atomic<uint32_t> head_{0}; // 次に読む位置（消費者が進める）
+	std::atomic<uint32_t> tail_{0}; // 次に書く位置（生産者が進める）
+	std::atomic<uint64_t> droppedCount_{0};
+};
+
+// プレイヤー入力の取得元。Player はキーボードを直接読まずにここから受け取る。
+class IPlayerInputSource {
+public:
+	virtual ~IPlayerInputSource() = default;
+	// 1 tick に 1 回呼ばれる
+	virtual PlayerInputState Poll() = 0;
+};
+
+// KamataEngine の Input から読む（通常のプレイ）
+class KeyboardInputSource : public IPlayerInputSource {
+public:
+	PlayerInputState Poll() override;
+};
+
+// 決まった入力列を繰り返す（ベンチマーク・リプレイ用）
+class ScriptedInputSource : public IPlayerInputSource {
+public:
+	ScriptedInputSource() = default;
+	explicit ScriptedInputSource(std::vector<PlayerInputState> script) : script_(std::move(script)) {}
+
+	void SetScript(std::vector<PlayerInputState> script) {
+		script_ = std::move(script);
+		cursor_ = 0;
+	}
+	void Rewind() { cursor_ = 0; }
+
+	PlayerInputState Poll() override {
+		if (script_.empty()) {
+			return {};
+		}
+		PlayerInputState state = script_[cursor_];
+		cursor_ = (cursor_ + 1) % script_.size();
+		return state;
+	}
+
+private:
+	std::vector<PlayerInputState> script_;
+	size_t cursor_ = 0;
+};
+
+// 乱数で入力を作る（ソークテスト用）。左右は一定 tick ごとに選び直し、ジャンプはときどき押す。
+// 同じシードなら同じ入力列になる。
+class RandomInputSource : public IPlayerInputSource {
+public:
+	explicit RandomInputSource(uint32_t seed) : state_(seed ? seed : 1u) {}
+
+	PlayerInputState Poll() override;
+
+private:
+	// xorshift32
+	uint32_t Next() {
+		state_ ^= state_ << 13;
+		state_ ^= state_ >> 17;
+		state_ ^= state_ << 5;
+		return state_;
+	}
+
+	uint32_t state_;
+	PlayerInputState held_;
+	uint32_t holdTicks_ = 0;
+};
+
+// 別スレッドへ入力を渡す（スレッド分離モード用）。
+// メインスレッドが毎フレーム Latch し、シミュレーションスレッドが Poll する。
+// 入力は押した・離した時刻付きのイベントとしてキューに積むので、フレームと tick の速さが違っても取りこぼさず、
+// Poll は前回の Poll からの間に各キーを押していた割合と、ジャンプを押してからの秒数を返す（ジャンプの猶予をサブフレームで測れる）。
+class LatchedInputSource : public IPlayerInputSource {
+public:
+	// メインスレッドから。timestamp は入力を読んだ時刻（steady_clock のナノ秒）。前回との差をイベントにする
+	void Latch(const PlayerInputState& state, int64_t timestamp);
+	// Latch の代わりに、押した・離した時刻そのものを渡す（フレームより細かく読める入力元・テスト用）。Latch と混ぜない
+	void PushEvent(const InputEvent& event);
+
+	// シミュレーションスレッドから
+	PlayerInputState Poll() override;
+	// now（steady_clock のナノ秒）までのイベントを取り込む。テストでは時刻を直接渡す
+	PlayerInputState PollAt(int64_t now);
+	// 直前の Poll が読んだ入力の時刻（まだ Latch されていなければ 0）
+	int64_t GetPolledTimestamp() const { return polledTimestamp_; }
+	// 直前の Poll を呼んだ時刻（入力をシミュレーションが取り込んだ時刻。まだ呼ばれていなければ 0）
+	int64_t GetLastPollTimestamp() const { return lastPollTimestamp_; }
+	// キューが満杯で捨てたイベントの数
+	uint64_t GetDroppedEventCount() const { return queue_.GetDroppedCount(); }
+
+private:
+	InputEventQueue queue_;
+	std::atomic<int64_t> latchedTimestamp_{0};
+	PlayerInputState latched_; // メインスレッドのみ（前回 Latch した状態）
+
+	// 以下はシミュレーションスレッドのみ
+	bool isLeftHeld_ = false;
+	bool isRightHeld_ = false;
+	int64_t lastPollTimestamp_ = 0;
+	int64_t polledTimestamp_ = 0;
+};
@@ -0,0 +1,218 @@
+#include "Profiler.h"
+
+#ifdef USE_PROFILER
+
+#include "KamataEngine.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+std::unique_ptr<Profiler> Profiler::instance_ = nullptr;
+
+namespace {
+	uint64_t SteadyNanoseconds() {
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	// トレースに書く名前（" と \ だけエスケープする）
+	void WriteEscaped(std::ofstream& file, const char* text) {
+		for (const char* c = text; *c; ++c) {
+			if (*c == '"' || *c == '\\') {
+				file << '\\';
+			}
+			file << *c;
+		}
+	}
+}
+
+Profiler& Profiler::GetInstance() {
+	if (!instance_) {
+		instance_ = std::unique_ptr<Profiler>(new Profiler());
+	}
+	return *instance_;
+}
+
+void Profiler::Destroy() { instance_.reset(); }
+
+Profiler::Profiler() {
+	originTicks_ = Now();
+	originNanoseconds_ = SteadyNanoseconds();
+#ifdef PROFILER_HAS_RDTSC
+	ticksPerMicrosecond_ = 3000.0; // 最初の補正までの仮の値
+#else
+	ticksPerMicrosecond_ = 1000.0;
+#endif
+	summary_.reserve(64);
+}
+
+ProfileThreadBuffer* Profiler::RegisterCurrentThread() {
+	Profiler& profiler = GetInstance();
+	std::lock_guard<std::mutex> lock(profiler.registryMutex_);
+	std::unique_ptr<ProfileThreadBuffer> buffer = std::make_unique<ProfileThreadBuffer>();
+	buffer->threadID = static_cast<uint32_t>(profiler.buffers_.size());
+	profiler.buffers_.push_back(std::move(buffer));
+	return profiler.buffers_.back().get();
+}
+
+void Profiler::Calibrate() {
+#ifdef PROFILER_HAS_RDTSC
+	uint64_t ticks = Now();
+	uint64_t nanoseconds = SteadyNanoseconds();
+	// 1ms 以上経ってから起動時との比で求める
+	if (nanoseconds > originNanoseconds_ + 1000000 && ticks > originTicks_) {
+		ticksPerMicrosecond_ = static_cast<double>(ticks - originTicks_) / (static_cast<double>(nanoseconds - originNanoseconds_) / 1000.0);
+	}
+#endif
+}
+
+float Profiler::TicksToMicroseconds(uint64_t ticks) const { return static_cast<float>(static_cast<double>(ticks) / ticksPerMicrosecond_); }
+
+void Profiler::BeginFrame() {
+	if (!mainBuffer_) {
+		mainBuffer_ = GetThreadBuffer();
+	}
+	frameStartIndex_ = mainBuffer_->writeIndex.load(std::memory_order_relaxed);
+	frameBeginTicks_ = Now();
+}
+
+void Profiler::EndFrame() {
+	if (!mainBuffer_) {
+		return;
+	}
+	Calibrate();
+	lastFrameMilliseconds_ = TicksToMicroseconds(Now() - frameBeginTicks_) / 1000.0f;
+
+	if (isPaused_) {
+		return;
+	}
+
+	// メインスレッドの今フレームのイベントを 名前 + 深さ で集計
+	summary_.clear();
+	uint64_t end = mainBuffer_->writeIndex.load(std::memory_order_relaxed);
+	uint64_t begin = end > ProfileThreadBuffer::kCapacity ? end - ProfileThreadBuffer::kCapacity : 0;
+	begin = std::max(begin, frameStartIndex_);
+	for (uint64_t i = begin; i < end; ++i) {
+		const ProfileEvent& event = mainBuffer_->events[i & ProfileThreadBuffer::kMask];
+		SummaryEntry* entry = nullptr;
+		for (SummaryEntry& candidate : summary_) {
+			if (candidate.name == event.name && candidate.depth == event.depth) {
+				entry = &candidate;
+				break;
+			}
+		}
+		if (!entry) {
+			summary_.push_back({event.name, event.depth, 0, event.begin, 0.0f});
+			entry = &summary_.back();
+		}
+		entry->callCount++;
+		entry->firstBegin = std::min(entry->firstBegin, event.begin);
+		entry->totalMicroseconds += TicksToMicroseconds(event.end - event.begin);
+	}
+
+	// 開始順に並べると親 -> 子の順になる
+	std::sort(summary_.begin(), summary_.end(), [](const SummaryEntry& a, const SummaryEntry& b) {
+		if (a.firstBegin != b.firstBegin) {
+			return a.firstBegin < b.firstBegin;
+		}
+		return a.depth < b.depth;
+	});
+}
+
+bool Profiler::WriteChromeTrace(const std::string& filePath) {
+	std::ofstream file(filePath);
+	if (!file.is_open()) {
+		return false;
+	}
+
+	Calibrate();
+	std::lock_guard<std::mutex> lock(registryMutex_);
+
+	char number[64];
+	bool isFirst = true;
+	file << "{\"traceEvents\":[\n";
+	for (const std::unique_ptr<ProfileThreadBuffer>& buffer : buffers_) {
+		// スレッド名
+		file << (isFirst ? "" : ",\n");
+		isFirst = false;
+		file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadID << ",\"args\":{\"name\":\"";
+		if (buffer.get() == mainBuffer_) {
+			file << "Main";
+		} else {
+			file << "Worker " << buffer->threadID;
+		}
+		file << "\"}}";
+
+		uint64_t end = buffer->writeIndex.load(std::memory_order_acquire);
+		uint64_t begin = end > ProfileThreadBuffer::kCapacity ? end - ProfileThreadBuffer::kCapacity : 0;
+		for (uint64_t i = begin; i < end; ++i) {
+			const ProfileEvent& event = buffer->events[i & ProfileThreadBuffer::kMask];
+			if (!event.name || event.begin < originTicks_) {
+				continue;
+			}
+			file << ",\n{\"name\":\"";
+			WriteEscaped(file, event.name);
+			snprintf(number, sizeof(number), "%.3f", TicksToMicroseconds(event.begin - originTicks_));
+			file << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadID << ",\"ts\":" << number;
+			snprintf(number, sizeof(number), "%.3f", TicksToMicroseconds(event.end - event.begin));
+			file << ",\"dur\":" << number << "}";
+		}
+	}
+	file << "\n]}\n";
+
+	LOG_INFO(LogCategory::kGeneral, "Profiler: Wrote trace to %s", filePath.c_str());
+	return file.good();
+}
+
+float Profiler::MeasureZoneOverhead(uint32_t iterations) {
+	if (iterations == 0) {
+		return 0.0f;
+	}
+	Calibrate();
+	uint64_t start = Now();
+	for (uint32_t i = 0; i < iterations; ++i) {
+		ProfileZone zone("Profiler::Overhead");
+	}
+	uint64_t end = Now();
+
+	// 計測用の区間はフレーム集計に含めない
+	if (mainBuffer_) {
+		frameStartIndex_ = mainBuffer_->writeIndex.load(std::memory_order_relaxed);
+	}
+	return TicksToMicroseconds(end - start) * 1000.0f / static_cast<float>(iterations);
+}
+
+void Profiler::DrawImGui() {
+#ifdef USE_IMGUI
+	ImGui::Begin("Profiler");
+	ImGui::Text("Frame: %.2f ms", lastFrameMilliseconds_);
+	ImGui::Checkbox("Pause", &isPaused_);
+	ImGui::SameLine();
+	if (ImGui::Button("Dump Trace")) {
+		lastTracePath_ = "profile_trace.json";
+		if (!WriteChromeTrace(lastTracePath_)) {
+			lastTracePath_ = "(write failed)";
+		}
+	}
+	ImGui::SameLine();
+	if (ImGui::Button("Measure Overhead")) {
+		zoneOverheadNanoseconds_ = MeasureZoneOverhead();
+	}
+	ImGui::Text("Zone overhead: %.1f ns", zoneOverheadNanoseconds_);
+	if (!lastTracePath_.empty()) {
+		ImGui::Text("Last trace: %s", lastTracePath_.c_str());
+	}
+	ImGui::Separator();
+
+	// 深さでインデントして、フレーム時間に対する割合をバーで表示する
+	float frameMicroseconds = std::max(lastFrameMilliseconds_ * 1000.0f, 1.0f);
+	char label[160];
+	for (const SummaryEntry& entry : summary_) {
+		snprintf(label, sizeof(label), "%*s%s  %.3f ms x%u", static_cast<int>(entry.depth * 2), "", entry.name, entry.totalMicroseconds / 1000.0f, entry.callCount);
+		ImGui::ProgressBar(std::min(entry.totalMicroseconds / frameMicroseconds, 1.0f), ImVec2(-1.0f, 0.0f), label);
+	}
+	ImGui::End();
+#endif
+}
+
+#endif // USE_PROFILER
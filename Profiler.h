@@ -0,0 +1,174 @@
+#pragma once
+
+// フレームプロファイラ。USE_PROFILER が定義されていない構成では全て空になる。
+//   PROFILE_SCOPE("名前");   // スコープの終わりまでを 1 区間として記録
+//   PROFILE_FUNCTION();      // 関数名で記録
+// 名前は文字列リテラルなど、プログラム終了まで生きている文字列を渡すこと。
+#ifdef USE_PROFILER
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define PROFILER_HAS_RDTSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PROFILER_HAS_RDTSC 1
+#endif
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileZone PROFILE_CONCAT(profileZone_, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
+
+struct ProfileEvent {
+	const char* name = nullptr;
+	uint64_t begin = 0;
+	uint64_t end = 0;
+	uint32_t depth = 0;
+};
+
+// スレッドごとのリングバッファ。書き込みは所有スレッドのみ、読み出しは writeIndex を acquire して行う。
+// 古いイベントは上書きされる。
+struct ProfileThreadBuffer {
+	static constexpr uint32_t kCapacity = 1u << 15;
+	static constexpr uint32_t kMask = kCapacity - 1;
+
+	std::unique_ptr<ProfileEvent[]> events = std::make_unique<ProfileEvent[]>(kCapacity);
+	std::atomic<uint64_t> writeIndex{0};
+	uint32_t threadID = 0;
+	uint32_t depth = 0;
+	// 今いる一番内側の区間の名前（確保の計測で区間ごとに集計するため）
+	const char* currentZone = nullptr;
+};
+
+namespace ProfilerDetail {
+	// 呼び出し元スレッドのバッファ（区間の計測ごとに関数呼び出しをしないようにヘッダーに置く）
+	inline thread_local ProfileThreadBuffer* threadBuffer = nullptr;
+}
+
+class Profiler {
+public:
+	// 1 フレーム分の集計（名前 + 深さごと）
+	struct SummaryEntry {
+		const char* name = nullptr;
+		uint32_t depth = 0;
+		uint32_t callCount = 0;
+		uint64_t firstBegin = 0;
+		float totalMicroseconds = 0.0f;
+	};
+
+	Profiler(const Profiler&) = delete;
+	Profiler& operator=(const Profiler&) = delete;
+
+	~Profiler() = default;
+
+	static Profiler& GetInstance();
+	// 終了時のみ呼ぶ（スレッドのバッファも解放される）
+	static void Destroy();
+
+	// メインループの先頭と末尾で呼ぶ（メインスレッド）
+	void BeginFrame();
+	void EndFrame();
+
+	// 現在のタイムスタンプ（rdtsc が使える環境では TSC、それ以外は steady_clock のナノ秒）
+	static uint64_t Now() {
+#ifdef PROFILER_HAS_RDTSC
+		return __rdtsc();
+#else
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+	}
+
+	// 呼び出し元スレッドのバッファ（初回は登録する）
+	static ProfileThreadBuffer* GetThreadBuffer() {
+		if (!ProfilerDetail::threadBuffer) {
+			ProfilerDetail::threadBuffer = RegisterCurrentThread();
+		}
+		return ProfilerDetail::threadBuffer;
+	}
+
+	// Chrome / Perfetto で開けるトレース JSON を書き出す
+	bool WriteChromeTrace(const std::string& filePath);
+
+	// 空の区間を計測して 1 区間あたりのオーバーヘッド（ナノ秒）を返す
+	float MeasureZoneOverhead(uint32_t iterations = 100000);
+
+	void DrawImGui();
+
+	const std::vector<SummaryEntry>& GetLastFrameSummary() const { return summary_; }
+	float GetLastFrameMilliseconds() const { return lastFrameMilliseconds_; }
+
+private:
+	Profiler();
+	static ProfileThreadBuffer* RegisterCurrentThread();
+	float TicksToMicroseconds(uint64_t ticks) const;
+	void Calibrate();
+
+	static std::unique_ptr<Profiler> instance_;
+
+	std::mutex registryMutex_;
+	std::vector<std::unique_ptr<ProfileThreadBuffer>> buffers_;
+
+	// TSC -> 時間の換算（起動時からの経過で毎フレーム補正する）
+	uint64_t originTicks_ = 0;
+	uint64_t originNanoseconds_ = 0;
+	double ticksPerMicrosecond_ = 1000.0;
+
+	// フレーム集計（メインスレッドのみ）
+	ProfileThreadBuffer* mainBuffer_ = nullptr;
+	uint64_t frameStartIndex_ = 0;
+	uint64_t frameBeginTicks_ = 0;
+	std::vector<SummaryEntry> summary_;
+	float lastFrameMilliseconds_ = 0.0f;
+	bool isPaused_ = false;
+	float zoneOverheadNanoseconds_ = 0.0f;
+	std::string lastTracePath_;
+};
+
+// RAII の計測区間
+class ProfileZone {
+public:
+	explicit ProfileZone(const char* name) : buffer_(Profiler::GetThreadBuffer()), name_(name) {
+		depth_ = buffer_->depth++;
+		parentZone_ = buffer_->currentZone;
+		buffer_->currentZone = name;
+		begin_ = Profiler::Now();
+	}
+
+	~ProfileZone() {
+		uint64_t end = Profiler::Now();
+		uint64_t index = buffer_->writeIndex.load(std::memory_order_relaxed);
+		ProfileEvent& event = buffer_->events[index & ProfileThreadBuffer::kMask];
+		event.name = name_;
+		event.begin = begin_;
+		event.end = end;
+		event.depth = depth_;
+		buffer_->writeIndex.store(index + 1, std::memory_order_release);
+		buffer_->depth--;
+		buffer_->currentZone = parentZone_;
+	}
+
+	ProfileZone(const ProfileZone&) = delete;
+	ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+	ProfileThreadBuffer* buffer_;
+	const char* name_;
+	const char* parentZone_ = nullptr;
+	uint64_t begin_ = 0;
+	uint32_t depth_ = 0;
+};
+
+#else
+
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_FUNCTION() ((void)0)
+
+#endif // USE_PROFILER
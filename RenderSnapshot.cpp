@@ -0,0 +1,98 @@
+#include "RenderSnapshot.h"
+#include "AssetManager.h"
+#include "Profiler.h"
+
+namespace {
+	// GameScene と同じ資源キャッシュの名前
+	const char* const kBlockModelName = "base_block";
+	const char* const kPlayerModelName = "player";
+	const char* const kGoalModelName = "goal";
+	const char* const kSkydomeModelName = "skydome";
+	const char* const kTitleTextureName = "title.png";
+}
+
+SnapshotRenderer::~SnapshotRenderer() {
+	delete fadeSprite_;
+	delete titleSprite_;
+	if (!blockModel_) {
+		return;
+	}
+	AssetCache<Model*>& models = AssetManager::GetInstance().GetModels();
+	models.Release(kBlockModelName);
+	models.Release(kPlayerModelName);
+	models.Release(kGoalModelName);
+	models.Release(kSkydomeModelName);
+	AssetManager::GetInstance().GetTextures().Release(kTitleTextureName);
+}
+
+void SnapshotRenderer::Initialize() {
+	AssetCache<Model*>& models = AssetManager::GetInstance().GetModels();
+	blockModel_ = models.Acquire(kBlockModelName);
+	playerModel_ = models.Acquire(kPlayerModelName);
+	goalModel_ = models.Acquire(kGoalModelName);
+	skydomeModel_ = models.Acquire(kSkydomeModelName);
+	titleTextureHandle_ = AssetManager::GetInstance().GetTextures().Acquire(kTitleTextureName);
+
+	camera_.Initialize();
+	playerTransform_.Initialize();
+	skydomeTransform_.Initialize();
+
+	// Fade と同じ全画面の黒いスプライト
+	fadeSprite_ = Sprite::Create(0, {0, 0});
+	fadeSprite_->SetSize(Vector2(1280.0f, 720.0f));
+	fadeSprite_->SetColor(Vector4(0, 0, 0, 1.0f));
+	titleSprite_ = Sprite::Create(titleTextureHandle_, Vector2(0, 0));
+	titleSprite_->SetSize(Vector2(1280.0f, 720.0f));
+}
+
+void SnapshotRenderer::Draw(const RenderSnapshot& snapshot) {
+	PROFILE_FUNCTION();
+	Model::PreDraw();
+	if (snapshot.hasScene) {
+		camera_.matView = snapshot.matView;
+		camera_.matProjection = snapshot.matProjection;
+		camera_.TransferMatrix();
+
+		if (snapshot.hasPlayer) {
+			playerTransform_.matWorld_ = snapshot.playerMatrix;
+			playerTransform_.TransferMatrix();
+			playerModel_->Draw(playerTransform_, camera_);
+		}
+
+		while (goalTransforms_.size() < snapshot.goalMatrices.size()) {
+			goalTransforms_.push_back(std::make_unique<WorldTransform>());
+			goalTransforms_.back()->Initialize();
+		}
+		for (size_t i = 0; i < snapshot.goalMatrices.size(); ++i) {
+			goalTransforms_[i]->matWorld_ = snapshot.goalMatrices[i];
+			goalTransforms_[i]->TransferMatrix();
+			goalModel_->Draw(*goalTransforms_[i], camera_);
+		}
+
+		// GameScene::Draw と同じく、半透明の粒子より先に天球を描く
+		skydomeTransform_.matWorld_ = snapshot.skydomeMatrix;
+		skydomeTransform_.TransferMatrix();
+		skydomeModel_->Draw(skydomeTransform_, camera_);
+
+		PROFILE_SCOPE("SnapshotRenderer::Draw::Blocks");
+		instanceBatchBuilder_.Begin();
+		for (const InstanceData& instance : snapshot.blockInstances) {
+			instanceBatchBuilder_.Add(blockModel_, instance.matWorld, instance.color, instance.variant);
+		}
+		instanceBatchBuilder_.End();
+		instanceBackend_.Submit(instanceBatchBuilder_);
+	}
+	Model::PostDraw();
+
+	if (snapshot.fadeAlpha > 0.0f) {
+		fadeSprite_->SetColor(Vector4(0, 0, 0, snapshot.fadeAlpha));
+		Sprite::PreDraw(DirectXCommon::GetInstance()->GetCommandList());
+		fadeSprite_->Draw();
+		Sprite::PostDraw();
+	}
+	Sprite::PreDraw();
+	if (snapshot.isTitleVisible) {
+		titleSprite_->Draw();
+	}
+	Sprite::PostDraw();
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include "KamataEngine.h"
+#include "InstanceBatch.h"
+#include "ModelInstanceBackend.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+using namespace KamataEngine;
+
+// シミュレーションの 1 tick 分の描画内容。描画スレッドはこれだけを見て描く（ゲームの状態には触れない）。
+// ベクターはトリプルバッファのスロットごとに使い回すので、定常状態では確保しない。
+struct RenderSnapshot {
+	uint64_t tick = 0;
+	bool hasScene = false; // GameScene 以外のシーンでは false（何も描かない）
+
+	Matrix4x4 matView;
+	Matrix4x4 matProjection;
+
+	std::vector<InstanceData> blockInstances; // 可視範囲の方块
+	bool hasPlayer = false;
+	Matrix4x4 playerMatrix;
+	std::vector<Matrix4x4> goalMatrices;
+	Matrix4x4 skydomeMatrix;
+
+	float fadeAlpha = 0.0f;
+	bool isTitleVisible = false;
+
+	// 計測（steady_clock のナノ秒）
+	int64_t inputTimestamp = 0;   // この tick が使った入力を読んだ時刻
+	int64_t consumeTimestamp = 0; // シミュレーションがその入力を取り込んだ時刻
+	int64_t publishTimestamp = 0; // 公開した時刻
+	float updateMicroseconds = 0.0f;
+	float buildMicroseconds = 0.0f; // スナップショットの作成にかかった時間
+};
+
+// スナップショットを KamataEngine で描く（描画スレッド側）。
+// モデルは資源キャッシュから自分で参照を取るので、シーンの切り替えとは無関係に使える。
+class SnapshotRenderer {
+public:
+	SnapshotRenderer() = default;
+	~SnapshotRenderer();
+
+	SnapshotRenderer(const SnapshotRenderer&) = delete;
+	SnapshotRenderer& operator=(const SnapshotRenderer&) = delete;
+
+	void Initialize();
+	void Draw(const RenderSnapshot& snapshot);
+
+private:
+	Model* blockModel_ = nullptr;
+	Model* playerModel_ = nullptr;
+	Model* goalModel_ = nullptr;
+	Model* skydomeModel_ = nullptr;
+
+	Camera camera_;
+	WorldTransform playerTransform_;
+	WorldTransform skydomeTransform_;
+	// Goal の数が増えたときだけ作る
+	std::vector<std::unique_ptr<WorldTransform>> goalTransforms_;
+
+	InstanceBatchBuilder instanceBatchBuilder_;
+	ModelInstanceBackend instanceBackend_{&camera_};
+
+	Sprite* fadeSprite_ = nullptr;
+	Sprite* titleSprite_ = nullptr;
+	uint32_t titleTextureHandle_ = 0;
+};
@@ -1,4 +1,9 @@
 #include "SceneManager.h"
+#include "AssetManager.h"
+#include "LevelRegistry.h"
+#include "Profiler.h"
+#include "Logger.h"
+#include <chrono>
 
 std::unique_ptr<SceneManager> SceneManager::instance_ = nullptr;
 
@@ -20,6 +25,9 @@ void SceneManager::Destroy() {
 }
 
 void SceneManager::Init() { 
+	// 关卡清单只在启动时读取和验证一次
+	LevelRegistry::GetInstance().LoadManifest("Resources/map/levels.csv");
+
 	// 初始化时创建标题场景
 	//currentScene_ = std::make_unique<TitleScene>();
 	//currentScene_->Initialize();
@@ -33,31 +41,55 @@ void SceneManager::Init() {
 		GameScene* gameScene = dynamic_cast<GameScene*>(currentScene_.get());
 		if (gameScene) {
 			gameScene->SetMapID(nextMapID_);
+			gameScene->SetPlayerInputSource(playerInputSource_);
+			gameScene->SetDebugUIEnabled(isDebugUIEnabled_);
+			gameScene->SetFixedTimestep(isFixedTimestep_);
 		}
 		currentScene_->OnEnter();
 	}
 }
 
 void SceneManager::Update() {
+	PROFILE_FUNCTION();
 	if (currentScene_) {
 		currentScene_->Update();
 	}
+	// 长时间没有使用的资源（keep-warm 到期）在场景的线程上释放
+	AssetManager::GetInstance().Update();
+	// 释放已经完成的作废预加载
+	levelLoader_.Update();
 }
 
 void SceneManager::Draw() {
+	PROFILE_FUNCTION();
 	if (currentScene_) {
 		currentScene_->Draw();
 	}
 }
 
+void SceneManager::BuildRenderSnapshot(RenderSnapshot& snapshot) const {
+	if (GameScene* gameScene = GetGameScene()) {
+		gameScene->BuildRenderSnapshot(snapshot);
+	} else {
+		snapshot.hasScene = false;
+		snapshot.hasPlayer = false;
+		snapshot.blockInstances.clear();
+		snapshot.goalMatrices.clear();
+		snapshot.fadeAlpha = 0.0f;
+		snapshot.isTitleVisible = false;
+	}
+}
+
 void SceneManager::ChangeScene(SceneType newSceneType) { 
+	std::chrono::steady_clock::time_point changeStart = std::chrono::steady_clock::now();
+
 #ifdef _DEBUG
 	// Debug scene change
 	const char* sceneNames[] = {"None", "Title", "Game"};
-	printf("SceneManager: Changing scene from %s to %s\n", 
-		sceneNames[static_cast<int>(currentSceneType_)], 
+	LOG_DEBUG(LogCategory::kScene, "SceneManager: Changing scene from %s to %s",
+		sceneNames[static_cast<int>(currentSceneType_)],
 		sceneNames[static_cast<int>(newSceneType)]);
-	printf("SceneManager: Next Map ID: %d\n", nextMapID_);
+	LOG_DEBUG(LogCategory::kScene, "SceneManager: Next Map ID: %d", nextMapID_);
 #endif
 
 	// 退出并释放当前场景
@@ -83,9 +115,16 @@ void SceneManager::ChangeScene(SceneType newSceneType) {
 			GameScene* gameScene = dynamic_cast<GameScene*>(currentScene_.get());
 			if (gameScene) {
 				gameScene->SetMapID(nextMapID_);
-#ifdef _DEBUG
-				printf("SceneManager: Set Map ID %d for GameScene\n", nextMapID_);
-#endif
+				gameScene->SetPlayerInputSource(playerInputSource_);
+				gameScene->SetDebugUIEnabled(isDebugUIEnabled_);
+				gameScene->SetFixedTimestep(isFixedTimestep_);
+
+				// 有预加载的关卡数据就直接交给新场景
+				std::unique_ptr<LevelData> levelData = levelLoader_.Take(nextMapID_);
+				wasLastLevelPreloaded_ = levelData != nullptr;
+				lastHandoverWaitMilliseconds_ = wasLastLevelPreloaded_ ? levelLoader_.GetLastWaitMilliseconds() : 0.0f;
+				gameScene->SetPreloadedLevel(std::move(levelData));
+				LOG_DEBUG(LogCategory::kScene, "SceneManager: Set Map ID %d for GameScene", nextMapID_);
 			}
 		}
 		break;
@@ -94,6 +133,8 @@ void SceneManager::ChangeScene(SceneType newSceneType) {
 		newSceneType = SceneType::kNone;
 		break;
 	}
+	// 没有被新场景取走的预加载不再使用
+	levelLoader_.Cancel();
 	
 	// 更新当前场景类型
 	currentSceneType_ = newSceneType;
@@ -103,7 +144,10 @@ void SceneManager::ChangeScene(SceneType newSceneType) {
 		currentScene_->OnEnter();
 	}
 
-#ifdef _DEBUG
-	printf("SceneManager: Scene change completed\n");
-#endif
+	std::chrono::duration<float, std::milli> changeElapsed = std::chrono::steady_clock::now() - changeStart;
+	lastSceneChangeMilliseconds_ = changeElapsed.count();
+	sceneChangeCount_++;
+
+	LOG_DEBUG(LogCategory::kScene, "SceneManager: Scene change completed in %.2f ms (level %s, waited %.2f ms)", lastSceneChangeMilliseconds_,
+		wasLastLevelPreloaded_ ? "preloaded" : "loaded synchronously", lastHandoverWaitMilliseconds_);
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 #include "GameScene.h"
 #include "TitleScene.h"
+#include "LevelLoader.h"
 #include <memory>
 
 class SceneManager {
@@ -31,6 +32,30 @@ public:
 	void SetNextMapID(int mapID) { nextMapID_ = mapID; }
 	int GetNextMapID() const { return nextMapID_; }
 
+	// 之后创建的 GameScene 中玩家的输入来源（nullptr 时读取键盘）
+	void SetPlayerInputSource(IPlayerInputSource* inputSource) { playerInputSource_ = inputSource; }
+	// 之后创建的 GameScene 是否显示调试 UI（在模拟线程上运行时关闭）
+	void SetDebugUIEnabled(bool isEnabled) { isDebugUIEnabled_ = isEnabled; }
+	// 之后创建的 GameScene 是否按固定 tick 推进相机（模拟线程、soak 中打开）
+	void SetFixedTimestep(bool isFixed) { isFixedTimestep_ = isFixed; }
+
+	// 把当前场景的绘制内容写入快照（不是游戏场景时 hasScene = false）
+	void BuildRenderSnapshot(RenderSnapshot& snapshot) const;
+
+	// 当前的游戏场景（不是游戏场景时为 nullptr）
+	GameScene* GetGameScene() const { return currentSceneType_ == SceneType::kGame ? static_cast<GameScene*>(currentScene_.get()) : nullptr; }
+
+	// 在后台预加载关卡数据，下次切换到该关卡时直接使用
+	void PreloadLevel(int mapID) { levelLoader_.Request(mapID); }
+	// 作废还没取走的预加载（重新开始、地图热重载时，数据可能已经过时）
+	void CancelPreload() { levelLoader_.Cancel(); }
+
+	// 切换耗时统计
+	float GetLastSceneChangeMilliseconds() const { return lastSceneChangeMilliseconds_; }
+	float GetLastHandoverWaitMilliseconds() const { return lastHandoverWaitMilliseconds_; }
+	bool WasLastLevelPreloaded() const { return wasLastLevelPreloaded_; }
+	uint32_t GetSceneChangeCount() const { return sceneChangeCount_; }
+
 private:
 	SceneManager() = default; 
 	static std::unique_ptr<SceneManager> instance_;
@@ -39,4 +64,13 @@ private:
 	SceneType currentSceneType_ = SceneType::kNone; 
 
 	int nextMapID_ = 0; // Default map ID
+	IPlayerInputSource* playerInputSource_ = nullptr;
+	bool isDebugUIEnabled_ = true;
+	bool isFixedTimestep_ = false;
+
+	LevelLoader levelLoader_;
+	float lastSceneChangeMilliseconds_ = 0.0f;  // ChangeScene 整体耗时
+	float lastHandoverWaitMilliseconds_ = 0.0f; // 等待预加载完成的时间
+	bool wasLastLevelPreloaded_ = false;
+	uint32_t sceneChangeCount_ = 0;
 };
@@ -0,0 +1,163 @@
+#include "Sequence.h"
+#include "Fade.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cstdio>
+#include <new>
+
+namespace {
+	alignas(std::max_align_t) unsigned char gFrameBlocks[SequenceFramePool::kBlockCount][SequenceFramePool::kBlockSize];
+	uint32_t gUsedMask = 0;
+	uint32_t gFallbackCount = 0;
+
+	static_assert(SequenceFramePool::kBlockCount <= 32, "gUsedMask is 32 bits");
+}
+
+void* SequenceFramePool::Allocate(size_t size) {
+	if (size <= kBlockSize) {
+		for (uint32_t i = 0; i < kBlockCount; ++i) {
+			uint32_t bit = 1u << i;
+			if ((gUsedMask & bit) == 0) {
+				gUsedMask |= bit;
+				return gFrameBlocks[i];
+			}
+		}
+	}
+
+	LOG_DEBUG(LogCategory::kSequence, "SequenceFramePool: Falling back to heap for a %zu byte frame", size);
+	gFallbackCount++;
+	return ::operator new(size);
+}
+
+void SequenceFramePool::Deallocate(void* ptr) {
+	unsigned char* bytes = static_cast<unsigned char*>(ptr);
+	unsigned char* begin = &gFrameBlocks[0][0];
+	unsigned char* end = begin + sizeof(gFrameBlocks);
+	if (bytes >= begin && bytes < end) {
+		uint32_t index = static_cast<uint32_t>((bytes - begin) / kBlockSize);
+		gUsedMask &= ~(1u << index);
+		return;
+	}
+	::operator delete(ptr);
+}
+
+uint32_t SequenceFramePool::GetUsedCount() {
+	uint32_t count = 0;
+	for (uint32_t mask = gUsedMask; mask != 0; mask &= mask - 1) {
+		count++;
+	}
+	return count;
+}
+
+uint32_t SequenceFramePool::GetFallbackCount() { return gFallbackCount; }
+
+Sequence::promise_type::~promise_type() {
+	// 破棄されたシーケンスのタイマーが後から発火しないように
+	if (isWaitingTimer && runner && runner->GetTimerWheel()) {
+		runner->GetTimerWheel()->Cancel(timer);
+	}
+}
+
+Sequence& Sequence::operator=(Sequence&& other) noexcept {
+	if (this != &other) {
+		if (handle_) {
+			handle_.destroy();
+		}
+		handle_ = other.handle_;
+		other.handle_ = nullptr;
+	}
+	return *this;
+}
+
+Sequence::~Sequence() {
+	if (handle_) {
+		handle_.destroy();
+	}
+}
+
+bool WaitSeconds::await_suspend(Sequence::Handle handle) {
+	Sequence::promise_type& promise = handle.promise();
+	TimerWheel* timerWheel = promise.runner ? promise.runner->GetTimerWheel() : nullptr;
+	if (!timerWheel) {
+		// タイマーがなければ待たずに続行
+		return false;
+	}
+	promise.isWaitingTimer = true;
+	promise.timer = timerWheel->ScheduleSeconds(seconds_, &WaitSeconds::OnTimeout, &promise);
+	return true;
+}
+
+void WaitSeconds::OnTimeout(void* context) {
+	static_cast<Sequence::promise_type*>(context)->isWaitingTimer = false;
+}
+
+bool WaitFade::await_ready() const { return fade_->isFinished(); }
+
+void WaitFade::await_suspend(Sequence::Handle handle) {
+	const Fade* fade = fade_;
+	handle.promise().condition = [fade]() { return fade->isFinished(); };
+}
+
+SequenceRunner::SequenceRunner(TimerWheel* timerWheel) : timerWheel_(timerWheel) {
+	active_.reserve(8);
+	pending_.reserve(8);
+}
+
+void SequenceRunner::Start(Sequence sequence) {
+	if (!sequence.IsValid()) {
+		return;
+	}
+	sequence.GetHandle().promise().runner = this;
+	if (isTicking_) {
+		pending_.push_back(std::move(sequence));
+	} else {
+		active_.push_back(std::move(sequence));
+	}
+}
+
+void SequenceRunner::StopAll() {
+	pending_.clear();
+	if (isTicking_) {
+		isStopRequested_ = true;
+	} else {
+		active_.clear();
+	}
+}
+
+void SequenceRunner::Tick() {
+	isTicking_ = true;
+	lastResumeCount_ = 0;
+
+	for (size_t i = 0; i < active_.size(); ++i) {
+		Sequence::promise_type& promise = active_[i].GetHandle().promise();
+		if (active_[i].IsDone() || promise.isWaitingTimer) {
+			continue;
+		}
+		if (promise.condition) {
+			if (!promise.condition()) {
+				continue;
+			}
+			promise.condition = nullptr;
+		}
+
+		active_[i].GetHandle().resume();
+		lastResumeCount_++;
+		if (isStopRequested_) {
+			break;
+		}
+	}
+
+	isTicking_ = false;
+	if (isStopRequested_) {
+		isStopRequested_ = false;
+		active_.clear();
+	} else {
+		active_.erase(std::remove_if(active_.begin(), active_.end(), [](const Sequence& sequence) { return sequence.IsDone(); }), active_.end());
+	}
+
+	// Tick 中に開始されたものは次の Tick から
+	for (Sequence& sequence : pending_) {
+		active_.push_back(std::move(sequence));
+	}
+	pending_.clear();
+}
@@ -0,0 +1,138 @@
+#pragma once
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <vector>
+#include "Delegate.h"
+#include "TimerWheel.h"
+
+class Fade;
+class SequenceRunner;
+
+// コルーチンフレーム用の固定ブロックプール（メインスレッド専用）。
+// ブロックに収まらない/使い切った場合だけ通常の new にフォールバックする。
+class SequenceFramePool {
+public:
+	static constexpr size_t kBlockSize = 1024;
+	static constexpr uint32_t kBlockCount = 16;
+
+	static void* Allocate(size_t size);
+	static void Deallocate(void* ptr);
+
+	static uint32_t GetUsedCount();
+	static uint32_t GetFallbackCount();
+};
+
+// ゲームの tick で再開されるコルーチン（ステージ遷移などの一連の流れを書く）。
+// co_await できるのは WaitSeconds / WaitFade / WaitUntil / WaitNextTick。
+class Sequence {
+public:
+	struct promise_type {
+		~promise_type();
+
+		Sequence get_return_object() { return Sequence(std::coroutine_handle<promise_type>::from_promise(*this)); }
+		// 最初の再開は SequenceRunner::Tick から
+		std::suspend_always initial_suspend() noexcept { return {}; }
+		std::suspend_always final_suspend() noexcept { return {}; }
+		void return_void() {}
+		void unhandled_exception() { std::terminate(); }
+
+		static void* operator new(size_t size) { return SequenceFramePool::Allocate(size); }
+		static void operator delete(void* ptr) { SequenceFramePool::Deallocate(ptr); }
+
+		SequenceRunner* runner = nullptr;
+		// 待機条件：条件が設定されていれば tick ごとに 1 回だけ評価する
+		Delegate<bool()> condition;
+		// タイマー待ち：期限が来るとコールバックでフラグを下ろす（ポーリングしない）
+		TimerHandle timer;
+		bool isWaitingTimer = false;
+	};
+
+	using Handle = std::coroutine_handle<promise_type>;
+
+	Sequence() = default;
+	explicit Sequence(Handle handle) : handle_(handle) {}
+	Sequence(const Sequence&) = delete;
+	Sequence& operator=(const Sequence&) = delete;
+	Sequence(Sequence&& other) noexcept : handle_(other.handle_) { other.handle_ = nullptr; }
+	Sequence& operator=(Sequence&& other) noexcept;
+	~Sequence();
+
+	bool IsValid() const { return static_cast<bool>(handle_); }
+	bool IsDone() const { return !handle_ || handle_.done(); }
+	Handle GetHandle() const { return handle_; }
+
+private:
+	Handle handle_ = nullptr;
+};
+
+// 指定秒数待つ（TimerWheel に期限を登録する）
+struct WaitSeconds {
+	explicit WaitSeconds(float seconds) : seconds_(seconds) {}
+
+	bool await_ready() const noexcept { return seconds_ <= 0.0f; }
+	bool await_suspend(Sequence::Handle handle);
+	void await_resume() const noexcept {}
+
+private:
+	static void OnTimeout(void* context);
+	float seconds_ = 0.0f;
+};
+
+// 条件が true になるまで待つ
+struct WaitUntil {
+	explicit WaitUntil(Delegate<bool()> condition) : condition_(std::move(condition)) {}
+
+	bool await_ready() { return condition_ && condition_(); }
+	void await_suspend(Sequence::Handle handle) { handle.promise().condition = std::move(condition_); }
+	void await_resume() const noexcept {}
+
+private:
+	Delegate<bool()> condition_;
+};
+
+// フェードが終わるまで待つ
+struct WaitFade {
+	explicit WaitFade(const Fade& fade) : fade_(&fade) {}
+
+	bool await_ready() const;
+	void await_suspend(Sequence::Handle handle);
+	void await_resume() const noexcept {}
+
+private:
+	const Fade* fade_ = nullptr;
+};
+
+// 次の tick まで待つ
+struct WaitNextTick {
+	bool await_ready() const noexcept { return false; }
+	void await_suspend(Sequence::Handle) const noexcept {}
+	void await_resume() const noexcept {}
+};
+
+// 実行中のシーケンスを tick ごとに再開する。
+// 待機中のシーケンスは条件の評価 1 回かフラグの確認だけで済む。
+class SequenceRunner {
+public:
+	explicit SequenceRunner(TimerWheel* timerWheel);
+	~SequenceRunner() = default;
+
+	// 次の Tick から実行する（Tick 中に呼んでもよい）
+	void Start(Sequence sequence);
+	// 全て破棄する。Tick 中に呼ばれた場合は今の再開が戻ってから破棄する
+	void StopAll();
+	void Tick();
+
+	TimerWheel* GetTimerWheel() const { return timerWheel_; }
+	uint32_t GetActiveCount() const { return static_cast<uint32_t>(active_.size() + pending_.size()); }
+	uint32_t GetLastResumeCount() const { return lastResumeCount_; }
+
+private:
+	TimerWheel* timerWheel_ = nullptr;
+	std::vector<Sequence> active_;
+	std::vector<Sequence> pending_;
+	bool isTicking_ = false;
+	bool isStopRequested_ = false;
+	uint32_t lastResumeCount_ = 0;
+};
@@ -0,0 +1,132 @@
+#include "SimulationThread.h"
+#include "JobSystem.h"
+#include "KamataEngine.h"
+#include "Logger.h"
+#include "SceneManager.h"
+#include <algorithm>
+#include <chrono>
+using namespace KamataEngine;
+
+namespace {
+	// 遅れがこれ以上たまったら追いつくのをやめて基準を取り直す
+	constexpr int32_t kMaxTicksBehind = 4;
+
+#ifdef USE_IMGUI
+	float Average(const float* values, uint32_t count) {
+		float sum = 0.0f;
+		for (uint32_t i = 0; i < count; ++i) {
+			sum += values[i];
+		}
+		return count > 0 ? sum / static_cast<float>(count) : 0.0f;
+	}
+#endif
+}
+
+SimulationThread::~SimulationThread() { Stop(); }
+
+int64_t SimulationThread::GetTimestamp() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void SimulationThread::Start(uint32_t jobThreadCount, bool isPaced, TickFunction tick) {
+	Stop();
+	tick_ = std::move(tick);
+	isStopRequested_.store(false, std::memory_order_relaxed);
+	isFinished_.store(false, std::memory_order_relaxed);
+	thread_ = std::thread(&SimulationThread::ThreadMain, this, jobThreadCount, isPaced);
+}
+
+void SimulationThread::Stop() {
+	if (!thread_.joinable()) {
+		return;
+	}
+	isStopRequested_.store(true, std::memory_order_release);
+	thread_.join();
+}
+
+void SimulationThread::ThreadMain(uint32_t jobThreadCount, bool isPaced) {
+	// このスレッドを 0 番としてジョブシステムを作り直す
+	JobSystem::Initialize(jobThreadCount);
+	LOG_INFO(LogCategory::kScene, "SimulationThread: Started (%u job threads, %s)", JobSystem::GetInstance().GetThreadCount(),
+	         isPaced ? "paced" : "unpaced");
+
+	const std::chrono::nanoseconds period(static_cast<int64_t>(1.0e9 / kTicksPerSecond));
+	std::chrono::steady_clock::time_point nextTick = std::chrono::steady_clock::now();
+	while (!isStopRequested_.load(std::memory_order_acquire)) {
+		if (isPaced) {
+			std::this_thread::sleep_until(nextTick);
+			nextTick += period;
+			std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+			if (now - nextTick > period * kMaxTicksBehind) {
+				nextTick = now;
+			}
+		}
+
+		std::chrono::steady_clock::time_point tickStart = std::chrono::steady_clock::now();
+		bool isContinued = tick_();
+		std::chrono::steady_clock::time_point updateEnd = std::chrono::steady_clock::now();
+
+		RenderSnapshot& snapshot = buffer_.GetWriteBuffer();
+		SceneManager::GetInstance().BuildRenderSnapshot(snapshot);
+		std::chrono::steady_clock::time_point buildEnd = std::chrono::steady_clock::now();
+
+		snapshot.tick = ++tickCount_;
+		snapshot.updateMicroseconds = std::chrono::duration<float, std::micro>(updateEnd - tickStart).count();
+		snapshot.buildMicroseconds = std::chrono::duration<float, std::micro>(buildEnd - updateEnd).count();
+		// 入力が渡されていなければ tick の開始時刻を入力の時刻とみなす
+		const int64_t tickStartTimestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(tickStart.time_since_epoch()).count();
+		int64_t inputTimestamp = inputSource_.GetPolledTimestamp();
+		snapshot.inputTimestamp = inputTimestamp != 0 ? inputTimestamp : tickStartTimestamp;
+		// この tick で Poll されなかった（GameScene 以外）なら tick の開始時刻を取り込んだ時刻とみなす
+		snapshot.consumeTimestamp = std::max(inputSource_.GetLastPollTimestamp(), tickStartTimestamp);
+		snapshot.publishTimestamp = GetTimestamp();
+		buffer_.Publish();
+
+		if (!isContinued) {
+			break;
+		}
+	}
+
+	LOG_INFO(LogCategory::kScene, "SimulationThread: Stopped after %llu ticks", static_cast<unsigned long long>(tickCount_));
+	// シーンのジョブが残っていないので、ここでワーカーを止める
+	JobSystem::Destroy();
+	isFinished_.store(true, std::memory_order_release);
+}
+
+bool SimulationThread::AcquireSnapshot() {
+	if (!buffer_.Acquire()) {
+		return false;
+	}
+	const RenderSnapshot& snapshot = buffer_.GetReadBuffer();
+	if (snapshot.tick <= lastTick_) {
+		orderErrorCount_++;
+	}
+	lastTick_ = snapshot.tick;
+	consumedCount_++;
+
+	lastInputToAcquireMilliseconds_ = static_cast<float>(GetTimestamp() - snapshot.inputTimestamp) * 1.0e-6f;
+	inputToPublishHistory_[historyIndex_] = static_cast<float>(snapshot.publishTimestamp - snapshot.inputTimestamp) * 1.0e-6f;
+	inputToAcquireHistory_[historyIndex_] = lastInputToAcquireMilliseconds_;
+	buildHistory_[historyIndex_] = snapshot.buildMicroseconds;
+	historyIndex_ = (historyIndex_ + 1) % kHistorySize;
+	return true;
+}
+
+void SimulationThread::DrawImGui() {
+#ifdef USE_IMGUI
+	ImGui::Begin("Simulation Thread");
+	const uint32_t count = static_cast<uint32_t>(std::min<uint64_t>(consumedCount_, kHistorySize));
+	ImGui::Text("Tick %llu, published %llu, consumed %llu, overwritten %llu", static_cast<unsigned long long>(lastTick_),
+	            static_cast<unsigned long long>(GetPublishedCount()), static_cast<unsigned long long>(consumedCount_),
+	            static_cast<unsigned long long>(GetOverwrittenCount()));
+	ImGui::Text("Input -> publish: %.3f ms avg", Average(inputToPublishHistory_, count));
+	ImGui::Text("Input -> acquire: %.3f ms avg", Average(inputToAcquireHistory_, count));
+	ImGui::Text("Snapshot build: %.1f us avg (update %.1f us)", Average(buildHistory_, count), GetSnapshot().updateMicroseconds);
+	ImGui::PlotLines("Input -> acquire (ms)", inputToAcquireHistory_, static_cast<int>(kHistorySize), static_cast<int>(historyIndex_), nullptr, 0.0f, 50.0f,
+	                 ImVec2(0, 60));
+	if (orderErrorCount_ > 0) {
+		ImGui::TextColored(ImVec4(1, 0.3f, 0.3f, 1), "Out-of-order snapshots: %llu", static_cast<unsigned long long>(orderErrorCount_));
+	}
+	ImGui::End();
+#endif
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include "Delegate.h"
+#include "PlayerInput.h"
+#include "RenderSnapshot.h"
+#include "TripleBuffer.h"
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+// シミュレーションを専用スレッドで固定レートで回し、tick ごとに RenderSnapshot をトリプルバッファで公開する（起動引数 -threaded）。
+// 描画スレッド（メインスレッド）はスナップショットだけを読み、シーンには触れない。
+//   simulation.Start(0, true, [] { SceneManager::GetInstance().Update(); return true; });
+//   毎フレーム: simulation.GetInputSource().Latch(...); if (simulation.AcquireSnapshot()) { renderer.Draw(simulation.GetSnapshot()); }
+// ジョブシステムはシミュレーションスレッドが作り直して所有する（そのスレッドが 0 番になる）。
+class SimulationThread {
+public:
+	// false を返すとシミュレーションを終える（Delegate なので捕獲は参照かポインタにする）
+	using TickFunction = Delegate<bool()>;
+
+	static constexpr float kTicksPerSecond = 60.0f;
+
+	SimulationThread() = default;
+	~SimulationThread();
+
+	SimulationThread(const SimulationThread&) = delete;
+	SimulationThread& operator=(const SimulationThread&) = delete;
+
+	// isPaced が false なら待たずに回す（ソークテスト用）
+	void Start(uint32_t jobThreadCount, bool isPaced, TickFunction tick);
+	void Stop();
+	// tick 関数が false を返して終わった
+	bool IsFinished() const { return isFinished_.load(std::memory_order_acquire); }
+
+	// メインスレッドが入力を渡す先（シーンの入力元に設定する）
+	LatchedInputSource& GetInputSource() { return inputSource_; }
+
+	// --- 描画スレッド側 ---
+	// 新しいスナップショットがあれば受け取って true（計測も更新する）
+	bool AcquireSnapshot();
+	const RenderSnapshot& GetSnapshot() const { return buffer_.GetReadBuffer(); }
+
+	uint64_t GetPublishedCount() const { return buffer_.GetPublishedCount(); }
+	uint64_t GetOverwrittenCount() const { return buffer_.GetOverwrittenCount(); }
+	uint64_t GetConsumedCount() const { return consumedCount_; }
+	// tick 番号が増えていなかったスナップショットの数（0 であるべき）
+	uint64_t GetOrderErrorCount() const { return orderErrorCount_; }
+	// 受け取った時点での 入力 → 受け取り の時間
+	float GetLastInputToAcquireMilliseconds() const { return lastInputToAcquireMilliseconds_; }
+
+	void DrawImGui();
+
+	// steady_clock のナノ秒（スナップショットの時刻と同じ基準）
+	static int64_t GetTimestamp();
+
+private:
+	void ThreadMain(uint32_t jobThreadCount, bool isPaced);
+
+	std::thread thread_;
+	TickFunction tick_;
+	std::atomic<bool> isStopRequested_{false};
+	std::atomic<bool> isFinished_{false};
+
+	LatchedInputSource inputSource_;
+	TripleBuffer<RenderSnapshot> buffer_;
+	uint64_t tickCount_ = 0; // シミュレーションスレッドのみ
+
+	// 以下は描画スレッドのみ
+	uint64_t consumedCount_ = 0;
+	uint64_t orderErrorCount_ = 0;
+	uint64_t lastTick_ = 0;
+	float lastInputToAcquireMilliseconds_ = 0.0f;
+
+	// ImGui 用の直近の値
+	static constexpr uint32_t kHistorySize = 256;
+	float inputToPublishHistory_[kHistorySize] = {};
+	float inputToAcquireHistory_[kHistorySize] = {};
+	float buildHistory_[kHistorySize] = {};
+	uint32_t historyIndex_ = 0;
+};
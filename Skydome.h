@@ -6,6 +6,8 @@ public:
 	Skydome() = default;
 	~Skydome() = default;
 	void Update() override;
+	// 最後の Update で計算したワールド行列（描画スナップショット用）
+	const Matrix4x4& GetWorldMatrix() const { return worldTransform_.matWorld_; }
 
 private:
 };
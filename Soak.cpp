@@ -0,0 +1,368 @@
+#include "Soak.h"
+#include "AllocTracker.h"
+#include "KamataEngine.h"
+#include "Logger.h"
+#include "PlayerInput.h"
+#include "SceneManager.h"
+#include "SimulationThread.h"
+#include <Psapi.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <thread>
+using namespace KamataEngine;
+
+namespace {
+	constexpr float kTicksPerSecond = 60.0f;
+
+	struct MemorySample {
+		uint64_t workingSet = 0;
+		uint64_t peakWorkingSet = 0;
+	};
+
+	MemorySample SampleMemory() {
+		MemorySample sample;
+		PROCESS_MEMORY_COUNTERS counters = {};
+		if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+			sample.workingSet = counters.WorkingSetSize;
+			sample.peakWorkingSet = counters.PeakWorkingSetSize;
+		}
+		return sample;
+	}
+
+	// ひたすら右へ進みながら一定間隔でジャンプする
+	std::vector<PlayerInputState> MakeDefaultScript() {
+		std::vector<PlayerInputState> script(120);
+		for (size_t i = 0; i < script.size(); ++i) {
+			script[i].right = true;
+			script[i].jumpTriggered = i % 40 == 0;
+		}
+		return script;
+	}
+
+	// ソート済みの tick 時間から割合 p の値
+	float Percentile(const std::vector<float>& sorted, double p) {
+		if (sorted.empty()) {
+			return 0.0f;
+		}
+		size_t index = std::min(sorted.size() - 1, static_cast<size_t>(p * static_cast<double>(sorted.size())));
+		return sorted[index];
+	}
+
+	// ベースライン JSON から "key": 数値 を読む（無ければ負の値）
+	double ReadBaselineNumber(const std::string& text, const char* key) {
+		std::string pattern = std::string("\"") + key + "\":";
+		size_t position = text.find(pattern);
+		if (position == std::string::npos) {
+			return -1.0;
+		}
+		return std::strtod(text.c_str() + position + pattern.size(), nullptr);
+	}
+
+	void WriteNumber(std::ofstream& file, const char* key, double value) {
+		char number[64];
+		snprintf(number, sizeof(number), "%.4f", value);
+		file << "  \"" << key << "\": " << number << ",\n";
+	}
+
+	void WriteInteger(std::ofstream& file, const char* key, uint64_t value) { file << "  \"" << key << "\": " << value << ",\n"; }
+
+	// 受け取ったスナップショットが壊れていないか（順序は SimulationThread が数える）
+	bool IsSnapshotValid(const RenderSnapshot& snapshot) {
+		if (snapshot.publishTimestamp < snapshot.inputTimestamp) {
+			return false;
+		}
+		if (snapshot.hasPlayer && !std::isfinite(snapshot.playerMatrix.m[3][0] + snapshot.playerMatrix.m[3][1])) {
+			return false;
+		}
+		return !snapshot.hasScene || !snapshot.blockInstances.empty();
+	}
+}
+
+bool Soak::ParseArguments(const std::vector<std::string>& arguments, Config& config) {
+	bool isRequested = false;
+	for (size_t i = 0; i < arguments.size(); ++i) {
+		const std::string& argument = arguments[i];
+		bool hasValue = i + 1 < arguments.size() && arguments[i + 1][0] != '-';
+		if (argument == "-soak") {
+			isRequested = true;
+			if (hasValue) {
+				config.minutes = std::strtof(arguments[++i].c_str(), nullptr);
+			}
+		} else if (argument == "-level" && hasValue) {
+			config.levelID = static_cast<int>(std::strtol(arguments[++i].c_str(), nullptr, 10));
+		} else if (argument == "-input" && hasValue) {
+			config.isRandomInput = arguments[++i] == "random";
+		} else if (argument == "-seed" && hasValue) {
+			config.seed = static_cast<uint32_t>(std::strtoul(arguments[++i].c_str(), nullptr, 10));
+		} else if (argument == "-out" && hasValue) {
+			config.outputPath = arguments[++i];
+		} else if (argument == "-baseline" && hasValue) {
+			config.baselinePath = arguments[++i];
+		} else if (argument == "-tolerance" && hasValue) {
+			config.tolerance = std::strtof(arguments[++i].c_str(), nullptr);
+		} else if (argument == "-threaded") {
+			config.isThreaded = true;
+		}
+	}
+	return isRequested;
+}
+
+int Soak::Run(const Config& config) {
+	ScriptedInputSource scriptedInput(MakeDefaultScript());
+	RandomInputSource randomInput(config.seed);
+
+	SceneManager& sceneManager = SceneManager::GetInstance();
+	sceneManager.SetPlayerInputSource(config.isRandomInput ? static_cast<IPlayerInputSource*>(&randomInput) : &scriptedInput);
+	sceneManager.SetNextMapID(config.levelID);
+	// シミュレーションスレッドではシーンの ImGui を使えない
+	sceneManager.SetDebugUIEnabled(!config.isThreaded);
+	// 待たずに回すので、カメラも実時間ではなく tick の時間で進める
+	sceneManager.SetFixedTimestep(true);
+	sceneManager.Init();
+
+	ImGuiManager* imguiManager = ImGuiManager::GetInstance();
+	const uint64_t tickCount = static_cast<uint64_t>(std::max(config.minutes, 0.0f) * 60.0f * kTicksPerSecond);
+	std::vector<float> tickMilliseconds;
+	tickMilliseconds.reserve(static_cast<size_t>(tickCount));
+
+	MemorySample startMemory = SampleMemory();
+	uint64_t deaths = 0;
+	uint64_t sceneChanges = 0;
+	std::vector<int> levelsVisited = {config.levelID};
+	uint32_t lastSceneChangeCount = sceneManager.GetSceneChangeCount();
+	uint32_t lastRestartCount = 0;
+#ifdef USE_ALLOC_TRACKER
+	uint64_t allocations = 0;
+	uint64_t ticksWithAllocations = 0;
+	uint64_t maxAllocationsPerTick = 0;
+#endif
+
+	LOG_INFO(LogCategory::kGeneral, "Soak: level %d, %s input, %.1f minutes (%llu ticks)", config.levelID, config.isRandomInput ? "random" : "scripted", config.minutes,
+	         static_cast<unsigned long long>(tickCount));
+
+	// 1 tick 分（-threaded ではシミュレーションスレッドで呼ばれる）
+	auto simulateTick = [&](uint64_t tick) {
+#ifdef USE_ALLOC_TRACKER
+		uint64_t allocationStart = AllocTracker::GetThreadAllocationCount();
+#endif
+		std::chrono::steady_clock::time_point tickStart = std::chrono::steady_clock::now();
+		sceneManager.Update();
+		std::chrono::duration<float, std::milli> tickElapsed = std::chrono::steady_clock::now() - tickStart;
+#ifdef USE_ALLOC_TRACKER
+		uint64_t tickAllocations = AllocTracker::GetThreadAllocationCount() - allocationStart;
+		allocations += tickAllocations;
+		ticksWithAllocations += tickAllocations > 0 ? 1 : 0;
+		maxAllocationsPerTick = std::max(maxAllocationsPerTick, tickAllocations);
+#endif
+		tickMilliseconds.push_back(tickElapsed.count());
+
+		// 関卡切り替え（ゴール）と死亡後の重開を数える
+		if (sceneManager.GetSceneChangeCount() != lastSceneChangeCount) {
+			sceneChanges += sceneManager.GetSceneChangeCount() - lastSceneChangeCount;
+			lastSceneChangeCount = sceneManager.GetSceneChangeCount();
+			lastRestartCount = 0;
+			GameScene* gameScene = sceneManager.GetGameScene();
+			if (gameScene && std::find(levelsVisited.begin(), levelsVisited.end(), gameScene->GetMapID()) == levelsVisited.end()) {
+				levelsVisited.push_back(gameScene->GetMapID());
+			}
+		}
+		if (GameScene* gameScene = sceneManager.GetGameScene()) {
+			deaths += gameScene->GetRestartCount() - lastRestartCount;
+			lastRestartCount = gameScene->GetRestartCount();
+		}
+
+		if ((tick + 1) % static_cast<uint64_t>(60.0f * kTicksPerSecond) == 0) {
+			LOG_INFO(LogCategory::kGeneral, "Soak: %llu / %llu ticks, %llu deaths, %llu scene changes, %.1f MB", static_cast<unsigned long long>(tick + 1),
+			         static_cast<unsigned long long>(tickCount), static_cast<unsigned long long>(deaths), static_cast<unsigned long long>(sceneChanges),
+			         static_cast<double>(SampleMemory().workingSet) / (1024.0 * 1024.0));
+		}
+	};
+
+	bool isAborted = false;
+	uint64_t snapshotErrors = 0;
+	std::vector<float> snapshotBuildMicroseconds;
+	std::vector<float> inputToSnapshotMilliseconds;
+	SimulationThread simulation;
+	std::chrono::steady_clock::time_point wallStart = std::chrono::steady_clock::now();
+	if (config.isThreaded && tickCount > 0) {
+		// シミュレーションスレッドは待たずに回し、メインスレッドは描画スレッドの代わりにスナップショットを受け取って確かめる
+		snapshotBuildMicroseconds.reserve(static_cast<size_t>(tickCount));
+		inputToSnapshotMilliseconds.reserve(static_cast<size_t>(tickCount));
+		uint64_t simulatedTicks = 0;
+		simulation.Start(config.jobThreadCount, false, [&] {
+			simulateTick(simulatedTicks);
+			return ++simulatedTicks < tickCount;
+		});
+		bool isFinished = false;
+		while (!isFinished) {
+			// 終わった後にもう一度受け取って、最後のスナップショットも数える
+			isFinished = simulation.IsFinished();
+			if (!isFinished && KamataEngine::Update()) {
+				isAborted = true;
+				break;
+			}
+			if (simulation.AcquireSnapshot()) {
+				const RenderSnapshot& snapshot = simulation.GetSnapshot();
+				snapshotErrors += IsSnapshotValid(snapshot) ? 0 : 1;
+				snapshotBuildMicroseconds.push_back(snapshot.buildMicroseconds);
+				inputToSnapshotMilliseconds.push_back(static_cast<float>(snapshot.publishTimestamp - snapshot.inputTimestamp) * 1.0e-6f);
+			} else {
+				std::this_thread::yield();
+			}
+		}
+		simulation.Stop();
+		snapshotErrors += simulation.GetOrderErrorCount();
+	} else {
+		for (uint64_t tick = 0; tick < tickCount; ++tick) {
+			if (KamataEngine::Update()) {
+				isAborted = true;
+				break;
+			}
+			// シーンの _DEBUG 用 ImGui があるので受付だけは行う（描画はしない）
+			imguiManager->Begin();
+			simulateTick(tick);
+			imguiManager->End();
+		}
+	}
+	std::chrono::duration<double> wallElapsed = std::chrono::steady_clock::now() - wallStart;
+	MemorySample endMemory = SampleMemory();
+
+	// --- 集計 ---
+	std::vector<float> sorted = tickMilliseconds;
+	std::sort(sorted.begin(), sorted.end());
+	double totalMilliseconds = 0.0;
+	for (float value : sorted) {
+		totalMilliseconds += value;
+	}
+	const float p50 = Percentile(sorted, 0.5);
+	const float p99 = Percentile(sorted, 0.99);
+	const float p999 = Percentile(sorted, 0.999);
+	const float maxTick = sorted.empty() ? 0.0f : sorted.back();
+	const double meanTick = sorted.empty() ? 0.0 : totalMilliseconds / static_cast<double>(sorted.size());
+
+	LOG_INFO(LogCategory::kGeneral, "Soak: %zu ticks in %.1f s, tick p50 %.3f ms, p99 %.3f ms, p99.9 %.3f ms, max %.3f ms", sorted.size(), wallElapsed.count(), p50, p99, p999,
+	         maxTick);
+	std::sort(snapshotBuildMicroseconds.begin(), snapshotBuildMicroseconds.end());
+	std::sort(inputToSnapshotMilliseconds.begin(), inputToSnapshotMilliseconds.end());
+	if (config.isThreaded) {
+		LOG_INFO(LogCategory::kGeneral, "Soak: %llu snapshots published, %zu consumed, build p50 %.1f us, p99 %.1f us, input -> snapshot p99 %.3f ms, %llu errors",
+		         static_cast<unsigned long long>(simulation.GetPublishedCount()), snapshotBuildMicroseconds.size(), Percentile(snapshotBuildMicroseconds, 0.5),
+		         Percentile(snapshotBuildMicroseconds, 0.99), Percentile(inputToSnapshotMilliseconds, 0.99), static_cast<unsigned long long>(snapshotErrors));
+	}
+	LOG_INFO(LogCategory::kGeneral, "Soak: peak RSS %.1f MB (start %.1f MB, end %.1f MB), %llu deaths, %llu scene changes",
+	         static_cast<double>(endMemory.peakWorkingSet) / (1024.0 * 1024.0), static_cast<double>(startMemory.workingSet) / (1024.0 * 1024.0),
+	         static_cast<double>(endMemory.workingSet) / (1024.0 * 1024.0), static_cast<unsigned long long>(deaths), static_cast<unsigned long long>(sceneChanges));
+
+	// --- JSON ---
+	std::ofstream file(config.outputPath);
+	if (!file.is_open()) {
+		LOG_ERROR(LogCategory::kGeneral, "Soak: Failed to write %s", config.outputPath.c_str());
+		return 1;
+	}
+#if defined(_DEBUG)
+	const char* configuration = "Debug";
+#elif defined(USE_IMGUI)
+	const char* configuration = "Develop";
+#else
+	const char* configuration = "Release";
+#endif
+	file << "{\n  \"configuration\": \"" << configuration << "\",\n";
+	file << "  \"level\": " << config.levelID << ",\n";
+	file << "  \"input\": \"" << (config.isRandomInput ? "random" : "scripted") << "\",\n";
+	WriteInteger(file, "seed", config.seed);
+	file << "  \"aborted\": " << (isAborted ? "true" : "false") << ",\n";
+	WriteInteger(file, "ticks", sorted.size());
+	WriteNumber(file, "wall_seconds", wallElapsed.count());
+	WriteNumber(file, "tick_mean_ms", meanTick);
+	WriteNumber(file, "tick_p50_ms", p50);
+	WriteNumber(file, "tick_p99_ms", p99);
+	WriteNumber(file, "tick_p999_ms", p999);
+	WriteNumber(file, "tick_max_ms", maxTick);
+	WriteInteger(file, "start_rss_bytes", startMemory.workingSet);
+	WriteInteger(file, "end_rss_bytes", endMemory.workingSet);
+	WriteInteger(file, "peak_rss_bytes", endMemory.peakWorkingSet);
+#ifdef USE_ALLOC_TRACKER
+	WriteInteger(file, "allocations", allocations);
+	WriteInteger(file, "ticks_with_allocations", ticksWithAllocations);
+	WriteInteger(file, "max_allocations_per_tick", maxAllocationsPerTick);
+#else
+	file << "  \"allocations\": null,\n";
+#endif
+	file << "  \"threaded\": " << (config.isThreaded ? "true" : "false") << ",\n";
+	if (config.isThreaded) {
+		WriteInteger(file, "snapshots_published", simulation.GetPublishedCount());
+		WriteInteger(file, "snapshots_consumed", simulation.GetConsumedCount());
+		WriteInteger(file, "snapshots_overwritten", simulation.GetOverwrittenCount());
+		WriteNumber(file, "snapshot_build_p50_us", Percentile(snapshotBuildMicroseconds, 0.5));
+		WriteNumber(file, "snapshot_build_p99_us", Percentile(snapshotBuildMicroseconds, 0.99));
+		WriteNumber(file, "input_to_snapshot_p50_ms", Percentile(inputToSnapshotMilliseconds, 0.5));
+		WriteNumber(file, "input_to_snapshot_p99_ms", Percentile(inputToSnapshotMilliseconds, 0.99));
+		WriteInteger(file, "snapshot_errors", snapshotErrors);
+	}
+	WriteInteger(file, "deaths", deaths);
+	WriteInteger(file, "scene_changes", sceneChanges);
+	file << "  \"levels_visited\": [";
+	for (size_t i = 0; i < levelsVisited.size(); ++i) {
+		file << (i > 0 ? ", " : "") << levelsVisited[i];
+	}
+	file << "]\n}\n";
+	if (!file.good()) {
+		return 1;
+	}
+	file.close();
+
+	int exitCode = 0;
+	if (snapshotErrors > 0) {
+		LOG_ERROR(LogCategory::kGeneral, "Soak: %llu invalid snapshots", static_cast<unsigned long long>(snapshotErrors));
+		exitCode = 1;
+	}
+#ifdef USE_ALLOC_TRACKER
+	// -alloc-check と併用したとき、定常状態の tick で確保があれば失敗にする
+	if (AllocTracker::HasSteadyStateFailure()) {
+		LOG_ERROR(LogCategory::kGeneral, "Soak: Steady-state allocation check failed");
+		exitCode = 1;
+	}
+#endif
+
+	// --- ベースラインとの比較 ---
+	if (config.baselinePath.empty()) {
+		return exitCode;
+	}
+	std::ifstream baselineFile(config.baselinePath);
+	if (!baselineFile.is_open()) {
+		LOG_ERROR(LogCategory::kGeneral, "Soak: Baseline %s not found", config.baselinePath.c_str());
+		return 1;
+	}
+	std::stringstream baselineStream;
+	baselineStream << baselineFile.rdbuf();
+	const std::string baseline = baselineStream.str();
+
+	struct Metric {
+		const char* key;
+		double value;
+	};
+	const Metric metrics[] = {
+	    {"tick_p50_ms", p50},
+	    {"tick_p99_ms", p99},
+	    {"tick_p999_ms", p999},
+	    {"peak_rss_bytes", static_cast<double>(endMemory.peakWorkingSet)},
+	};
+	bool isRegressed = false;
+	for (const Metric& metric : metrics) {
+		double baselineValue = ReadBaselineNumber(baseline, metric.key);
+		if (baselineValue <= 0.0) {
+			continue;
+		}
+		double ratio = metric.value / baselineValue;
+		bool isWorse = ratio > 1.0 + config.tolerance;
+		isRegressed = isRegressed || isWorse;
+		LOG_INFO(LogCategory::kGeneral, "Soak: %-16s %12.4f vs baseline %12.4f (%+.1f%%)%s", metric.key, metric.value, baselineValue, (ratio - 1.0) * 100.0,
+		         isWorse ? "  REGRESSED" : "");
+	}
+	return isRegressed ? 1 : exitCode;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 描画せずに実際の SceneManager / GameScene を回し続けるソークテスト（起動引数 -soak）。
+// 死亡・ゴール・関卡切り替えを通常の流れのまま繰り返し、tick 時間のパーセンタイル、ピーク RSS、確保回数を JSON に書き出す。
+//   -soak [分] -level <ID> -input scripted|random -seed <N> -out <パス> -baseline <パス> -tolerance <割合> -threaded
+// -threaded ではシミュレーションスレッドで待たずに回し、メインスレッドが受け取ったスナップショットを検証する。
+namespace Soak {
+	struct Config {
+		float minutes = 5.0f;      // シミュレーション時間（60 tick = 1 秒、実時間ではない）
+		int levelID = 0;
+		bool isRandomInput = false;
+		uint32_t seed = 1;
+		std::string outputPath = "soak_results.json";
+		std::string baselinePath;  // 空なら比較しない
+		float tolerance = 0.2f;    // ベースラインより悪化してよい割合
+		bool isThreaded = false;   // スナップショットの受け渡しを含めて回す
+		uint32_t jobThreadCount = 0;
+	};
+
+	// -soak があれば config を埋めて true を返す
+	bool ParseArguments(const std::vector<std::string>& arguments, Config& config);
+
+	// エンジン初期化後、SceneManager::Init の代わりに呼ぶ。
+	// 終了コードを返す（0: 成功、1: 書き出し失敗かベースラインより悪化）
+	int Run(const Config& config);
+}
@@ -0,0 +1,219 @@
+#include "TimerWheel.h"
+#include "GameClock.h"
+
+TimerWheel::TimerWheel(uint32_t initialCapacity) {
+	for (uint32_t level = 0; level < kLevelCount; ++level) {
+		for (uint32_t slot = 0; slot < kSlotCount; ++slot) {
+			slots_[level][slot] = kNone;
+		}
+	}
+	nodes_.reserve(initialCapacity);
+	expired_.reserve(initialCapacity);
+}
+
+TimerHandle TimerWheel::Schedule(uint32_t delayTicks, Callback callback, void* context) {
+	if (!callback) {
+		return TimerHandle();
+	}
+	if (delayTicks == 0) {
+		delayTicks = 1;
+	}
+	if (delayTicks > kMaxDelayTicks) {
+		delayTicks = kMaxDelayTicks;
+	}
+
+	uint32_t index = AllocateNode();
+	Node& node = nodes_[index];
+	node.expireTick = currentTick_ + delayTicks;
+	node.callback = callback;
+	node.context = context;
+	Insert(index);
+	activeCount_++;
+
+	TimerHandle handle;
+	handle.index = index;
+	handle.generation = node.generation;
+	return handle;
+}
+
+TimerHandle TimerWheel::ScheduleSeconds(float seconds, Callback callback, void* context) {
+	return Schedule(GameClock::SecondsToTicks(seconds), callback, context);
+}
+
+bool TimerWheel::Cancel(TimerHandle& handle) {
+	const Node* resolved = Resolve(handle);
+	handle = TimerHandle();
+	if (!resolved) {
+		return false;
+	}
+
+	uint32_t index = static_cast<uint32_t>(resolved - nodes_.data());
+	if (resolved->state == NodeState::kScheduled) {
+		Unlink(index);
+	}
+	// 発火待ちのバッチに入っている場合は世代が変わるので呼ばれなくなる
+	FreeNode(index);
+	activeCount_--;
+	return true;
+}
+
+bool TimerWheel::IsPending(const TimerHandle& handle) const { return Resolve(handle) != nullptr; }
+
+uint32_t TimerWheel::GetRemainingTicks(const TimerHandle& handle) const {
+	const Node* node = Resolve(handle);
+	if (!node || node->expireTick <= currentTick_) {
+		return 0;
+	}
+	return static_cast<uint32_t>(node->expireTick - currentTick_);
+}
+
+float TimerWheel::GetRemainingSeconds(const TimerHandle& handle) const { return GameClock::TicksToSeconds(GetRemainingTicks(handle)); }
+
+void TimerWheel::Advance() {
+	currentTick_++;
+
+	// 下の段が一周したら上の段のスロットを下ろす
+	for (uint32_t level = 1; level < kLevelCount; ++level) {
+		uint64_t lowerMask = (uint64_t(1) << (kSlotBits * level)) - 1;
+		if ((currentTick_ & lowerMask) != 0) {
+			break;
+		}
+		Cascade(level);
+	}
+
+	// 現在のスロットをまとめて取り出す
+	uint32_t slot = static_cast<uint32_t>(currentTick_ & kSlotMask);
+	int32_t index = slots_[0][slot];
+	slots_[0][slot] = kNone;
+	expired_.clear();
+	while (index != kNone) {
+		Node& node = nodes_[index];
+		int32_t next = node.next;
+		node.prev = kNone;
+		node.next = kNone;
+		node.state = NodeState::kExpired;
+		expired_.push_back({static_cast<uint32_t>(index), node.generation});
+		index = next;
+	}
+	lastExpiredCount_ = static_cast<uint32_t>(expired_.size());
+
+	// コールバック中に Schedule/Cancel されても安全なように、世代を確認してから呼ぶ
+	for (size_t i = 0; i < expired_.size(); ++i) {
+		ExpiredEntry entry = expired_[i];
+		Node& node = nodes_[entry.index];
+		if (node.generation != entry.generation || node.state != NodeState::kExpired) {
+			continue;
+		}
+		Callback callback = node.callback;
+		void* context = node.context;
+		FreeNode(entry.index);
+		activeCount_--;
+		callback(context);
+	}
+}
+
+void TimerWheel::Clear() {
+	for (uint32_t level = 0; level < kLevelCount; ++level) {
+		for (uint32_t slot = 0; slot < kSlotCount; ++slot) {
+			slots_[level][slot] = kNone;
+		}
+	}
+	freeHead_ = kNone;
+	for (uint32_t i = static_cast<uint32_t>(nodes_.size()); i > 0; --i) {
+		if (nodes_[i - 1].state != NodeState::kFree) {
+			nodes_[i - 1].generation++;
+		}
+		nodes_[i - 1].state = NodeState::kFree;
+		nodes_[i - 1].next = freeHead_;
+		freeHead_ = static_cast<int32_t>(i - 1);
+	}
+	expired_.clear();
+	activeCount_ = 0;
+}
+
+uint32_t TimerWheel::AllocateNode() {
+	uint32_t index;
+	if (freeHead_ != kNone) {
+		index = static_cast<uint32_t>(freeHead_);
+		freeHead_ = nodes_[index].next;
+	} else {
+		// プールが足りない時だけ増やす
+		index = static_cast<uint32_t>(nodes_.size());
+		nodes_.emplace_back();
+	}
+	Node& node = nodes_[index];
+	node.prev = kNone;
+	node.next = kNone;
+	node.state = NodeState::kScheduled;
+	return index;
+}
+
+void TimerWheel::FreeNode(uint32_t index) {
+	Node& node = nodes_[index];
+	node.generation++;
+	node.state = NodeState::kFree;
+	node.callback = nullptr;
+	node.context = nullptr;
+	node.prev = kNone;
+	node.next = freeHead_;
+	freeHead_ = static_cast<int32_t>(index);
+}
+
+void TimerWheel::Insert(uint32_t index) {
+	Node& node = nodes_[index];
+	uint64_t delay = node.expireTick > currentTick_ ? node.expireTick - currentTick_ : 0;
+
+	// 残り時間で段を決める
+	uint32_t level = 0;
+	while (level + 1 < kLevelCount && delay >= (uint64_t(1) << (kSlotBits * (level + 1)))) {
+		level++;
+	}
+	uint64_t expireTick = delay == 0 ? currentTick_ : node.expireTick;
+	uint32_t slot = static_cast<uint32_t>((expireTick >> (kSlotBits * level)) & kSlotMask);
+
+	node.level = static_cast<uint8_t>(level);
+	node.slot = static_cast<uint8_t>(slot);
+	node.state = NodeState::kScheduled;
+	node.prev = kNone;
+	node.next = slots_[level][slot];
+	if (node.next != kNone) {
+		nodes_[node.next].prev = static_cast<int32_t>(index);
+	}
+	slots_[level][slot] = static_cast<int32_t>(index);
+}
+
+void TimerWheel::Unlink(uint32_t index) {
+	Node& node = nodes_[index];
+	if (node.prev != kNone) {
+		nodes_[node.prev].next = node.next;
+	} else {
+		slots_[node.level][node.slot] = node.next;
+	}
+	if (node.next != kNone) {
+		nodes_[node.next].prev = node.prev;
+	}
+	node.prev = kNone;
+	node.next = kNone;
+}
+
+void TimerWheel::Cascade(uint32_t level) {
+	uint32_t slot = static_cast<uint32_t>((currentTick_ >> (kSlotBits * level)) & kSlotMask);
+	int32_t index = slots_[level][slot];
+	slots_[level][slot] = kNone;
+	while (index != kNone) {
+		int32_t next = nodes_[index].next;
+		Insert(static_cast<uint32_t>(index));
+		index = next;
+	}
+}
+
+const TimerWheel::Node* TimerWheel::Resolve(const TimerHandle& handle) const {
+	if (!handle.IsValid() || handle.index >= nodes_.size()) {
+		return nullptr;
+	}
+	const Node& node = nodes_[handle.index];
+	if (node.generation != handle.generation || node.state == NodeState::kFree) {
+		return nullptr;
+	}
+	return &node;
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// タイマーのハンドル。キャンセルや残り時間の取得に使う。
+struct TimerHandle {
+	static constexpr uint32_t kInvalidIndex = 0xFFFFFFFFu;
+	uint32_t index = kInvalidIndex;
+	uint32_t generation = 0;
+
+	bool IsValid() const { return index != kInvalidIndex; }
+};
+
+// 階層タイマーホイール（64 スロット x 4 段、tick 単位）。
+// 登録・キャンセルは O(1)、期限切れは tick ごとにまとめてコールバックする。
+// コールバックは関数ポインタ + コンテキストなので、登録時にヒープ確保しない。
+class TimerWheel {
+public:
+	using Callback = void (*)(void* context);
+
+	explicit TimerWheel(uint32_t initialCapacity = 256);
+	~TimerWheel() = default;
+
+	// delayTicks 後に callback(context) を呼ぶ（0 は次の tick 扱い）
+	TimerHandle Schedule(uint32_t delayTicks, Callback callback, void* context);
+	TimerHandle ScheduleSeconds(float seconds, Callback callback, void* context);
+
+	// 期限前のタイマーを取り消す。既に発火済み/無効なハンドルは false
+	bool Cancel(TimerHandle& handle);
+	bool IsPending(const TimerHandle& handle) const;
+
+	// 残り tick 数（無効なハンドルは 0）
+	uint32_t GetRemainingTicks(const TimerHandle& handle) const;
+	float GetRemainingSeconds(const TimerHandle& handle) const;
+
+	// 1 tick 進めて、期限が来たタイマーをまとめて呼ぶ
+	void Advance();
+
+	uint64_t GetCurrentTick() const { return currentTick_; }
+	uint32_t GetActiveCount() const { return activeCount_; }
+	uint32_t GetLastExpiredCount() const { return lastExpiredCount_; }
+
+	// 全てのタイマーを破棄する
+	void Clear();
+
+private:
+	static constexpr uint32_t kSlotBits = 6;
+	static constexpr uint32_t kSlotCount = 1u << kSlotBits;
+	static constexpr uint32_t kSlotMask = kSlotCount - 1;
+	static constexpr uint32_t kLevelCount = 4;
+	static constexpr uint32_t kMaxDelayTicks = (1u << (kSlotBits * kLevelCount)) - 1;
+	static constexpr int32_t kNone = -1;
+
+	enum class NodeState : uint8_t {
+		kFree,
+		kScheduled, // スロットのリストに入っている
+		kExpired,   // 発火待ちのバッチに入っている
+	};
+
+	struct Node {
+		uint64_t expireTick = 0;
+		Callback callback = nullptr;
+		void* context = nullptr;
+		int32_t prev = kNone;
+		int32_t next = kNone;
+		uint32_t generation = 0;
+		NodeState state = NodeState::kFree;
+		uint8_t level = 0;
+		uint8_t slot = 0;
+	};
+
+	struct ExpiredEntry {
+		uint32_t index;
+		uint32_t generation;
+	};
+
+	uint32_t AllocateNode();
+	void FreeNode(uint32_t index);
+	void Insert(uint32_t index);
+	void Unlink(uint32_t index);
+	void Cascade(uint32_t level);
+	const Node* Resolve(const TimerHandle& handle) const;
+
+	std::vector<Node> nodes_;
+	int32_t freeHead_ = kNone;
+	int32_t slots_[kLevelCount][kSlotCount];
+	std::vector<ExpiredEntry> expired_;
+
+	uint64_t currentTick_ = 0;
+	uint32_t activeCount_ = 0;
+	uint32_t lastExpiredCount_ = 0;
+};
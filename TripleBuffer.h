@@ -0,0 +1,61 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// 書き込み 1 スレッド・読み出し 1 スレッドのトリプルバッファ（ロックフリー、どちらも待たない）。
+// 書き込み側は自分のバッファに書いて Publish、読み出し側は Acquire で最新のバッファと入れ替える。
+// 読み出し側が追いつかなければ古いものは上書きされ、常に最新のものだけが渡る。
+//   書き込み: Fill(buffer.GetWriteBuffer()); buffer.Publish();
+//   読み出し: if (buffer.Acquire()) { Use(buffer.GetReadBuffer()); }
+template <typename T>
+class TripleBuffer {
+public:
+	TripleBuffer() = default;
+	TripleBuffer(const TripleBuffer&) = delete;
+	TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+	// --- 書き込み側 ---
+	T& GetWriteBuffer() { return slots_[writeIndex_]; }
+
+	void Publish() {
+		uint8_t previous = shared_.exchange(static_cast<uint8_t>(writeIndex_ | kFreshBit), std::memory_order_acq_rel);
+		writeIndex_ = previous & kIndexMask;
+		publishedCount_.fetch_add(1, std::memory_order_relaxed);
+		if (previous & kFreshBit) {
+			// 読まれる前に次を出した
+			overwrittenCount_.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	// --- 読み出し側 ---
+	// 新しいバッファがあれば受け取って true。無ければ前回のまま false
+	bool Acquire() {
+		if ((shared_.load(std::memory_order_relaxed) & kFreshBit) == 0) {
+			return false;
+		}
+		uint8_t previous = shared_.exchange(readIndex_, std::memory_order_acq_rel);
+		readIndex_ = previous & kIndexMask;
+		return true;
+	}
+
+	const T& GetReadBuffer() const { return slots_[readIndex_]; }
+
+	// スレッドを動かす前の初期化用（容量の確保など）
+	T& GetSlot(uint32_t index) { return slots_[index]; }
+
+	uint64_t GetPublishedCount() const { return publishedCount_.load(std::memory_order_relaxed); }
+	// 読まれずに上書きされた回数
+	uint64_t GetOverwrittenCount() const { return overwrittenCount_.load(std::memory_order_relaxed); }
+
+private:
+	static constexpr uint8_t kIndexMask = 0x3;
+	static constexpr uint8_t kFreshBit = 0x4;
+
+	T slots_[3];
+	uint8_t writeIndex_ = 0; // 書き込み側のみ
+	uint8_t readIndex_ = 1;  // 読み出し側のみ
+	// 受け渡し中のバッファの番号 + 未読フラグ
+	std::atomic<uint8_t> shared_{2};
+	std::atomic<uint64_t> publishedCount_{0};
+	std::atomic<uint64_t> overwrittenCount_{0};
+};
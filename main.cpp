@@ -1,29 +1,180 @@
 #include <Windows.h>
 #include "KamataEngine.h"
 #include "SceneManager.h"
+#include "AssetManager.h"
+#include "LevelRegistry.h"
+#include "Profiler.h"
+#include "Benchmark.h"
+#include "AllocTracker.h"
+#include "Soak.h"
+#include "Logger.h"
+#include "JobSystem.h"
+#include "SimulationThread.h"
+#include "RenderSnapshot.h"
+#include "LatencyTracker.h"
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
 
 using namespace KamataEngine;
+
+namespace {
+	// Windows アプリにはコンソールがないので、起動元のコンソールがあれば標準出力をそこにつなぐ。
+	// 標準出力がリダイレクトされているときはそのまま使う
+	void AttachParentConsole() {
+		if (_fileno(stdout) >= 0 || !AttachConsole(ATTACH_PARENT_PROCESS)) {
+			return;
+		}
+		FILE* stream = nullptr;
+		freopen_s(&stream, "CONOUT$", "w", stdout);
+		freopen_s(&stream, "CONOUT$", "w", stderr);
+	}
+}
+
 // Windowsアプリでのエントリーポイント(main関数)
-int WINAPI WinMain(_In_ HINSTANCE, _In_opt_ HINSTANCE, _In_ LPSTR, _In_ int) {
+int WINAPI WinMain(_In_ HINSTANCE, _In_opt_ HINSTANCE, _In_ LPSTR lpCmdLine, _In_ int) {
+	std::istringstream commandLine(lpCmdLine ? lpCmdLine : "");
+	std::vector<std::string> arguments;
+	std::string argument;
+	while (commandLine >> argument) {
+		arguments.push_back(argument);
+	}
+
+	// 結果をログ（標準出力）で報告するモードでは、ログの出力スレッドより先にコンソールにつなぐ
+	for (const std::string& modeArgument : arguments) {
+		if (modeArgument == "-bench" || modeArgument == "-soak" || modeArgument == "-alloc-check") {
+			AttachParentConsole();
+			break;
+		}
+	}
+	// ログの出力スレッドを起動する
+	Logger::GetInstance();
+
+	uint32_t threadCount = 0;
+	bool isThreaded = false;
+	std::string latencyOutputPath;
+	for (size_t i = 0; i < arguments.size(); ++i) {
+		// -bench [出力パス]：レンダラーを初期化せずにベンチマークだけ実行して終了する
+		if (arguments[i] == "-bench") {
+			std::string outputPath = i + 1 < arguments.size() ? arguments[i + 1] : "bench_results.json";
+			bool isSucceeded = Benchmark::RunAll(outputPath);
+			JobSystem::Destroy();
+			Logger::Destroy();
+			return isSucceeded ? 0 : 1;
+		}
+#ifdef USE_ALLOC_TRACKER
+		// -alloc-check：定常状態のゲームプレイ tick でヒープ確保があれば終了コード 1 で終わる
+		if (arguments[i] == "-alloc-check") {
+			AllocTracker::SetSteadyStateCheck(true);
+		}
+#endif
+		// -threads <数>：ジョブシステムのスレッド数（メインスレッドを含む。省略時はハードウェアスレッド数）
+		if (arguments[i] == "-threads" && i + 1 < arguments.size()) {
+			threadCount = static_cast<uint32_t>(std::strtoul(arguments[i + 1].c_str(), nullptr, 10));
+		}
+		// -threaded：シミュレーションを専用スレッドで回し、メインスレッドはスナップショットを描くだけにする
+		if (arguments[i] == "-threaded") {
+			isThreaded = true;
+		}
+		// -latency-out <パス>：終了時に入力 → Present の遅れのヒストグラムを CSV に書き出す
+		if (arguments[i] == "-latency-out" && i + 1 < arguments.size()) {
+			latencyOutputPath = arguments[i + 1];
+		}
+	}
+	Soak::Config soakConfig;
+	const bool isSoak = Soak::ParseArguments(arguments, soakConfig);
+	soakConfig.jobThreadCount = threadCount;
+	isThreaded = isThreaded && !isSoak;
+	if (!isThreaded && !soakConfig.isThreaded) {
+		// スレッド分離モードではシミュレーションスレッドがジョブシステムを作る
+		JobSystem::Initialize(threadCount);
+	}
 	
 	KamataEngine::Initialize(L"GC2A_04_コウ_ホウケイ_消さないで");
 	DirectXCommon* dxCommon_ = DirectXCommon::GetInstance();
 	ImGuiManager* imguiManager = ImGuiManager::GetInstance();
 
+	int exitCode = 0;
 	// シーンマネージャーの初期化
 	SceneManager& sceneManager = SceneManager::GetInstance();
-	sceneManager.Init();
+	SimulationThread simulation;
+	std::unique_ptr<SnapshotRenderer> snapshotRenderer;
+	KeyboardInputSource keyboardInput;
+	// 入力 → シミュレーション → 公開 → Present の時刻をフレームごとに集める
+	LatencyTracker latencyTracker;
+	DirectXFramePresenter presenter;
+	if (!latencyOutputPath.empty()) {
+		latencyTracker.SetCsvPath(latencyOutputPath);
+	}
+	if (isSoak) {
+		// -soak：描画せずにシミュレーションだけを回し、統計を書き出して終了する（通常のループは通らない）
+		exitCode = Soak::Run(soakConfig);
+	} else if (isThreaded) {
+		// シーンの ImGui とデバッグキーはシミュレーションスレッドでは使えないので切る
+		sceneManager.SetPlayerInputSource(&simulation.GetInputSource());
+		sceneManager.SetDebugUIEnabled(false);
+		sceneManager.SetFixedTimestep(true);
+		sceneManager.Init();
+		snapshotRenderer = std::make_unique<SnapshotRenderer>();
+		snapshotRenderer->Initialize();
+		simulation.Start(threadCount, true, [] {
+			SceneManager::GetInstance().Update();
+			return true;
+		});
+	} else {
+		sceneManager.Init();
+	}
 
 
-	while (true) {
+	while (!isSoak) {
+#ifdef USE_PROFILER
+		Profiler::GetInstance().BeginFrame();
+#endif
+#ifdef USE_ALLOC_TRACKER
+		AllocTracker::BeginFrame();
+#endif
 		if (KamataEngine::Update()) {
 			break;
 		}
+		// キーボードはここで読み終わっている
+		LatencySample latencySample;
+		latencySample.inputTimestamp = SimulationThread::GetTimestamp();
+		// 新しい状態を描くフレームだけ数える（スレッド分離モードで同じスナップショットを描き直すフレームは除く）
+		bool isLatencyFrame = true;
 
 		// ImGui受付開始
 		imguiManager->Begin();
 
-		sceneManager.Update();
+		if (isThreaded) {
+			// 入力はここで読んでシミュレーションスレッドに渡す
+			simulation.GetInputSource().Latch(keyboardInput.Poll(), latencySample.inputTimestamp);
+			isLatencyFrame = simulation.AcquireSnapshot();
+			if (isLatencyFrame) {
+				const RenderSnapshot& snapshot = simulation.GetSnapshot();
+				latencySample.inputTimestamp = snapshot.inputTimestamp;
+				latencySample.consumeTimestamp = snapshot.consumeTimestamp;
+				latencySample.publishTimestamp = snapshot.publishTimestamp;
+			}
+			simulation.DrawImGui();
+		} else {
+			latencySample.consumeTimestamp = SimulationThread::GetTimestamp();
+			sceneManager.Update();
+			latencySample.publishTimestamp = SimulationThread::GetTimestamp();
+		}
+		latencyTracker.DrawImGui();
+
+#ifdef USE_PROFILER
+		Profiler::GetInstance().DrawImGui();
+#endif
+#ifdef USE_ALLOC_TRACKER
+		AllocTracker::DrawImGui();
+#endif
+#ifdef USE_IMGUI
+		Logger::GetInstance().DrawImGui();
+#endif
 
 		// ImGui受付終了
 		imguiManager->End();
@@ -31,7 +182,11 @@ int WINAPI WinMain(_In_ HINSTANCE, _In_opt_ HINSTANCE, _In_ LPSTR, _In_ int) {
 		// 描画開始
 		dxCommon_->PreDraw();
 		// シーンマネージャーの描画
-		sceneManager.Draw();
+		if (isThreaded) {
+			snapshotRenderer->Draw(simulation.GetSnapshot());
+		} else {
+			sceneManager.Draw();
+		}
 		
 		//  AxisIndicatorの描画
 		AxisIndicator::GetInstance()->Draw();
@@ -40,12 +195,46 @@ int WINAPI WinMain(_In_ HINSTANCE, _In_opt_ HINSTANCE, _In_ LPSTR, _In_ int) {
 		imguiManager->Draw();
 
 		// 描画終了
-		dxCommon_->PostDraw();
+		{
+			PROFILE_SCOPE("DirectXCommon::PostDraw");
+			latencySample.presentTimestamp = presenter.Present();
+		}
+		if (isLatencyFrame) {
+			latencyTracker.Record(latencySample);
+		}
+
+#ifdef USE_PROFILER
+		Profiler::GetInstance().EndFrame();
+#endif
+#ifdef USE_ALLOC_TRACKER
+		AllocTracker::EndFrame();
+		if (AllocTracker::HasSteadyStateFailure()) {
+			exitCode = 1;
+			break;
+		}
+#endif
+	}
+
+	if (!latencyOutputPath.empty() && !latencyTracker.WriteCsv(latencyOutputPath)) {
+		LOG_ERROR(LogCategory::kGeneral, "Failed to write %s", latencyOutputPath.c_str());
 	}
 
+	// シミュレーションスレッドを止めてからシーンを解放する
+	simulation.Stop();
+	snapshotRenderer.reset();
 	// シーンマネージャーの終了処理 - 智能指针会自动清理
 	SceneManager::Destroy();
+	// シーンの解放後にワーカースレッドを止める
+	JobSystem::Destroy();
+	// 共享资源缓存（模型）の解放
+	AssetManager::Destroy();
+	LevelRegistry::Destroy();
+#ifdef USE_PROFILER
+	Profiler::Destroy();
+#endif
 
 	KamataEngine::Finalize();
-	return 0;
+	// 残っているログを出力してから終了する
+	Logger::Destroy();
+	return exitCode;
 }
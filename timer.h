@@ -1,6 +1,6 @@
 #pragma once
 
-#include<functional>
+#include"Delegate.h"
 class Timer
 {
 public:
@@ -22,9 +22,9 @@ public:
 		one_shot = value;
 	}
 
-	void set_on_timeout(std::function<void()> _on_timeout)
+	void set_on_timeout(Delegate<void()> _on_timeout)
 	{
-		this->on_timeout = _on_timeout;
+		this->on_timeout = std::move(_on_timeout);
 	}
 
 	void pause()
@@ -74,5 +74,5 @@ private:
 	bool paused = false;
 	bool shotted = false;
 	bool one_shot = false;
-	std::function<void()> on_timeout;
+	Delegate<void()> on_timeout;
 };